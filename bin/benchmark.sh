@@ -0,0 +1,48 @@
+#!/usr/bin/env bash
+set -e
+declare -r ROOT_DIR=${TIPDIR:-$(git rev-parse --show-toplevel)}
+declare -r TIPC=${ROOT_DIR}/build/src/tipc
+declare -r RTLIB=${ROOT_DIR}/rtlib
+declare -r BENCHMARK_DIR=${ROOT_DIR}/test/system/benchmarks
+declare -r SCRATCH_DIR=$(mktemp -d)
+
+if [ -z "${TIPCLANG}" ]; then
+  echo error: TIPCLANG env var must be set
+  exit 1
+fi
+
+if [ ! -f "${TIPC}" ]; then
+  echo error: tipc was not found
+  exit 1
+fi
+
+if [ ! -f "${RTLIB}/tip_rtlib.bc" ]; then
+  echo error: tip_rtlib.bc was not found
+  exit 1
+fi
+
+for i in ${BENCHMARK_DIR}/*.tip
+do
+  base="$(basename $i .tip)"
+  cp $i ${SCRATCH_DIR}
+
+  ${TIPC} $@ ${SCRATCH_DIR}/${base}.tip
+  ${TIPCLANG} -w ${SCRATCH_DIR}/${base}.tip.bc ${RTLIB}/tip_rtlib.bc -o ${SCRATCH_DIR}/${base}
+
+  # A benchmark that reads input has a script next to it that generates it
+  input=/dev/null
+  if [ -x ${BENCHMARK_DIR}/${base}.sh ]; then
+    input=${SCRATCH_DIR}/${base}.input
+    ${BENCHMARK_DIR}/${base}.sh > ${input}
+  fi
+
+  # GNU time also reports the peak resident set size
+  if /usr/bin/time -f "" true &>/dev/null; then
+    /usr/bin/time -f "${base} %es %MKiB" ${SCRATCH_DIR}/${base} < ${input} > /dev/null
+  else
+    TIMEFORMAT="${base} %Rs"
+    time ${SCRATCH_DIR}/${base} < ${input} > /dev/null
+  fi
+done
+
+rm -rf ${SCRATCH_DIR}
@@ -20,6 +20,7 @@ run_unit_tests() {
   ${UNIT_TEST_DIR}/frontend/frontend_unit_tests
   ${UNIT_TEST_DIR}/semantic/semantic_unit_tests
   ${UNIT_TEST_DIR}/semantic/types/typeinference_unit_tests
+  ${UNIT_TEST_DIR}/codegen/codegen_unit_tests
   echo unit test run complete
 }
 
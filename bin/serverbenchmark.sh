@@ -0,0 +1,44 @@
+#!/usr/bin/env bash
+set -e
+declare -r ROOT_DIR=${TIPDIR:-$(git rev-parse --show-toplevel)}
+declare -r TIPC=${ROOT_DIR}/build/src/tipc
+declare -r TIPC_CONNECT=${ROOT_DIR}/build/src/tipc-connect
+declare -r PROGRAM_DIR=${ROOT_DIR}/test/system/selftests
+declare -r ROUNDS=${ROUNDS:-5}
+declare -r SCRATCH_DIR=$(mktemp -d)
+declare -r SOCKET=${SCRATCH_DIR}/tipc.sock
+
+if [ ! -f "${TIPC}" ] || [ ! -f "${TIPC_CONNECT}" ]; then
+  echo error: tipc or tipc-connect was not found
+  exit 1
+fi
+
+cp ${PROGRAM_DIR}/*.tip ${SCRATCH_DIR}
+
+# Compiles every program ROUNDS times with the given command and reports the time taken
+measure() {
+  local name=$1
+  shift
+  local count=0
+  local start=$(date +%s%N)
+  for round in $(seq ${ROUNDS}); do
+    for i in ${SCRATCH_DIR}/*.tip; do
+      "$@" ${i}
+      ((count++)) || true
+    done
+  done
+  local elapsed=$(( ($(date +%s%N) - start) / 1000000 ))
+  echo "${name}: ${count} compilations in ${elapsed}ms, $(( elapsed / count ))ms each"
+}
+
+measure "tipc" ${TIPC} "$@"
+
+${TIPC} --server=${SOCKET} &>/dev/null &
+server_pid=$!
+trap "kill ${server_pid} 2>/dev/null; rm -rf ${SCRATCH_DIR}" EXIT
+for wait in $(seq 50); do
+  [ -S ${SOCKET} ] && break
+  sleep 0.1
+done
+
+measure "tipc-connect" ${TIPC_CONNECT} ${SOCKET} "$@"
@@ -0,0 +1,24 @@
+# Writes the contents of a binary file as a C++ byte array so that it can be
+# compiled into a program.  Run it as a script:
+#
+#   cmake -DINPUT=<file> -DOUTPUT=<source> -DNAME=<symbol> -P EmbedFile.cmake
+#
+# The source defines the array <symbol> and its size <symbol>Size.
+
+file(READ ${INPUT} hex HEX)
+string(LENGTH "${hex}" length)
+math(EXPR size "${length} / 2")
+
+# Sixteen bytes per line, CMake regular expressions have no counted repeats
+set(line "")
+foreach(i RANGE 15)
+  string(APPEND line "[0-9a-f][0-9a-f]")
+endforeach()
+string(REGEX REPLACE "(${line})" "\\1\n" hex "${hex}")
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${hex}")
+
+file(WRITE ${OUTPUT}
+  "// Generated from ${INPUT} by EmbedFile.cmake, do not edit.\n"
+  "#include <cstddef>\n\n"
+  "extern const unsigned char ${NAME}[] = {\n${bytes}\n};\n"
+  "extern const std::size_t ${NAME}Size = ${size};\n")
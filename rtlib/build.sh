@@ -4,4 +4,4 @@ if [ -z "${TIPCLANG}" ]; then
   exit 1
 fi
 
-${TIPCLANG} -c -emit-llvm tip_rtlib.c
+${TIPCLANG} $@ -c -emit-llvm tip_rtlib.c
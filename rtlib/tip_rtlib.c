@@ -2,14 +2,571 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <inttypes.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 /*
- * These are defined for each TIP program in the compiled code.
+ * These are defined for each TIP program in the compiled code.  Compiling
+ * with -DTIP_RTLIB_NO_MAIN leaves out the main function that uses them, so
+ * that the library can be linked into a host that runs programs itself.
  */
 int64_t _tip_main();
 extern int64_t _tip_num_inputs;
 extern int64_t _tip_input_array[]; 
 
+/*
+ * Program output is collected in a private buffer and written to stdout
+ * with write(2) when the buffer fills, before waiting for input, and when the
+ * program exits, fails or is killed by a signal.  When stdout is a terminal
+ * the buffer is flushed after every line.
+ *
+ * Setting the environment variable TIP_OUTPUT=binary writes each output
+ * value as a raw native-endian int64 instead of a line of text.
+ *
+ * Compiling with -DTIP_STDIO_OUTPUT restores the original printf and scanf
+ * based IO, which is useful for comparing the two.
+ */
+#define TIP_OUTPUT_BUFFER_SIZE (1 << 16)
+
+static char outputBuffer[TIP_OUTPUT_BUFFER_SIZE];
+static size_t outputLength = 0;
+static int outputIsTerminal = 0;
+static int outputIsBinary = 0;
+
+// Only uses write(2), so it is safe to call from a signal handler.
+static void flushOutput(void) {
+  size_t written = 0;
+  while (written < outputLength) {
+    ssize_t n = write(STDOUT_FILENO, outputBuffer + written, outputLength - written);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    written += n;
+  }
+  outputLength = 0;
+}
+
+static void writeOutput(const char *bytes, size_t length) {
+  if (outputLength + length > TIP_OUTPUT_BUFFER_SIZE) {
+    flushOutput();
+  }
+  memcpy(outputBuffer + outputLength, bytes, length);
+  outputLength += length;
+}
+
+static void writeString(const char *s) {
+  writeOutput(s, strlen(s));
+}
+
+static const char digitPairs[] =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+  "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+// Formats x in decimal two digits at a time, returns the number of characters.
+static size_t formatInt64(int64_t x, char *out) {
+  char digits[24];
+  char *p = digits + sizeof(digits);
+  uint64_t u = (x < 0) ? -(uint64_t)x : (uint64_t)x;
+  while (u >= 100) {
+    unsigned pair = (unsigned)(u % 100) * 2;
+    u /= 100;
+    *--p = digitPairs[pair + 1];
+    *--p = digitPairs[pair];
+  }
+  if (u >= 10) {
+    *--p = digitPairs[u * 2 + 1];
+    *--p = digitPairs[u * 2];
+  } else {
+    *--p = (char)('0' + u);
+  }
+  if (x < 0) {
+    *--p = '-';
+  }
+  size_t length = digits + sizeof(digits) - p;
+  memcpy(out, p, length);
+  return length;
+}
+
+// Writes "<prefix><x>\n", or just the raw value in binary mode.
+static void writeValue(const char *prefix, int64_t x) {
+  if (outputIsBinary) {
+    writeOutput((const char *)&x, sizeof(x));
+    return;
+  }
+  char line[64];
+  size_t length = strlen(prefix);
+  memcpy(line, prefix, length);
+  length += formatInt64(x, line + length);
+  line[length++] = '\n';
+  writeOutput(line, length);
+  if (outputIsTerminal) {
+    flushOutput();
+  }
+}
+
+static void flushOnSignal(int sig) {
+  flushOutput();
+  signal(sig, SIG_DFL);
+  raise(sig);
+}
+
+static void initializeOutput(void) {
+#ifdef TIP_STDIO_OUTPUT
+  return;
+#endif
+  outputIsTerminal = isatty(STDOUT_FILENO);
+  const char *mode = getenv("TIP_OUTPUT");
+  outputIsBinary = (mode != NULL && strcmp(mode, "binary") == 0);
+
+  atexit(flushOutput);
+  int signals[] = { SIGHUP, SIGINT, SIGQUIT, SIGTERM, SIGSEGV, SIGBUS, SIGFPE };
+  for (size_t i = 0; i < sizeof(signals) / sizeof(signals[0]); i++) {
+    signal(signals[i], flushOnSignal);
+  }
+}
+
+/*
+ * Input is read from stdin, or from the file named by the environment
+ * variable TIP_INPUT_FILE, in large chunks.  Regular files are mapped into
+ * memory instead.  Values are decimal integers separated by any characters
+ * that cannot start one.  Setting TIP_INPUT=binary reads raw native-endian
+ * int64 values instead.  Reading past the end of the input yields 0.
+ *
+ * Only an interactive terminal is prompted for input.
+ */
+#define TIP_INPUT_BUFFER_SIZE (1 << 16)
+
+static char inputChunk[TIP_INPUT_BUFFER_SIZE];
+static const char *inputNext = NULL;
+static const char *inputEnd = NULL;
+static int inputFd = -1;
+static int inputIsTerminal = 0;
+static int inputIsBinary = 0;
+static int inputIsMapped = 0;
+static int inputAtEnd = 0;
+
+static void initializeInput(void) {
+  const char *file = getenv("TIP_INPUT_FILE");
+  inputFd = STDIN_FILENO;
+  if (file != NULL) {
+    inputFd = open(file, O_RDONLY);
+    if (inputFd < 0) {
+      writeString("Error: cannot open input file ");
+      writeString(file);
+      writeString("\n");
+      exit(-1);
+    }
+  }
+  inputIsTerminal = isatty(inputFd);
+  const char *mode = getenv("TIP_INPUT");
+  inputIsBinary = (mode != NULL && strcmp(mode, "binary") == 0);
+
+  struct stat st;
+  if (fstat(inputFd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    void *mapped = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, inputFd, 0);
+    if (mapped != MAP_FAILED) {
+      inputNext = (const char *)mapped;
+      inputEnd = inputNext + st.st_size;
+      inputIsMapped = 1;
+    }
+  }
+}
+
+// Returns 0 once the input is exhausted.
+static int refillInput(void) {
+  if (inputIsMapped || inputAtEnd) {
+    inputAtEnd = 1;
+    return 0;
+  }
+
+  // Whoever is on the other end may be waiting for our output
+  flushOutput();
+
+  ssize_t n;
+  do {
+    n = read(inputFd, inputChunk, sizeof(inputChunk));
+  } while (n < 0 && errno == EINTR);
+  if (n <= 0) {
+    inputAtEnd = 1;
+    return 0;
+  }
+  inputNext = inputChunk;
+  inputEnd = inputChunk + n;
+  return 1;
+}
+
+// The next byte of input or -1 at the end.
+static inline int peekInput(void) {
+  if (inputNext == inputEnd && !refillInput()) {
+    return -1;
+  }
+  return (unsigned char)*inputNext;
+}
+
+static int64_t readDecimal(void) {
+  int c;
+  int negative = 0;
+  while ((c = peekInput()) != -1) {
+    if (c >= '0' && c <= '9') {
+      break;
+    }
+    negative = (c == '-');
+    inputNext++;
+  }
+
+  uint64_t value = 0;
+  while ((c = peekInput()) >= '0' && c <= '9') {
+    value = value * 10 + (c - '0');
+    inputNext++;
+  }
+  return negative ? -(int64_t)value : (int64_t)value;
+}
+
+static int64_t readBinary(void) {
+  int64_t value = 0;
+  char *bytes = (char *)&value;
+  for (size_t i = 0; i < sizeof(value); i++) {
+    int c = peekInput();
+    if (c == -1) {
+      return 0;
+    }
+    bytes[i] = (char)c;
+    inputNext++;
+  }
+  return value;
+}
+
+/*
+ * Heap cells and records are never freed, so they are carved out of large
+ * zeroed arenas by bumping a pointer.  The compiled code inlines the bump,
+ * using the cursor and limit below, and only calls _tip_heap_refill when
+ * the current arena is exhausted.  TIP programs are single threaded so the
+ * cursor is an ordinary global, which also lets "tipc --run" link it.  Requests larger
+ * than a quarter of an arena get a mapping of their own so that they do not
+ * waste the remainder of the current arena.
+ *
+ * Setting the environment variable TIP_HEAP_HUGEPAGES=1 backs the arenas
+ * with huge pages where the system supports them.
+ */
+#define TIP_HEAP_ARENA_SIZE (1 << 21)
+
+char *_tip_heap_next = NULL;
+char *_tip_heap_end = NULL;
+
+static int heapUseHugePages = -1;
+
+static void *mapArena(size_t size) {
+  if (heapUseHugePages < 0) {
+    const char *mode = getenv("TIP_HEAP_HUGEPAGES");
+    heapUseHugePages = (mode != NULL && strcmp(mode, "1") == 0);
+  }
+
+  void *arena = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  if (heapUseHugePages && size % TIP_HEAP_ARENA_SIZE == 0) {
+    arena = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  }
+#endif
+  if (arena == MAP_FAILED) {
+    arena = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+    if (arena != MAP_FAILED && heapUseHugePages) {
+      madvise(arena, size, MADV_HUGEPAGE);
+    }
+#endif
+  }
+  if (arena == MAP_FAILED) {
+    flushOutput();
+    writeString("Error: out of memory\n");
+    flushOutput();
+    exit(-1);
+  }
+  return arena;
+}
+
+/*
+ * Called by the compiled code when the current arena cannot hold size
+ * bytes.  Returns zeroed memory for the request.
+ */
+char *_tip_heap_refill(int64_t size) {
+  size = (size + 7) & ~(int64_t)7;
+  if (size > TIP_HEAP_ARENA_SIZE / 4) {
+    size_t rounded = ((size_t)size + TIP_HEAP_ARENA_SIZE - 1) & ~(size_t)(TIP_HEAP_ARENA_SIZE - 1);
+    return (char *)mapArena(rounded);
+  }
+
+  char *arena = (char *)mapArena(TIP_HEAP_ARENA_SIZE);
+  _tip_heap_next = arena + size;
+  _tip_heap_end = arena + TIP_HEAP_ARENA_SIZE;
+  return arena;
+}
+
+/*
+ * Programs compiled with "tipc --gc" allocate from a mark-sweep garbage
+ * collected heap instead.  Each compiled function that may hold references
+ * links a frame onto a shadow stack listing the addresses of those locals,
+ * and of temporaries holding intermediate values, so that the collector can
+ * find the roots.  Every object starts with a header word holding its mark
+ * and a mask of the slots that may hold references, as far as the types of
+ * the program tell.  Since a slot may also hold an integer, or the address of
+ * a local, a value is only followed if it points into an allocated object.
+ *
+ * Objects of up to TIP_GC_SMALL_WORDS slots are carved from chunks holding
+ * objects of a single size and are recycled through a free list per size.
+ * Larger objects get a chunk of their own, which is unmapped when they die.
+ * A collection is started when the memory allocated since the last one
+ * exceeds the memory that survived it, or TIP_GC_MIN_THRESHOLD.
+ *
+ * Setting TIP_GC_STATS=1 reports the number of collections and the peak
+ * size of the heap on exit.  TIP programs are single threaded, and so is
+ * the collector.
+ */
+#define TIP_GC_CHUNK_SIZE (1 << 20)
+#define TIP_GC_SMALL_WORDS 64
+#define TIP_GC_MIN_THRESHOLD (8 << 20)
+
+#define TIP_GC_MARKED ((uint64_t)1 << 63)
+#define TIP_GC_ALLOCATED ((uint64_t)1 << 62)
+#define TIP_GC_LATER_SLOTS ((uint64_t)1 << 61)
+#define TIP_GC_SLOTS (((uint64_t)1 << 62) - 1)
+
+struct GCFrame {
+  struct GCFrame *prev;
+  int64_t count;
+  int64_t *roots[];
+};
+
+struct GCFrame *_tip_gc_top = NULL;
+
+typedef struct GCChunk {
+  size_t objectWords;  // including the header
+  uint64_t *first;     // the first object
+  uint64_t *top;       // the end of the objects carved so far
+  uint64_t *end;
+  size_t mappedSize;
+} GCChunk;
+
+// All chunks ordered by address
+static GCChunk **gcChunks = NULL;
+static size_t gcNumChunks = 0;
+static size_t gcChunkCapacity = 0;
+
+static GCChunk *gcCarving[TIP_GC_SMALL_WORDS + 2];
+static uint64_t *gcFreeLists[TIP_GC_SMALL_WORDS + 2];
+
+static uint64_t **gcMarkStack = NULL;
+static size_t gcMarkStackSize = 0;
+static size_t gcMarkStackCapacity = 0;
+
+static size_t gcAllocatedSinceCollection = 0;
+static size_t gcThreshold = TIP_GC_MIN_THRESHOLD;
+static size_t gcHeapSize = 0;
+static size_t gcPeakHeapSize = 0;
+static size_t gcCollections = 0;
+static int gcStarted = 0;
+
+static void *gcGrow(void *array, size_t *capacity, size_t elementSize) {
+  *capacity = (*capacity == 0) ? 256 : 2 * *capacity;
+  array = realloc(array, *capacity * elementSize);
+  if (array == NULL) {
+    flushOutput();
+    writeString("Error: out of memory\n");
+    flushOutput();
+    exit(-1);
+  }
+  return array;
+}
+
+static void reportCollections(void) {
+  char line[160];
+  size_t length = 0;
+  const char *parts[] = { "gc: ", " collections, peak heap ", " KiB\n" };
+  int64_t values[] = { (int64_t)gcCollections, (int64_t)(gcPeakHeapSize >> 10) };
+  for (int i = 0; i < 2; i++) {
+    memcpy(line + length, parts[i], strlen(parts[i]));
+    length += strlen(parts[i]);
+    length += formatInt64(values[i], line + length);
+  }
+  memcpy(line + length, parts[2], strlen(parts[2]));
+  length += strlen(parts[2]);
+  ssize_t ignored = write(STDERR_FILENO, line, length);
+  (void)ignored;
+}
+
+static GCChunk *newChunk(size_t objectWords, size_t size) {
+  GCChunk *chunk = (GCChunk *)mapArena(size);
+  chunk->objectWords = objectWords;
+  chunk->first = (uint64_t *)(chunk + 1);
+  chunk->top = chunk->first;
+  chunk->end = (uint64_t *)((char *)chunk + size);
+  chunk->mappedSize = size;
+
+  if (gcNumChunks == gcChunkCapacity) {
+    gcChunks = gcGrow(gcChunks, &gcChunkCapacity, sizeof(GCChunk *));
+  }
+  size_t i = gcNumChunks++;
+  while (i > 0 && gcChunks[i - 1] > chunk) {
+    gcChunks[i] = gcChunks[i - 1];
+    i--;
+  }
+  gcChunks[i] = chunk;
+
+  if (!gcStarted) {
+    gcStarted = 1;
+    if (getenv("TIP_GC_STATS") != NULL) {
+      atexit(reportCollections);
+    }
+  }
+  gcHeapSize += size;
+  if (gcHeapSize > gcPeakHeapSize) {
+    gcPeakHeapSize = gcHeapSize;
+  }
+  return chunk;
+}
+
+// The chunk with the highest address not above the address, or NULL.
+static GCChunk *findChunk(uint64_t address) {
+  size_t low = 0, high = gcNumChunks;
+  while (low < high) {
+    size_t middle = (low + high) / 2;
+    if ((uint64_t)gcChunks[middle] <= address) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return (low == 0) ? NULL : gcChunks[low - 1];
+}
+
+// The allocated object containing the address, or NULL.
+static uint64_t *findObject(uint64_t address) {
+  GCChunk *chunk = findChunk(address);
+  if (chunk == NULL || address < (uint64_t)chunk->first || address >= (uint64_t)chunk->top) {
+    return NULL;
+  }
+  size_t objectBytes = chunk->objectWords * sizeof(uint64_t);
+  uint64_t *object = chunk->first + (address - (uint64_t)chunk->first) / objectBytes * chunk->objectWords;
+  return (*object & TIP_GC_ALLOCATED) ? object : NULL;
+}
+
+static void markValue(int64_t value) {
+  uint64_t *object = findObject((uint64_t)value);
+  if (object == NULL || (*object & TIP_GC_MARKED)) {
+    return;
+  }
+  *object |= TIP_GC_MARKED;
+  if ((*object & TIP_GC_SLOTS) != 0) {
+    if (gcMarkStackSize == gcMarkStackCapacity) {
+      gcMarkStack = gcGrow(gcMarkStack, &gcMarkStackCapacity, sizeof(uint64_t *));
+    }
+    gcMarkStack[gcMarkStackSize++] = object;
+  }
+}
+
+static void collect(void) {
+  gcCollections++;
+
+  for (struct GCFrame *frame = _tip_gc_top; frame != NULL; frame = frame->prev) {
+    for (int64_t i = 0; i < frame->count; i++) {
+      markValue(*frame->roots[i]);
+    }
+  }
+
+  while (gcMarkStackSize > 0) {
+    uint64_t *object = gcMarkStack[--gcMarkStackSize];
+    uint64_t references = *object;
+    size_t slots = findChunk((uint64_t)object)->objectWords - 1;
+    for (size_t i = 0; i < slots; i++) {
+      uint64_t bit = (i < 61) ? ((uint64_t)1 << i) : TIP_GC_LATER_SLOTS;
+      if (references & bit) {
+        markValue((int64_t)object[i + 1]);
+      }
+    }
+  }
+
+  // Sweep in reverse so that the free lists hand out objects in address order
+  size_t live = 0;
+  memset(gcFreeLists, 0, sizeof(gcFreeLists));
+  for (size_t c = gcNumChunks; c-- > 0;) {
+    GCChunk *chunk = gcChunks[c];
+    size_t words = chunk->objectWords;
+    if (words - 1 > TIP_GC_SMALL_WORDS) {
+      if (*chunk->first & TIP_GC_MARKED) {
+        *chunk->first &= ~TIP_GC_MARKED;
+        live += words * sizeof(uint64_t);
+      } else {
+        gcHeapSize -= chunk->mappedSize;
+        memmove(gcChunks + c, gcChunks + c + 1, (gcNumChunks - c - 1) * sizeof(GCChunk *));
+        gcNumChunks--;
+        munmap(chunk, chunk->mappedSize);
+      }
+      continue;
+    }
+
+    for (uint64_t *object = chunk->top - words; object >= chunk->first; object -= words) {
+      if (*object & TIP_GC_MARKED) {
+        *object &= ~TIP_GC_MARKED;
+        live += words * sizeof(uint64_t);
+      } else {
+        *object = 0;
+        object[1] = (uint64_t)gcFreeLists[words];
+        gcFreeLists[words] = object;
+      }
+    }
+  }
+
+  gcAllocatedSinceCollection = 0;
+  gcThreshold = (live > TIP_GC_MIN_THRESHOLD) ? live : TIP_GC_MIN_THRESHOLD;
+}
+
+/*
+ * Called by the compiled code for every heap allocation.  Returns zeroed
+ * memory for size bytes whose slots in the references mask, bit i for slot
+ * i and bit 61 for every later slot, are scanned by the collector.
+ */
+char *_tip_gc_alloc(int64_t size, int64_t references) {
+  size_t slots = ((size_t)size + 7) / 8;
+  size_t words = slots + 1;
+  if (gcAllocatedSinceCollection >= gcThreshold) {
+    collect();
+  }
+  gcAllocatedSinceCollection += words * sizeof(uint64_t);
+
+  uint64_t *object;
+  if (slots > TIP_GC_SMALL_WORDS) {
+    size_t bytes = sizeof(GCChunk) + words * sizeof(uint64_t);
+    size_t rounded = (bytes + TIP_GC_CHUNK_SIZE - 1) & ~(size_t)(TIP_GC_CHUNK_SIZE - 1);
+    GCChunk *chunk = newChunk(words, rounded);
+    object = chunk->first;
+    chunk->top = object + words;
+  } else if (gcFreeLists[words] != NULL) {
+    object = gcFreeLists[words];
+    gcFreeLists[words] = (uint64_t *)object[1];
+    memset(object + 1, 0, slots * sizeof(uint64_t));
+  } else {
+    GCChunk *chunk = gcCarving[words];
+    if (chunk == NULL || chunk->top + words > chunk->end) {
+      chunk = gcCarving[words] = newChunk(words, TIP_GC_CHUNK_SIZE);
+    }
+    // Fresh chunks are zeroed
+    object = chunk->top;
+    chunk->top += words;
+  }
+
+  *object = TIP_GC_ALLOCATED | ((uint64_t)references & TIP_GC_SLOTS);
+  return (char *)(object + 1);
+}
+
 /* 
  * runtime library functions for TIP IO expressions and statements
  *    x = input;
@@ -17,18 +574,41 @@ extern int64_t _tip_input_array[];
  *    error y;
  */
 int64_t _tip_input() {
+#ifdef TIP_STDIO_OUTPUT
   int64_t x;
   printf("Enter input: ");
   scanf("%" SCNd64, &x);
   return x;
+#else
+  if (inputFd < 0) {
+    initializeInput();
+  }
+  if (inputIsTerminal) {
+    writeString("Enter input: ");
+    flushOutput();
+  }
+  return inputIsBinary ? readBinary() : readDecimal();
+#endif
 }
 
 void _tip_output(int64_t x) {
+#ifdef TIP_STDIO_OUTPUT
   printf("Program output: %" PRId64 "\n", x); 
+#else
+  writeValue("Program output: ", x);
+#endif
 }  
 
 void _tip_error(int64_t x) {
+#ifdef TIP_STDIO_OUTPUT
   printf("[error] Error: Execution error, code: %" PRId64 "\n", x); 
+#else
+  // Errors are always reported as text
+  int binary = outputIsBinary;
+  outputIsBinary = 0;
+  writeValue("[error] Error: Execution error, code: ", x);
+  outputIsBinary = binary;
+#endif
   exit(-1);
 }
 
@@ -37,7 +617,11 @@ void _tip_error(int64_t x) {
  * that calls this function.
  */
 void _tip_main_undefined() {
+#ifdef TIP_STDIO_OUTPUT
   printf("Error: missing main function\n"); 
+#else
+  writeString("Error: missing main function\n");
+#endif
   exit(-1);
 }
 
@@ -49,23 +633,36 @@ void _tip_main_undefined() {
  * Finally, the TIP "main" is renamed during compilation to "_tip_main",
  * its arguments are removed, and code to read them from "_tip_input_array"
  * is generated.
+ *
+ * The program is passed in explicitly so that "tipc --run", which links
+ * this library into the compiler and the program into memory, can run it
+ * the same way as the main function below.
  */
-int main(int argc, char *argv[]) {
+int _tip_run(int64_t (*tipMain)(), int64_t numInputs, int64_t *inputArray,
+             int argc, char *argv[]) {
+  initializeOutput();
+
   // Throw an error if the wrong number of arguments are passed
-  if (argc != _tip_num_inputs + 1) {
-     printf("expected %lld integer arguments\n", _tip_num_inputs);
+  if (argc != numInputs + 1) {
+     printf("expected %lld integer arguments\n", (long long)numInputs);
      exit(-1);
   }
 
   // required by strtoll, but discarded
   char *eptr;
 
-  for (size_t i=0; i < _tip_num_inputs; i++) {
-    _tip_input_array[i] = strtoll(argv[i+1], &eptr, 10);
+  for (size_t i=0; i < numInputs; i++) {
+    inputArray[i] = strtoll(argv[i+1], &eptr, 10);
   }
   
-  printf("Program output: %" PRId64 "\n", _tip_main());
+  _tip_output(tipMain());
+  flushOutput();
 
   return 0;
 }
 
+#ifndef TIP_RTLIB_NO_MAIN
+int main(int argc, char *argv[]) {
+  return _tip_run(_tip_main, _tip_num_inputs, _tip_input_array, argc, argv);
+}
+#endif
@@ -0,0 +1,176 @@
+#include "CodeGenCache.h"
+#include "ASTVisitor.h"
+#include "InternalError.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+#include "loguru.hpp"
+#include <sstream>
+
+using namespace llvm;
+
+namespace { // Anonymous namespace for local helpers
+
+/*
+ * Identifies the code generated by this version of tipc.  Change it when
+ * code generation changes so that stale entries are no longer used.
+ */
+const char *const CACHE_FORMAT = "tipc-codegen-1";
+
+/*
+ * Collects the facts a function's code depends on that its source does not
+ * show: the layouts chosen for its records and the functions it refers to,
+ * found through the bindings of the symbol table.
+ */
+class DependenceVisitor : public ASTVisitor {
+  ASTProgram *program;
+  RecordLayouts *layouts;
+  std::ostream &out;
+
+public:
+  std::vector<ASTFunction*> callees;
+
+  DependenceVisitor(ASTProgram *program, RecordLayouts *layouts, std::ostream &out)
+      : program(program), layouts(layouts), out(out) {}
+
+  void endVisit(ASTRecordExpr *element) override {
+    out << " record:" << layouts->getLayout(element);
+  }
+
+  void endVisit(ASTAccessExpr *element) override {
+    out << " access:" << layouts->getLayout(element);
+  }
+
+  void endVisit(ASTVariableExpr *element) override {
+    if (element->isFunction()) {
+      callees.push_back(program->getFunctions()[element->getSlot()]);
+    }
+  }
+};
+
+}
+
+CodeGenCache::CodeGenCache(std::string directory, std::string flags)
+    : directory(std::move(directory)), flags(std::move(flags)) {
+  if (auto ec = sys::fs::create_directories(this->directory)) {
+    throw InternalError("cannot create cache directory " + this->directory + ": " + ec.message());
+  }
+}
+
+/*
+ * The facts shared by all partitions are hashed once and each partition
+ * continues from a copy of that state.
+ */
+std::vector<std::string> CodeGenCache::keys(ASTProgram* program, SemanticAnalysis* analysis,
+                                            const std::vector<std::vector<ASTFunction*>> &partitions,
+                                            bool gc) {
+  std::stringstream text;
+  text << CACHE_FORMAT << "\n" << flags << "\ngc:" << gc << "\n";
+
+  // The dispatch table and the declarations of every partition
+  for (auto fn : program->getFunctions()) {
+    text << fn->getName() << "/" << fn->getFormals().size() << " ";
+  }
+  text << "\n";
+
+  auto layouts = analysis->getRecordLayouts();
+  text << "wide:" << layouts->isWide() << "\n";
+  for (int i = 0; i < layouts->getLayouts().size(); i++) {
+    for (auto &field : layouts->getLayouts()[i]) {
+      text << field << " ";
+    }
+    for (auto reference : layouts->getReferences(i)) {
+      text << reference;
+    }
+    text << "\n";
+  }
+
+  SHA1 programHash;
+  programHash.update(text.str());
+
+  std::vector<std::string> result;
+  auto types = analysis->getTypeResults();
+  for (auto &functions : partitions) {
+    std::stringstream text;
+    for (auto fn : functions) {
+      text << *fn << "\n";
+      for (auto decl : fn->getDeclarations()) {
+        text << *decl << "\n";
+      }
+      for (auto stmt : fn->getStmts()) {
+        text << *stmt << "\n";
+      }
+
+      DependenceVisitor dependences(program, layouts, text);
+      fn->accept(&dependences);
+      text << "\n";
+
+      // The signatures of the function and of the functions it refers to
+      text << *types->getInferredType(fn->getDecl()) << "\n";
+      for (auto callee : dependences.callees) {
+        text << callee->getName() << ":" << *types->getInferredType(callee->getDecl()) << "\n";
+      }
+
+      // Which locals are roots for the garbage collector
+      if (gc) {
+        std::vector<ASTDeclNode *> decls = fn->getFormals();
+        for (auto stmt : fn->getDeclarations()) {
+          auto vars = stmt->getVars();
+          decls.insert(decls.end(), vars.begin(), vars.end());
+        }
+        for (auto decl : decls) {
+          text << RecordLayouts::mayHoldReference(types->getInferredType(decl));
+        }
+        text << "\n";
+      }
+    }
+
+    SHA1 hash = programHash;
+    hash.update(text.str());
+    result.push_back(toHex(hash.result(), true));
+  }
+  return result;
+}
+
+std::string CodeGenCache::path(const std::string &key) const {
+  SmallString<128> file(directory);
+  sys::path::append(file, key + ".bc");
+  return file.str().str();
+}
+
+bool CodeGenCache::lookup(const std::string &key, SmallVectorImpl<char> &bitcode) {
+  auto buffer = MemoryBuffer::getFile(path(key));
+  if (!buffer) {
+    misses++;
+    return false;
+  }
+  auto contents = (*buffer)->getBuffer();
+  bitcode.assign(contents.begin(), contents.end());
+  hits++;
+  return true;
+}
+
+/*
+ * Entries are written to a temporary file and renamed into place so that
+ * concurrent compilations sharing the directory never read a partial entry.
+ */
+void CodeGenCache::store(const std::string &key, StringRef bitcode) {
+  SmallString<128> model(directory);
+  sys::path::append(model, "%%%%%%%%%%%%.tmp");
+  int fd;
+  SmallString<128> temporary;
+  if (sys::fs::createUniqueFile(model, fd, temporary)) {
+    LOG_S(WARNING) << "Cannot write to the cache directory " << directory;
+    return;
+  }
+  {
+    raw_fd_ostream os(fd, true);
+    os << bitcode;
+  }
+  if (sys::fs::rename(temporary, path(key))) {
+    sys::fs::remove(temporary);
+  }
+}
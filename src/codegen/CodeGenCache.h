@@ -0,0 +1,69 @@
+#pragma once
+
+#include "ASTProgram.h"
+#include "SemanticAnalysis.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+/*! \class CodeGenCache
+ *  \brief An on-disk cache of the generated code of function groups.
+ *
+ * With a cache the functions of a program are generated in one partition
+ * per group of mutually recursive functions, see FunctionGraphCreator, plus
+ * a partition holding the globals shared by all functions.  The transformed,
+ * e.g., optimized, bitcode of each partition is stored in the cache
+ * directory in a file named by a hash of everything its code depends on:
+ *  - the source of the functions in the group,
+ *  - the record layouts of the program and those used by the group,
+ *  - the type signatures of the group and of the functions it calls,
+ *  - the names and arities of all functions, which fix the dispatch table,
+ *  - the compiler flags given to the cache and the garbage collection mode.
+ * When a function changes only its own group misses, along with the groups
+ * whose code depends on it, e.g., callers whose view of its type changed,
+ * so recompiling a large program mostly reads bitcode from the cache.
+ *
+ * The whole program is still analyzed since the record layouts, and with
+ * them the code of every function, depend on the types of all of it.
+ */
+class CodeGenCache {
+public:
+  /*! \brief Use a cache directory, which is created if needed.
+   *
+   * \param directory the directory holding the cached bitcode
+   * \param flags the options, other than garbage collection, that change the generated code
+   * \throws InternalError if the directory cannot be created
+   */
+  CodeGenCache(std::string directory, std::string flags);
+
+  /*! \brief The keys of the code for partitions of the program.
+   *
+   * An empty partition stands for the globals shared by all functions.
+   * Inferred types are computed on demand, so keys must not be computed
+   * concurrently with other uses of the analysis results.
+   */
+  std::vector<std::string> keys(ASTProgram* program, SemanticAnalysis* analysis,
+                                const std::vector<std::vector<ASTFunction*>> &partitions, bool gc);
+
+  //! \brief Read the bitcode stored under the key, false if there is none.
+  bool lookup(const std::string &key, llvm::SmallVectorImpl<char> &bitcode);
+
+  //! \brief Store bitcode under the key.  Failures only lose the entry.
+  void store(const std::string &key, llvm::StringRef bitcode);
+
+  //! \brief The number of lookups that found bitcode.
+  unsigned getHits() const { return hits; }
+
+  //! \brief The number of lookups that did not find bitcode.
+  unsigned getMisses() const { return misses; }
+
+private:
+  std::string directory;
+  std::string flags;
+  std::atomic<unsigned> hits{0};
+  std::atomic<unsigned> misses{0};
+
+  std::string path(const std::string &key) const;
+};
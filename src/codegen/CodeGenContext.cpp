@@ -0,0 +1,302 @@
+#include "CodeGenContext.h"
+#include "ASTProgram.h"
+
+#include "llvm/IR/MDBuilder.h"
+
+namespace { // Anonymous namespace for local helpers
+
+// The runtime's pointer to the top frame of the shadow stack.
+llvm::GlobalVariable *declareGCTop(CodeGenContext &ctx) {
+  if (ctx.gcTop == nullptr) {
+    ctx.gcTop = new llvm::GlobalVariable(*ctx.CurrentModule, llvm::Type::getInt8PtrTy(ctx.TheContext),
+                                         false, llvm::GlobalValue::ExternalLinkage, nullptr,
+                                         "_tip_gc_top");
+  }
+  return ctx.gcTop;
+}
+
+}
+
+using namespace llvm;
+
+CodeGenContext::CodeGenContext(LLVMContext &context, std::string moduleName)
+    : TheContext(context), Builder(context),
+      CurrentModule(std::make_unique<Module>(moduleName, context)),
+      zeroV(ConstantInt::get(Type::getInt64Ty(context), 0)),
+      oneV(ConstantInt::get(Type::getInt64Ty(context), 1)) {}
+
+/*
+ * Create LLVM Function in Module associated with current program.
+ * This function declares the function, but it does not generate code.
+ * This is a key element of the shallow pass that builds the function
+ * dispatch table.
+ */
+llvm::Function *CodeGenContext::getFunction(ASTFunction *Fn) {
+  // The formal parameters are those of the function node
+  auto formals = Fn->getFormals();
+  const std::string &Name = Fn->getName();
+
+  /*
+   * Main is handled specially.  It is declared as "_tip_main" with
+   * no arguments - any arguments are converted to locals with special
+   * initializaton in Function::codegen().
+   */
+  if (Fn->getDecl()->getSymbol() == mainSymbol) {
+    if (auto *M = CurrentModule->getFunction("_tip_main")) {
+      return M;
+    }
+
+    // initialize the number of TIP program args for initializing globals
+    numTIPArgs = formals.size();
+
+    // Declare "_tip_main()"
+    auto *M = llvm::Function::Create(
+        FunctionType::get(Type::getInt64Ty(TheContext), false),
+        llvm::Function::ExternalLinkage, "_tip_" + Name, CurrentModule.get());
+    return M;
+  } else {
+    // check if function is in the current module
+    if (auto *F = CurrentModule->getFunction(Name)) {
+      return F;
+    }
+
+    // function not found, so create it
+
+    std::vector<Type *> FormalTypes(formals.size(), Type::getInt64Ty(TheContext));
+
+    // Use type factory to create function from formal type to int
+    auto *FT = FunctionType::get(Type::getInt64Ty(TheContext), FormalTypes, false);
+
+    auto *F = llvm::Function::Create(FT, llvm::Function::ExternalLinkage, Name,
+                                     CurrentModule.get());
+
+    // assign names to args for readability of generated code
+    unsigned i = 0;
+    for (auto &param : F->args()) {
+      param.setName(formals[i++]->getName());
+    }
+
+    return F;
+  }
+}
+
+/*
+ * Each record layout is a struct with an int64 slot per field.  When the
+ * program cannot be laid out compactly the single layout is the "uber
+ * record", which has a slot for every field in the program.  While
+ * wasteful of memory, it is compatible with the limited type checking
+ * provided for records in TIP.
+ */
+llvm::StructType *CodeGenContext::getRecordType(int Layout) {
+  if (recordTypes.empty()) {
+    recordTypes.resize(recordLayouts->getLayouts().size(), nullptr);
+    recordFieldIndex.resize(recordLayouts->getLayouts().size());
+  }
+
+  if (recordTypes[Layout] == nullptr) {
+    std::vector<Type *> member_values;
+    for (auto &field : recordLayouts->getLayouts()[Layout]) {
+      recordFieldIndex[Layout][field] = member_values.size();
+      member_values.push_back(IntegerType::getInt64Ty(TheContext));
+    }
+    auto name = recordLayouts->isWide() ? std::string("uberRecord") : "record" + std::to_string(Layout);
+    recordTypes[Layout] = StructType::create(TheContext, member_values, name);
+  }
+  return recordTypes[Layout];
+}
+
+int CodeGenContext::getFieldIndex(int Layout, const std::string &Field) {
+  getRecordType(Layout);
+  auto index = recordFieldIndex[Layout].find(Field);
+  return index == recordFieldIndex[Layout].end() ? -1 : index->second;
+}
+
+/*
+ * Create an alloca instruction in the entry block of the function.
+ * This is used for mutable variables, including arguments to functions.
+ */
+AllocaInst *CodeGenContext::CreateEntryBlockAlloca(llvm::Function *TheFunction, const std::string &VarName) {
+  IRBuilder<> tmp(&TheFunction->getEntryBlock(), TheFunction->getEntryBlock().begin());
+  return tmp.CreateAlloca(Type::getInt64Ty(TheContext), 0, VarName);
+}
+
+/*
+ * Bump allocate from the runtime's current arena.  The fast path is
+ *    next = _tip_heap_next; bumped = next + Size;
+ *    if (bumped <= _tip_heap_end) _tip_heap_next = bumped;
+ * and otherwise _tip_heap_refill(Size) maps a new arena and returns the
+ * memory from it.  Arenas are zeroed by the system so no clearing is needed.
+ */
+Value *CodeGenContext::CreateHeapAlloc(uint64_t Size, uint64_t References, const std::string &Name) {
+  auto *bytePtrType = Type::getInt8PtrTy(TheContext);
+  if (gc) {
+    gcMayCollect = true;
+    if (gcAlloc == nullptr) {
+      auto *FT = FunctionType::get(bytePtrType, {Type::getInt64Ty(TheContext), Type::getInt64Ty(TheContext)}, false);
+      gcAlloc = llvm::Function::Create(FT, llvm::Function::ExternalLinkage,
+                                       "_tip_gc_alloc", CurrentModule.get());
+      gcAlloc->addFnAttr(Attribute::NoUnwind);
+      gcAlloc->addAttribute(0, Attribute::NoAlias);
+    }
+    return Builder.CreateCall(gcAlloc, {ConstantInt::get(Type::getInt64Ty(TheContext), Size),
+                                        ConstantInt::get(Type::getInt64Ty(TheContext), References)},
+                              Name);
+  }
+
+  if (heapRefill == nullptr) {
+    auto declareCursor = [this, bytePtrType](const std::string &cursorName) {
+      return new GlobalVariable(*CurrentModule, bytePtrType, false,
+                                GlobalValue::ExternalLinkage, nullptr, cursorName);
+    };
+    heapNext = declareCursor("_tip_heap_next");
+    heapEnd = declareCursor("_tip_heap_end");
+
+    auto *FT = FunctionType::get(bytePtrType, {Type::getInt64Ty(TheContext)}, false);
+    heapRefill = llvm::Function::Create(FT, llvm::Function::ExternalLinkage,
+                                        "_tip_heap_refill", CurrentModule.get());
+    heapRefill->addFnAttr(Attribute::NoUnwind);
+    heapRefill->addAttribute(0, Attribute::NoAlias);
+  }
+
+  auto *TheFunction = Builder.GetInsertBlock()->getParent();
+  auto *sizeV = ConstantInt::get(Type::getInt64Ty(TheContext), Size);
+
+  auto *next = Builder.CreateLoad(bytePtrType, heapNext, "heap.next");
+  auto *bumped = Builder.CreateGEP(Type::getInt8Ty(TheContext), next, sizeV, "heap.bumped");
+  auto *end = Builder.CreateLoad(bytePtrType, heapEnd, "heap.end");
+  auto *fits = Builder.CreateICmpULE(bumped, end, "heap.fits");
+
+  auto labelNum = this->labelNum++;
+  auto *BumpBB = BasicBlock::Create(TheContext, "heap.bump" + std::to_string(labelNum), TheFunction);
+  auto *RefillBB = BasicBlock::Create(TheContext, "heap.refill" + std::to_string(labelNum), TheFunction);
+  auto *DoneBB = BasicBlock::Create(TheContext, "heap.done" + std::to_string(labelNum), TheFunction);
+
+  // An arena holds many thousands of allocations, so refills are rare
+  MDBuilder weights(TheContext);
+  Builder.CreateCondBr(fits, BumpBB, RefillBB, weights.createBranchWeights(2000, 1));
+
+  Builder.SetInsertPoint(BumpBB);
+  Builder.CreateStore(bumped, heapNext);
+  Builder.CreateBr(DoneBB);
+
+  Builder.SetInsertPoint(RefillBB);
+  auto *refilled = Builder.CreateCall(heapRefill, {sizeV}, "heap.refilled");
+  Builder.CreateBr(DoneBB);
+
+  Builder.SetInsertPoint(DoneBB);
+  auto *phi = Builder.CreatePHI(bytePtrType, 2, Name);
+  phi->addIncoming(next, BumpBB);
+  phi->addIncoming(refilled, RefillBB);
+  return phi;
+}
+
+void CodeGenContext::AddGCRoot(ASTDeclNode *Decl, AllocaInst *Local) {
+  if (gc && RecordLayouts::mayHoldReference(typeResults->getInferredType(Decl))) {
+    gcRoots.push_back(Local);
+  }
+}
+
+/*
+ * Constants are never heap references, so they take no temporary.  The
+ * value stays in its temporary until the temporary is reused, which at
+ * worst keeps an object alive a little longer than needed.
+ */
+void CodeGenContext::PushGCTemp(Value *V) {
+  if (!gc) {
+    return;
+  }
+  if (isa<Constant>(V)) {
+    gcTempStack.push_back(false);
+    return;
+  }
+
+  if (gcTempsInUse == gcTemps.size()) {
+    auto *TheFunction = Builder.GetInsertBlock()->getParent();
+    gcTemps.push_back(CreateEntryBlockAlloca(TheFunction, "gc.temp" + std::to_string(gcTemps.size())));
+  }
+  auto *temp = gcTemps[gcTempsInUse++];
+  if (V->getType()->isPointerTy()) {
+    V = Builder.CreatePtrToInt(V, Type::getInt64Ty(TheContext));
+  }
+  Builder.CreateStore(V, temp);
+  gcTempStack.push_back(true);
+}
+
+void CodeGenContext::PopGCTemp() {
+  if (!gc) {
+    return;
+  }
+  if (gcTempStack.back()) {
+    gcTempsInUse--;
+  }
+  gcTempStack.pop_back();
+}
+
+/*
+ * The frame is a struct matching the runtime's
+ *    { frame *prev; int64_t count; int64_t *roots[count]; }
+ * The top frame is always the frame of the running function, so it is
+ * unlinked by loading its successor through the shadow stack pointer.
+ */
+void CodeGenContext::CreateGCFramePop() {
+  if (!gc) {
+    return;
+  }
+  auto *bytePtrType = Type::getInt8PtrTy(TheContext);
+  auto *top = declareGCTop(*this);
+  auto *frame = Builder.CreateLoad(bytePtrType, top, "gc.frame");
+  auto *prevAddr = Builder.CreatePointerCast(frame, bytePtrType->getPointerTo(), "gc.prevaddr");
+  auto *prev = Builder.CreateLoad(bytePtrType, prevAddr, "gc.prev");
+  auto *unlink = Builder.CreateStore(prev, top);
+  gcFramePops.insert(gcFramePops.end(), {unlink, prev, cast<Instruction>(prevAddr), frame});
+}
+
+void CodeGenContext::CreateGCFrame(llvm::Function *TheFunction) {
+  if (!gc) {
+    return;
+  }
+
+  std::vector<AllocaInst *> roots(gcRoots);
+  roots.insert(roots.end(), gcTemps.begin(), gcTemps.end());
+
+  if (roots.empty() || !gcMayCollect) {
+    // Nothing can be lost to the collector so the pops are not needed
+    for (auto *i : gcFramePops) {
+      i->eraseFromParent();
+    }
+  } else {
+    auto *bytePtrType = Type::getInt8PtrTy(TheContext);
+    auto *int64Type = Type::getInt64Ty(TheContext);
+    auto *frameType = StructType::get(
+        TheContext, {bytePtrType, int64Type, ArrayType::get(int64Type->getPointerTo(), roots.size())});
+
+    auto &entry = TheFunction->getEntryBlock();
+    IRBuilder<> tmp(&entry, entry.begin());
+    auto *frame = tmp.CreateAlloca(frameType, nullptr, "gc.frame");
+
+    // Link the frame after the allocas of the entry block, before any calls
+    auto first = entry.begin();
+    while (isa<AllocaInst>(*first)) {
+      ++first;
+    }
+    tmp.SetInsertPoint(&entry, first);
+
+    auto *top = declareGCTop(*this);
+    tmp.CreateStore(tmp.CreateLoad(bytePtrType, top, "gc.prev"), tmp.CreateStructGEP(frameType, frame, 0));
+    tmp.CreateStore(ConstantInt::get(int64Type, roots.size()), tmp.CreateStructGEP(frameType, frame, 1));
+    for (int i = 0; i < roots.size(); i++) {
+      tmp.CreateStore(roots[i], tmp.CreateInBoundsGEP(frameType, frame, {tmp.getInt32(0), tmp.getInt32(2), tmp.getInt32(i)}));
+    }
+    for (auto *temp : gcTemps) {
+      tmp.CreateStore(zeroV, temp);
+    }
+    tmp.CreateStore(tmp.CreatePointerCast(frame, bytePtrType), top);
+  }
+
+  gcRoots.clear();
+  gcTemps.clear();
+  gcTempStack.clear();
+  gcTempsInUse = 0;
+  gcFramePops.clear();
+  gcMayCollect = false;
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "RecordLayouts.h"
+#include "TypeInference.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ASTFunction;
+class ASTProgram;
+
+/*! \class CodeGenContext
+ *  \brief The state of a single code generation.
+ *
+ * Code generation records lots of information that spans the codegen()
+ * routines, e.g., the current insertion point, the names in scope, and the
+ * function dispatch table.  All of it is held here and passed to each
+ * codegen() routine, rather than kept in globals, so that any number of
+ * programs can be compiled at once on different threads.  Each compilation
+ * must use its own LLVMContext, which has to outlive the generated module.
+ */
+class CodeGenContext {
+public:
+  CodeGenContext(llvm::LLVMContext &context, std::string moduleName);
+
+  llvm::LLVMContext &TheContext;
+  llvm::IRBuilder<> Builder;
+
+  // The module being compiled
+  std::unique_ptr<llvm::Module> CurrentModule;
+
+  /*
+   * The program being compiled.  Functions are represented with indices
+   * into a table, which permits function values to be passed, i.e, as Int64
+   * indices.  The index of a function is its slot, its position in the
+   * program, which the symbol table binds to each reference to it.
+   */
+  ASTProgram *program = nullptr;
+
+  // The name of the main function as interned for the program, if it has one
+  const std::string *mainSymbol = nullptr;
+
+  /*
+   * This structure stores the LLVM values of the locals and parameters of
+   * the function being generated, indexed by the slots the symbol table
+   * bound to the references to them.  They are added in the order they
+   * are declared, parameters first, which is the order of their slots.
+   */
+  std::vector<llvm::AllocaInst *> Locals;
+
+  /**
+   * The struct types of the record layouts used so far, indexed by layout.
+   * Each is a sequence of int64 slots, one per field of the layout.  They
+   * are created on first use so that modules holding a few functions of a
+   * large program only define the types they refer to.
+   */
+  std::vector<llvm::StructType *> recordTypes;
+
+  // Maps field names to their slot in each record layout used so far
+  std::vector<std::map<std::string, int>> recordFieldIndex;
+
+  // The layouts computed for the records of the program
+  RecordLayouts *recordLayouts = nullptr;
+
+  /*
+   * We use calls to llvm intrinsics for several purposes.  To construct a "nop",
+   * using an LLVM internal intrinsic, and to perform TIP specific IO.
+   */
+  llvm::Function *nop = nullptr;
+  llvm::Function *inputIntrinsic = nullptr;
+  llvm::Function *outputIntrinsic = nullptr;
+  llvm::Function *errorIntrinsic = nullptr;
+
+  /*
+   * Heap memory is bump allocated from arenas owned by the runtime.  The
+   * cursor and limit of the current arena, and the function
+   * that refills it, are declared on first use.
+   */
+  llvm::GlobalVariable *heapNext = nullptr;
+  llvm::GlobalVariable *heapEnd = nullptr;
+  llvm::Function *heapRefill = nullptr;
+
+  /*
+   * With garbage collection heap memory comes from the collector instead,
+   * and every function that may hold references while the collector runs
+   * links a frame onto the shadow stack of the runtime.  A frame lists the
+   * locals that may hold references, as decided by their inferred types,
+   * and the temporaries holding intermediate values of expressions.
+   */
+  bool gc = false;
+  TypeInference *typeResults = nullptr;
+  llvm::GlobalVariable *gcTop = nullptr;
+  llvm::Function *gcAlloc = nullptr;
+
+  // The shadow stack state of the function being generated
+  std::vector<llvm::AllocaInst *> gcRoots;
+  std::vector<llvm::AllocaInst *> gcTemps;
+  std::vector<bool> gcTempStack;
+  unsigned gcTempsInUse = 0;
+  std::vector<llvm::Instruction *> gcFramePops;
+  bool gcMayCollect = false;
+
+  // A counter to create unique labels
+  int labelNum = 0;
+
+  // Indicate whether the expression code gen is for an L-value
+  bool lValueGen = false;
+
+  /*
+   * The global function dispatch table is created in a shallow pass over
+   * the function signatures, stored here, and then referenced in generating
+   * function applications.
+   */
+  llvm::GlobalVariable *tipFTable = nullptr;
+
+  // The number of TIP program parameters
+  int numTIPArgs = 0;
+
+  /*
+   * The global argument count and array are used to communicate command
+   * line inputs to the TIP main function.
+   */
+  llvm::GlobalVariable *tipNumInputs = nullptr;
+  llvm::GlobalVariable *tipInputArray = nullptr;
+
+  /*
+   * Some constants are used repeatedly in code generation.  We define them
+   * here to eliminate redundancy.
+   */
+  llvm::Constant *zeroV;
+  llvm::Constant *oneV;
+
+  /*! \fn getFunction
+   *  \brief Declare the LLVM function for a TIP function.
+   *
+   * This function declares the function, but it does not generate code.
+   * This is a key element of the shallow pass that builds the function
+   * dispatch table.
+   * \param Fn the TIP function
+   * \return the function declared in the current module
+   */
+  llvm::Function *getFunction(ASTFunction *Fn);
+
+  /*! \fn getRecordType
+   *  \brief The struct type of a record layout, created on first use.
+   */
+  llvm::StructType *getRecordType(int Layout);
+
+  /*! \fn getFieldIndex
+   *  \brief The slot of a field in a record layout.
+   * \return the index of the slot, or -1 if the layout has no such field
+   */
+  int getFieldIndex(int Layout, const std::string &Field);
+
+  /*! \fn CreateEntryBlockAlloca
+   *  \brief Create an alloca instruction in the entry block of the function.
+   *
+   * This is used for mutable variables, including arguments to functions.
+   */
+  llvm::AllocaInst *CreateEntryBlockAlloca(llvm::Function *TheFunction, const std::string &VarName);
+
+  /*! \fn CreateHeapAlloc
+   *  \brief Allocate zeroed heap memory at the current insertion point.
+   *
+   * Emits an inline bump of the runtime's arena cursor with a call to
+   * refill the arena on the unlikely path.
+   * With garbage collection the collector's allocator is called instead.
+   * \param Size the number of bytes to allocate, a multiple of 8
+   * \param References the slots that may hold references, bit i for slot i
+   *        and bit 61 for every slot from 61 on
+   * \param Name the name of the resulting i8 pointer
+   * \return the allocated memory
+   */
+  llvm::Value *CreateHeapAlloc(uint64_t Size, uint64_t References, const std::string &Name);
+
+  /*! \fn AddGCRoot
+   *  \brief Record the local of a declaration if its value may be a reference.
+   */
+  void AddGCRoot(ASTDeclNode *Decl, llvm::AllocaInst *Local);
+
+  /*! \fn PushGCTemp
+   *  \brief Keep an intermediate value reachable while code that may collect runs.
+   *
+   * Temporaries are released in the reverse order with PopGCTemp.  Both do
+   * nothing without garbage collection.
+   */
+  void PushGCTemp(llvm::Value *V);
+  void PopGCTemp();
+
+  /*! \fn CreateGCFrame
+   *  \brief Link the frame of the function onto the shadow stack.
+   *
+   * Called once the whole function has been generated, which is when its
+   * roots are known.  The frame is linked at the start of the entry block
+   * and unlinked where CreateGCFramePop was called.  Functions without roots,
+   * or that neither allocate nor call other functions, get no frame.
+   */
+  void CreateGCFrame(llvm::Function *TheFunction);
+
+  /*! \fn CreateGCFramePop
+   *  \brief Unlink the frame of the function, which must be the top frame.
+   */
+  void CreateGCFramePop();
+};
@@ -1,4 +1,5 @@
 #include "AST.h"
+#include "CodeGenContext.h"
 #include "SemanticAnalysis.h"
 #include "InternalError.h"
 
@@ -56,174 +57,83 @@ using namespace llvm;
  * optimization passes to clean most of it up.  
  */
 
-namespace {
-/*
- * These structures records lots of information that spans the codegen()
- * routines.  For example, the current insertion, entry, return blocks
- * in the current function.
- */
-LLVMContext TheContext;
-IRBuilder<> Builder(TheContext);
-
-/* 
- * Functions are represented with indices into a table. 
- * This permits function values to be passed, i.e, as Int64 indices. 
- */
-std::map<std::string, int> functionIndex;
-
-std::map<std::string, std::vector<std::string>> functionFormalNames;
-
-/*
- * This structure stores the mapping from names in a function scope
- * to their LLVM values.  The structure is built when entering a
- * scope and cleared when exiting a scope.
- */
-std::map<std::string, AllocaInst *> NamedValues;
-
-/**
- * The UberRecord is a the type of all records
- *  It has a field for every named field in the program
- */
-llvm::StructType * uberRecordType;
-
-/**
- * The type for pointers to UberRecordType
- */
-llvm::PointerType * ptrToUberRecordType;
-
-// Maps field names to their index in the UberRecor
-std::map<std::basic_string<char>, int> fieldIndex;
-
-// Vector of fields in an uber record
-std::vector<std::basic_string<char>> fieldVector;
-
-// Permits getFunction to access the current module being compiled
-std::unique_ptr<Module> CurrentModule;
-
-/*
- * We use calls to llvm intrinsics for several purposes.  To construct a "nop",
- * using an LLVM internal intrinsic, to perform TIP specific IO, and
- * to allocate heap memory.
- */
-llvm::Function *nop = nullptr;
-llvm::Function *inputIntrinsic = nullptr;
-llvm::Function *outputIntrinsic = nullptr;
-llvm::Function *errorIntrinsic = nullptr;
-llvm::Function *callocFun = nullptr;
-
-
-// A counter to create unique labels
-int labelNum = 0;
-
-// Indicate whether the expression code gen is for an L-value
-bool lValueGen = false;
-
-/*
- * The global function dispatch table is created in a shallow pass over
- * the function signatures, stored here, and then referenced in generating
- * function applications.
- */
-GlobalVariable *tipFTable = nullptr;
-
-// The number of TIP program parameters
-int numTIPArgs = 0;
 
-/*
- * The global argument count and array are used to communicate command
- * line inputs to the TIP main function.
- */
-GlobalVariable *tipNumInputs = nullptr;
-GlobalVariable *tipInputArray = nullptr;
-
-/*
- * Some constants are used repeatedly in code generation.  We define them
- * hear to eliminate redundancy.
- */
-Constant *zeroV = ConstantInt::get(Type::getInt64Ty(TheContext), 0);
-Constant *oneV = ConstantInt::get(Type::getInt64Ty(TheContext), 1);
+namespace {
 
 /*
- * Create LLVM Function in Module associated with current program.
- * This function declares the function, but it does not generate code.
- * This is a key element of the shallow pass that builds the function
- * dispatch table.
+ * How the globals shared by all functions are emitted into a module.  A
+ * module holding the whole program keeps them private.  When the program is
+ * split into partitions one of them exports the definitions and the others
+ * refer to them, which lets the partitions be linked back together.  Those
+ * that import the globals see the contents of the dispatch table, those that
+ * only declare them do not.
  */
-llvm::Function *getFunction(std::string Name) {
-  // Lookup the symbol to access the formal parameter list
-  auto formals = functionFormalNames[Name];
-
-  /*
-   * Main is handled specially.  It is declared as "_tip_main" with
-   * no arguments - any arguments are converted to locals with special
-   * initializaton in Function::codegen().
-   */
-  if (Name == "main") {
-    if (auto *M = CurrentModule->getFunction("_tip_main")) {
-      return M;
-    }
-
-    // initialize the number of TIP program args for initializing globals
-    numTIPArgs = formals.size();
-
-    // Declare "_tip_main()"
-    auto *M = llvm::Function::Create(
-        FunctionType::get(Type::getInt64Ty(TheContext), false),
-        llvm::Function::ExternalLinkage, "_tip_" + Name, CurrentModule.get());
-    return M;
-  } else {
-    // check if function is in the current module
-    if (auto *F = CurrentModule->getFunction(Name)) {
-      return F;
-    }
-
-    // function not found, so create it
-
-    std::vector<Type *> FormalTypes(formals.size(), Type::getInt64Ty(TheContext));
-
-    // Use type factory to create function from formal type to int
-    auto *FT = FunctionType::get(Type::getInt64Ty(TheContext), FormalTypes, false);
+enum class SharedGlobals { Private, Exported, Imported, Declared };
+
+std::unique_ptr<llvm::Module> generateModule(ASTProgram* program,
+                                             SemanticAnalysis* analysis,
+                                             std::string programName,
+                                             llvm::LLVMContext &context,
+                                             const std::vector<ASTFunction*> &functions,
+                                             SharedGlobals globals,
+                                             bool gc);
+
+// Whether evaluating an expression may allocate, and so collect garbage
+bool mayCollect(ASTExpr *expr) {
+  return dynamic_cast<ASTNumberExpr*>(expr) == nullptr && dynamic_cast<ASTVariableExpr*>(expr) == nullptr &&
+         dynamic_cast<ASTNullExpr*>(expr) == nullptr && dynamic_cast<ASTInputExpr*>(expr) == nullptr;
+}
 
-    auto *F = llvm::Function::Create(FT, llvm::Function::ExternalLinkage, Name,
-                                     CurrentModule.get());
+} // end anonymous namespace
 
-    // assign names to args for readability of generated code
-    unsigned i = 0;
-    for (auto &param : F->args()) {
-      param.setName(formals[i++]);
-    }
+/********************* codegen() routines ************************/
 
-    return F;
-  }
+std::unique_ptr<llvm::Module> ASTProgram::codegen(SemanticAnalysis* analysis,
+                                                  std::string programName,
+                                                  llvm::LLVMContext &context,
+                                                  bool gc) {
+  return generateModule(this, analysis, programName, context, getFunctions(), SharedGlobals::Private, gc);
 }
 
-/*
- * Create an alloca instruction in the entry block of the function.
- * This is used for mutable variables, including arguments to functions.
- */
-AllocaInst *CreateEntryBlockAlloca(llvm::Function *TheFunction, const std::string &VarName) {
-  IRBuilder<> tmp(&TheFunction->getEntryBlock(), TheFunction->getEntryBlock().begin());
-  return tmp.CreateAlloca(Type::getInt64Ty(TheContext), 0, VarName);
+std::unique_ptr<llvm::Module> ASTProgram::codegenPartition(SemanticAnalysis* analysis,
+                                                           std::string programName,
+                                                           llvm::LLVMContext &context,
+                                                           const std::vector<ASTFunction*> &functions,
+                                                           bool definesGlobals,
+                                                           bool gc,
+                                                           bool declareAll) {
+  auto globals = SharedGlobals::Exported;
+  if (!definesGlobals) {
+    globals = declareAll ? SharedGlobals::Imported : SharedGlobals::Declared;
+  }
+  return generateModule(this, analysis, programName, context, functions, globals, gc);
 }
 
-} // end anonymous namespace for code generator data and functions
-
-/********************* codegen() routines ************************/
+namespace {
 
-std::unique_ptr<llvm::Module> ASTProgram::codegen(SemanticAnalysis* analysis,
-                                                  std::string programName) {
-  // Create module to hold generated code
-  auto TheModule = std::make_unique<Module>(programName, TheContext);
+std::unique_ptr<llvm::Module> generateModule(ASTProgram* program,
+                                             SemanticAnalysis* analysis,
+                                             std::string programName,
+                                             llvm::LLVMContext &context,
+                                             const std::vector<ASTFunction*> &functions,
+                                             SharedGlobals globals,
+                                             bool gc) {
+  // The state shared by the codegen routines, including the module to hold generated code
+  CodeGenContext ctx(context, programName);
+  ctx.gc = gc;
+  ctx.typeResults = analysis->getTypeResults();
+  ctx.mainSymbol = program->getArena().getSymbols()->find("main");
 
   // Set the default target triple for this platform
-  TheModule->setTargetTriple(LLVMGetDefaultTargetTriple());
+  ctx.CurrentModule->setTargetTriple(LLVMGetDefaultTargetTriple());
 
   // Initialize nop declaration
-  nop = Intrinsic::getDeclaration(TheModule.get(), Intrinsic::donothing);
+  ctx.nop = Intrinsic::getDeclaration(ctx.CurrentModule.get(), Intrinsic::donothing);
 
-  labelNum = 0;
+  // Whether the globals are defined in another module
+  bool external = globals == SharedGlobals::Imported || globals == SharedGlobals::Declared;
 
-  // Transfer the module for access by shared codegen routines
-  CurrentModule = std::move(TheModule);
+  auto *mainFunction = program->findFunctionByName("main");
 
   /*
    * This shallow pass over the function declarations builds the
@@ -232,19 +142,11 @@ std::unique_ptr<llvm::Module> ASTProgram::codegen(SemanticAnalysis* analysis,
    */
   {
     /*
-     * First create the local function symbol table which stores
-     * the function index and formal parameters
+     * The index of a function is its position in the program, which the
+     * symbol table bound to the references to it.
      */
-    int funIndex = 0;
-    for (auto const &fn : getFunctions()) {
-      functionIndex[fn->getName()] = funIndex++;
-
-      auto formals = fn->getFormals();
-      std::vector<std::string> names;
-      std::transform(formals.begin(), formals.end(), 
-                     std::back_inserter(names), [](auto& d){return d->getName();});
-      functionFormalNames[fn->getName()] = names;
-    }
+    ctx.program = program;
+    int funIndex = program->getFunctions().size();
 
     /*
      * Create the llvm functions.
@@ -254,8 +156,13 @@ std::unique_ptr<llvm::Module> ASTProgram::codegen(SemanticAnalysis* analysis,
      * below in creating the ftableInit.
      */
     std::vector<llvm::Constant *> programFunctions;
-    for (auto const &fn : getFunctions()) {
-      programFunctions.push_back(getFunction(fn->getName()));
+    if (globals != SharedGlobals::Declared) {
+      for (auto const &fn : program->getFunctions()) {
+        programFunctions.push_back(ctx.getFunction(fn));
+      }
+    } else if (mainFunction != nullptr) {
+      // Main is still declared since it fixes the size of the input array
+      ctx.getFunction(mainFunction);
     }
 
     /*
@@ -264,7 +171,7 @@ std::unique_ptr<llvm::Module> ASTProgram::codegen(SemanticAnalysis* analysis,
      * bitcast the declared functions prior to inserting them.
      */
     auto *genFunPtrType = PointerType::get(
-        FunctionType::get(Type::getInt64Ty(TheContext), None, false), 0);
+        FunctionType::get(Type::getInt64Ty(ctx.TheContext), None, false), 0);
 
     // Create and record the function dispatch table
     auto *ftableType = ArrayType::get(genFunPtrType, funIndex);
@@ -280,12 +187,23 @@ std::unique_ptr<llvm::Module> ASTProgram::codegen(SemanticAnalysis* analysis,
      * Create initializer for function table using generic function type
      * and set the initial value.
      */
-    auto *ftableInit = ConstantArray::get(ftableType, castProgramFunctions);
+    llvm::Constant *ftableInit = nullptr;
+    if (globals != SharedGlobals::Declared) {
+      ftableInit = ConstantArray::get(ftableType, castProgramFunctions);
+    }
 
-    // Create the global function dispatch table
-    tipFTable = new GlobalVariable(*CurrentModule, ftableType, true,
-                                   llvm::GlobalValue::InternalLinkage,
-                                   ftableInit, "_tip_ftable");
+    /*
+     * Create the global function dispatch table.  Partitions that import it
+     * still see its contents so that loads from it can be folded.
+     */
+    auto ftableLinkage = llvm::GlobalValue::InternalLinkage;
+    if (globals == SharedGlobals::Exported || globals == SharedGlobals::Declared) {
+      ftableLinkage = llvm::GlobalValue::ExternalLinkage;
+    } else if (globals == SharedGlobals::Imported) {
+      ftableLinkage = llvm::GlobalValue::AvailableExternallyLinkage;
+    }
+    ctx.tipFTable = new GlobalVariable(*ctx.CurrentModule, ftableType, true,
+                                   ftableLinkage, ftableInit, "_tip_ftable");
   }
 
   /*
@@ -301,223 +219,261 @@ std::unique_ptr<llvm::Module> ASTProgram::codegen(SemanticAnalysis* analysis,
      * we never visit it during the codegen() traversals - since
      * the function doesn't exist in the TIP program.
      */
-    auto fidx = functionIndex.find("main");
-    if (fidx == functionIndex.end()) {
+    if (mainFunction == nullptr && !external) {
       auto *M = llvm::Function::Create(
-          FunctionType::get(Type::getInt64Ty(TheContext), false),
-          llvm::Function::ExternalLinkage, "_tip_main", CurrentModule.get());
-      BasicBlock *BB = BasicBlock::Create(TheContext, "entry", M);
-      Builder.SetInsertPoint(BB);
+          FunctionType::get(Type::getInt64Ty(ctx.TheContext), false),
+          llvm::Function::ExternalLinkage, "_tip_main", ctx.CurrentModule.get());
+      BasicBlock *BB = BasicBlock::Create(ctx.TheContext, "entry", M);
+      ctx.Builder.SetInsertPoint(BB);
 
       auto *undef = llvm::Function::Create(
-          FunctionType::get(Type::getVoidTy(TheContext), false),
+          FunctionType::get(Type::getVoidTy(ctx.TheContext), false),
           llvm::Function::ExternalLinkage, "_tip_main_undefined",
-          CurrentModule.get());
-      Builder.CreateCall(undef);
-      Builder.CreateRet(zeroV);
+          ctx.CurrentModule.get());
+      ctx.Builder.CreateCall(undef);
+      ctx.Builder.CreateRet(ctx.zeroV);
     }
 
-    // create global _tip_num_inputs with init of numTIPArgs
-    tipNumInputs = new GlobalVariable(
-        *CurrentModule, Type::getInt64Ty(TheContext), true,
-        llvm::GlobalValue::ExternalLinkage,
-        ConstantInt::get(Type::getInt64Ty(TheContext), numTIPArgs),
-        "_tip_num_inputs");
-
     // create global _tip_input_array with up to numTIPArgs of Int64
-    auto *inputArrayType = ArrayType::get(Type::getInt64Ty(TheContext), numTIPArgs);
-    std::vector<Constant *> zeros(numTIPArgs, zeroV);
-    tipInputArray = new GlobalVariable(
-        *CurrentModule, inputArrayType, false, llvm::GlobalValue::CommonLinkage,
-        ConstantArray::get(inputArrayType, zeros), "_tip_input_array");
-  }
-
-  // declare the calloc function
-  // the calloc function takes in two ints: the number of items and the size of the items
-  std::vector<Type *> twoInt(2, Type::getInt64Ty(TheContext));
-  auto *FT = FunctionType::get(Type::getInt8PtrTy(TheContext), twoInt, false);
-  callocFun = llvm::Function::Create(FT, llvm::Function::ExternalLinkage,
-                                     "calloc", CurrentModule.get());
-  callocFun->addFnAttr(llvm::Attribute::NoUnwind);
-  callocFun->addAttribute(0, llvm::Attribute::NoAlias);
-
-  /* We create a single unified record structure that is capable of representing
-   * all records in a TIP program.  While wasteful of memory, this approach is 
-   * compatible with the limited type checking provided for records in TIP.
-   *
-   * We refer to this single unified record structure as the "uber record"
-   */
-  std::vector<Type *> member_values;
-  int index = 0;
-  for(auto field : analysis->getSymbolTable()->getFields()){
-      member_values.push_back(IntegerType::getInt64Ty((TheContext)));
-      fieldVector.push_back(field);
-      fieldIndex[field] = index;
-      index++;
+    auto *inputArrayType = ArrayType::get(Type::getInt64Ty(ctx.TheContext), ctx.numTIPArgs);
+
+    if (external) {
+      // main may live in this partition, but the inputs are defined elsewhere
+      ctx.tipInputArray = new GlobalVariable(
+          *ctx.CurrentModule, inputArrayType, false, llvm::GlobalValue::ExternalLinkage,
+          nullptr, "_tip_input_array");
+    } else {
+      // create global _tip_num_inputs with init of numTIPArgs
+      ctx.tipNumInputs = new GlobalVariable(
+          *ctx.CurrentModule, Type::getInt64Ty(ctx.TheContext), true,
+          llvm::GlobalValue::ExternalLinkage,
+          ConstantInt::get(Type::getInt64Ty(ctx.TheContext), ctx.numTIPArgs),
+          "_tip_num_inputs");
+
+      std::vector<Constant *> zeros(ctx.numTIPArgs, ctx.zeroV);
+      ctx.tipInputArray = new GlobalVariable(
+          *ctx.CurrentModule, inputArrayType, false, llvm::GlobalValue::CommonLinkage,
+          ConstantArray::get(inputArrayType, zeros), "_tip_input_array");
+    }
   }
-  uberRecordType = StructType::create(TheContext, member_values, "uberRecord");
-  ptrToUberRecordType = PointerType::get(uberRecordType, 0);
+
+  // Record types are created as the layouts are used
+  ctx.recordLayouts = analysis->getRecordLayouts();
 
   // Code is generated into the module by the other routines
-  for (auto const &fn : getFunctions()) {
-    fn->codegen();
+  for (auto const &fn : functions) {
+    fn->codegen(ctx);
   }
 
-  TheModule = std::move(CurrentModule);
+  auto TheModule = std::move(ctx.CurrentModule);
 
   verifyModule(*TheModule);
 
   return TheModule;
 }
 
-llvm::Value* ASTFunction::codegen() {
-  llvm::Function *TheFunction = getFunction(getName());
+} // end anonymous namespace
+
+llvm::Value* ASTFunction::codegen(CodeGenContext &ctx) {
+  llvm::Function *TheFunction = ctx.getFunction(this);
   if (TheFunction == nullptr) {
     throw InternalError("failed to declare the function" + getName());
   }
 
   // create basic block to hold body of function definition
-  BasicBlock *BB = BasicBlock::Create(TheContext, "entry", TheFunction);
-  Builder.SetInsertPoint(BB);
+  BasicBlock *BB = BasicBlock::Create(ctx.TheContext, "entry", TheFunction);
+  ctx.Builder.SetInsertPoint(BB);
 
   // keep scope separate from prior definitions
-  NamedValues.clear();
+  ctx.Locals.clear();
 
   /*
    * Add arguments to the symbol table
    *   - for main function, we initialize allocas with array loads
    *   - for other functions, we initialize allocas with the arg values
    */
-  if (getName() == "main") {
+  auto formals = getFormals();
+  if (getDecl()->getSymbol() == ctx.mainSymbol) {
     int argIdx = 0;
     // Note that the args are not in the LLVM function decl, so we use the AST formals
-    for (auto &argName : functionFormalNames[getName()]) {
+    for (auto formal : formals) {
       // Create an alloca for this argument and store its value
-      AllocaInst *argAlloc = CreateEntryBlockAlloca(TheFunction, argName);
+      auto argName = formal->getName();
+      AllocaInst *argAlloc = ctx.CreateEntryBlockAlloca(TheFunction, argName);
+      ctx.AddGCRoot(formal, argAlloc);
 
       // Emit the GEP instruction to index into input array
       std::vector<Value *> indices;
-      indices.push_back(zeroV); 
-      indices.push_back(ConstantInt::get(Type::getInt64Ty(TheContext), argIdx));
-      auto *gep = Builder.CreateInBoundsGEP(tipInputArray, indices, "inputidx");
+      indices.push_back(ctx.zeroV); 
+      indices.push_back(ConstantInt::get(Type::getInt64Ty(ctx.TheContext), argIdx));
+      auto *gep = ctx.Builder.CreateInBoundsGEP(ctx.tipInputArray, indices, "inputidx");
 
       // Load the value and store it into the arg's alloca
-      auto *inVal = Builder.CreateLoad(gep, "tipinput" + std::to_string(argIdx++));
-      Builder.CreateStore(inVal, argAlloc);
+      auto *inVal = ctx.Builder.CreateLoad(gep, "tipinput" + std::to_string(argIdx++));
+      ctx.Builder.CreateStore(inVal, argAlloc);
 
-      // Record name binding to alloca
-      NamedValues[argName] = argAlloc;
+      // Record the alloca in the slot of the parameter
+      ctx.Locals.push_back(argAlloc);
     }
   } else {
     for (auto &arg : TheFunction->args()) {
       // Create an alloca for this argument and store its value
-      AllocaInst *argAlloc = CreateEntryBlockAlloca(TheFunction, arg.getName().str());
-      Builder.CreateStore(&arg, argAlloc);
+      AllocaInst *argAlloc = ctx.CreateEntryBlockAlloca(TheFunction, arg.getName().str());
+      ctx.AddGCRoot(formals[arg.getArgNo()], argAlloc);
+      ctx.Builder.CreateStore(&arg, argAlloc);
 
-      // Record name binding to alloca
-      NamedValues[arg.getName().str()] = argAlloc;
+      // Record the alloca in the slot of the parameter
+      ctx.Locals.push_back(argAlloc);
     }
   }
 
   // add local declarations to the symbol table
   for (auto const &decl : getDeclarations()) {
-    if (decl->codegen() == nullptr) {
+    if (decl->codegen(ctx) == nullptr) {
       TheFunction->eraseFromParent();
       throw InternalError("failed to generate bitcode for the function declarations");
     }
   }
 
   for (auto &stmt : getStmts()) {
-    if (stmt->codegen() == nullptr) {
+    if (stmt->codegen(ctx) == nullptr) {
       TheFunction->eraseFromParent();
       throw InternalError("failed to generate bitcode for the function statement");
     }
   }
 
+  ctx.CreateGCFrame(TheFunction);
+
   verifyFunction(*TheFunction);
   return TheFunction;
 }
 
-llvm::Value* ASTNumberExpr::codegen() {
-  return ConstantInt::get(Type::getInt64Ty(TheContext), getValue());
+llvm::Value* ASTNumberExpr::codegen(CodeGenContext &ctx) {
+  return ConstantInt::get(Type::getInt64Ty(ctx.TheContext), getValue());
 }
 
-llvm::Value* ASTBinaryExpr::codegen() {
-  Value *L = getLeft()->codegen();
-  Value *R = getRight()->codegen();
-  if (L == nullptr || R == nullptr) {
+llvm::Value* ASTBinaryExpr::codegen(CodeGenContext &ctx) {
+  Value *L = getLeft()->codegen(ctx);
+  if (L == nullptr) {
     throw InternalError("null binary operand");
   }
 
-  if (getOp() == "+") {
-    return Builder.CreateAdd(L, R, "addtmp");
-  } else if (getOp() == "-") {
-    return Builder.CreateSub(L, R, "subtmp");
-  } else if (getOp() == "*") {
-    return Builder.CreateMul(L, R, "multmp");
-  } else if (getOp() == "/") {
-    return Builder.CreateSDiv(L, R, "divtmp");
-  } else if (getOp() == ">") {
-    return Builder.CreateICmpSGT(L, R, "gttmp");
-  } else if (getOp() == "==") {
-    return Builder.CreateICmpEQ(L, R, "eqtmp");
-  } else if (getOp() == "!=") {
-    return Builder.CreateICmpNE(L, R, "netmp");
-  } else {
-    throw InternalError("Invalid binary operator: " + OP);
+  // Only equality compares references, whose object must outlive the right operand
+  bool keepLeft = (getOp() == EQ || getOp() == NE) && mayCollect(getRight());
+  if (keepLeft) {
+    ctx.PushGCTemp(L);
+  }
+  Value *R = getRight()->codegen(ctx);
+  if (R == nullptr) {
+    throw InternalError("null binary operand");
   }
+  if (keepLeft) {
+    ctx.PopGCTemp();
+  }
+
+  switch (getOp()) {
+  case ADD:
+    return ctx.Builder.CreateAdd(L, R, "addtmp");
+  case SUB:
+    return ctx.Builder.CreateSub(L, R, "subtmp");
+  case MUL:
+    return ctx.Builder.CreateMul(L, R, "multmp");
+  case DIV:
+    return ctx.Builder.CreateSDiv(L, R, "divtmp");
+  case GT:
+    return ctx.Builder.CreateICmpSGT(L, R, "gttmp");
+  case EQ:
+    return ctx.Builder.CreateICmpEQ(L, R, "eqtmp");
+  case NE:
+    return ctx.Builder.CreateICmpNE(L, R, "netmp");
+  }
+  throw InternalError("Invalid binary operator: " + getOpText());
 }
 
 /*
- * First lookup the variable in the symbol table for names and
- * if that fails, then look in the symbol table for functions.
- *
- * This relies on the fact that TIP programs have been checked to
- * ensure that names obey the scope rules.
+ * The symbol table bound the name to a local or parameter, whose alloca is
+ * in its slot, or to a function, whose slot is its index in the table.
  */
-llvm::Value* ASTVariableExpr::codegen() {
-  auto nv = NamedValues.find(getName());
-  if (nv != NamedValues.end()) {
-    if (lValueGen) {
-      return NamedValues[nv->first];
-    } else {
-      return Builder.CreateLoad(nv->second, getName().c_str());
-    }
+llvm::Value* ASTVariableExpr::codegen(CodeGenContext &ctx) {
+  if (getDecl() == nullptr) {
+    throw InternalError("Unknown variable name: " + getName());
   }
 
-  auto fidx = functionIndex.find(getName());
-  if (fidx == functionIndex.end()) {
-    throw InternalError("Unknown variable name: " + getName());
+  if (isFunction()) {
+    return ConstantInt::get(Type::getInt64Ty(ctx.TheContext), getSlot());
   }
 
-  return ConstantInt::get(Type::getInt64Ty(TheContext), fidx->second);
+  auto *local = ctx.Locals[getSlot()];
+  if (ctx.lValueGen) {
+    return local;
+  }
+  return ctx.Builder.CreateLoad(local, getName().c_str());
 }
 
-llvm::Value* ASTInputExpr::codegen() {
-  if (inputIntrinsic == nullptr) {
-    auto *FT = FunctionType::get(Type::getInt64Ty(TheContext), false);
-    inputIntrinsic = llvm::Function::Create(FT, llvm::Function::ExternalLinkage,
-                                            "_tip_input", CurrentModule.get());
+llvm::Value* ASTInputExpr::codegen(CodeGenContext &ctx) {
+  if (ctx.inputIntrinsic == nullptr) {
+    auto *FT = FunctionType::get(Type::getInt64Ty(ctx.TheContext), false);
+    ctx.inputIntrinsic = llvm::Function::Create(FT, llvm::Function::ExternalLinkage,
+                                            "_tip_input", ctx.CurrentModule.get());
   }
-  return Builder.CreateCall(inputIntrinsic);
+  return ctx.Builder.CreateCall(ctx.inputIntrinsic);
 }
 
 /*
  * Function application in TIP can either be through explicitly named
  * functions or through expressions that evaluate to a function reference.
- * We consolidate these two cases by binding function names to values
- * and then using those values, which may flow through the program as function
- * references, to index into a function dispatch table to invoke the function.
+ * Calls to a named function are direct, which lets LLVM inline them.  For
+ * the other calls we bind function names to values and then use those
+ * values, which may flow through the program as function references, to
+ * index into a function dispatch table to invoke the function.
  *
  * The function name values and table are setup in a shallow-pass over
  * functions performed during codegen for the Program.
  */
-llvm::Value* ASTFunAppExpr::codegen() {
+llvm::Value* ASTFunAppExpr::codegen(CodeGenContext &ctx) {
+  // The callee may allocate
+  ctx.gcMayCollect = true;
+
+  // Compute the actual parameters
+  auto generateActuals = [&]() {
+    std::vector<Value *> argsV;
+    for (auto const &arg : getActuals()) {
+      Value *argVal = arg->codegen(ctx);
+      if (argVal == nullptr) {
+        throw InternalError("failed to generate bitcode for the argument");
+      }
+      argsV.push_back(argVal);
+
+      // Evaluating the remaining actuals may collect
+      if (argsV.size() < getActuals().size()) {
+        ctx.PushGCTemp(argVal);
+      }
+    }
+    for (int i = 1; i < argsV.size(); i++) {
+      ctx.PopGCTemp();
+    }
+    return argsV;
+  };
+
+  /*
+   * A function name that does not refer to a local is a known callee.  Main
+   * takes its parameters as inputs, so calls to it with arguments still go
+   * through the table.
+   */
+  if (auto *name = dynamic_cast<ASTVariableExpr*>(getFunction())) {
+    if (name->isFunction()) {
+      auto *callee = ctx.getFunction(ctx.program->getFunctions()[name->getSlot()]);
+      if (callee->arg_size() == getActuals().size()) {
+        return ctx.Builder.CreateCall(callee, generateActuals(), "calltmp");
+      }
+    }
+  }
+
   /*
    * Evaluate the function expression - it will resolve to an integer value
    * whether it is a function literal or an expression.
    */
-  auto *funVal = getFunction()->codegen();
+  auto *funVal = getFunction()->codegen(ctx);
   if (funVal == nullptr) {
     throw InternalError("failed to generate bitcode for the function");
   }
@@ -527,12 +483,12 @@ llvm::Value* ASTFunAppExpr::codegen() {
    * pointer to be called.
    */
   std::vector<Value *> indices;
-  indices.push_back(zeroV); 
+  indices.push_back(ctx.zeroV); 
   indices.push_back(funVal);
-  auto *gep = Builder.CreateInBoundsGEP(tipFTable, indices, "ftableidx");
+  auto *gep = ctx.Builder.CreateInBoundsGEP(ctx.tipFTable, indices, "ftableidx");
 
   // Load the function pointer
-  auto *genericFunPtr = Builder.CreateLoad(gep, "genfptr");
+  auto *genericFunPtr = ctx.Builder.CreateLoad(gep, "genfptr");
 
   /*
    * Compute the specific function pointer type based on the actual parameter
@@ -543,51 +499,40 @@ llvm::Value* ASTFunAppExpr::codegen() {
    * Once type information is available we will need to iterate the actuals
    * and construct the per actual vector of types.
    */
-  std::vector<Type *> actualTypes(getActuals().size(), Type::getInt64Ty(TheContext));
-  auto *funType = FunctionType::get(Type::getInt64Ty(TheContext), actualTypes, false);
+  std::vector<Type *> actualTypes(getActuals().size(), Type::getInt64Ty(ctx.TheContext));
+  auto *funType = FunctionType::get(Type::getInt64Ty(ctx.TheContext), actualTypes, false);
   auto *funPtrType = PointerType::get(funType, 0);
 
 
   // Bitcast the function pointer to the call-site determined function type
   auto *castFunPtr =
-      Builder.CreatePointerCast(genericFunPtr, funPtrType, "castfptr");
-
-  // Compute the actual parameters
-  std::vector<Value *> argsV;
-  for (auto const &arg : getActuals()) {
-    Value *argVal = arg->codegen();
-    if (argVal == nullptr) {
-      throw InternalError("failed to generate bitcode for the argument");
-    }
-    argsV.push_back(argVal);
-  }
+      ctx.Builder.CreatePointerCast(genericFunPtr, funPtrType, "castfptr");
 
-  return Builder.CreateCall(funType, castFunPtr, argsV, "calltmp");
+  return ctx.Builder.CreateCall(funType, castFunPtr, generateActuals(), "calltmp");
 }
 
-llvm::Value* ASTAllocExpr::codegen() {
-  Value *argVal = getInitializer()->codegen();
+llvm::Value* ASTAllocExpr::codegen(CodeGenContext &ctx) {
+  Value *argVal = getInitializer()->codegen(ctx);
   if (argVal == nullptr) {
     throw InternalError("failed to generate bitcode for the initializer of the alloc expression");
   }
 
-  // Since we do not support records all allocs are for 8 bytes, i.e., int64_t
-  std::vector<Value *> twoArg;
-  twoArg.push_back(ConstantInt::get(Type::getInt64Ty(TheContext), 1));
-  twoArg.push_back(ConstantInt::get(Type::getInt64Ty(TheContext), 8));
-  auto *allocInst = Builder.CreateCall(callocFun, twoArg, "allocPtr");
-  auto *castPtr = Builder.CreatePointerCast(
-      allocInst, Type::getInt64PtrTy(TheContext), "castPtr");
+  // All allocs are for 8 bytes, i.e., int64_t, which may hold a reference
+  ctx.PushGCTemp(argVal);
+  auto *allocInst = ctx.CreateHeapAlloc(8, 1, "allocPtr");
+  ctx.PopGCTemp();
+  auto *castPtr = ctx.Builder.CreatePointerCast(
+      allocInst, Type::getInt64PtrTy(ctx.TheContext), "castPtr");
   // Initialize with argument
-  auto *initializingStore = Builder.CreateStore(argVal, castPtr);
+  auto *initializingStore = ctx.Builder.CreateStore(argVal, castPtr);
 
-  return Builder.CreatePtrToInt(castPtr, Type::getInt64Ty(TheContext),
+  return ctx.Builder.CreatePtrToInt(castPtr, Type::getInt64Ty(ctx.TheContext),
                                 "allocIntVal");
 }
 
-llvm::Value* ASTNullExpr::codegen() {
-  auto *nullPtr = ConstantPointerNull::get(Type::getInt64PtrTy(TheContext));
-  return Builder.CreatePtrToInt(nullPtr, Type::getInt64Ty(TheContext),
+llvm::Value* ASTNullExpr::codegen(CodeGenContext &ctx) {
+  auto *nullPtr = ConstantPointerNull::get(Type::getInt64PtrTy(ctx.TheContext));
+  return ctx.Builder.CreatePtrToInt(nullPtr, Type::getInt64Ty(ctx.TheContext),
                                 "nullPtrIntVal");
 }
 
@@ -597,16 +542,16 @@ llvm::Value* ASTNullExpr::codegen() {
  * This is checked in the weeding pass.  
  *
  */
-llvm::Value* ASTRefExpr::codegen() {
-  lValueGen = true;
-  Value *lValue = getVar()->codegen();
-  lValueGen = false;
+llvm::Value* ASTRefExpr::codegen(CodeGenContext &ctx) {
+  ctx.lValueGen = true;
+  Value *lValue = getVar()->codegen(ctx);
+  ctx.lValueGen = false;
 
   if (lValue == nullptr) {
     throw InternalError("could not generate l-value for address of");
   }
 
-  return Builder.CreatePtrToInt(lValue, Type::getInt64Ty(TheContext), "addrOfPtr");
+  return ctx.Builder.CreatePtrToInt(lValue, Type::getInt64Ty(ctx.TheContext), "addrOfPtr");
 }
 
 /* '*' dereference expression
@@ -616,73 +561,84 @@ llvm::Value* ASTRefExpr::codegen() {
  * Consequently, we convert the value with "inttoptr" before loading
  * the value at the pointed-to memory location.
  */
-llvm::Value* ASTDeRefExpr::codegen() {
-  bool isLValue = lValueGen;
+llvm::Value* ASTDeRefExpr::codegen(CodeGenContext &ctx) {
+  bool isLValue = ctx.lValueGen;
 
   if (isLValue) {
     // This flag is reset here so that sub-expressions are treated as r-values
-    lValueGen = false;
+    ctx.lValueGen = false;
   }
  
-  Value *argVal = getPtr()->codegen();
+  Value *argVal = getPtr()->codegen(ctx);
   if (argVal == nullptr) {
     throw InternalError("failed to generate bitcode for the pointer");
   }
 
   // compute the address
-  Value *address = Builder.CreateIntToPtr(argVal, Type::getInt64PtrTy(TheContext), "ptrIntVal");
+  Value *address = ctx.Builder.CreateIntToPtr(argVal, Type::getInt64PtrTy(ctx.TheContext), "ptrIntVal");
 
   if (isLValue) {
     // For an l-value, return the address
     return address;
   } else {
     // For an r-value, return the value at the address
-    return Builder.CreateLoad(address, "valueAt");
+    return ctx.Builder.CreateLoad(address, "valueAt");
   }
 }
 
 /* {field1 : val1, ..., fieldN, valN} record expression
  *
- * Builds an instance of the UberRecord using the declared fields
+ * Builds an instance of the record layout computed for the expression
  */
-llvm::Value* ASTRecordExpr::codegen() {
-  //Allocate the a pointer to an uber record
-  auto *allocaRecord = Builder.CreateAlloca(ptrToUberRecordType);
-
-  // Use Builder to create the calloc call using pre-defined callocFun
-  auto sizeOfUberRecord = CurrentModule->getDataLayout().getStructLayout(uberRecordType)->getSizeInBytes();
-  std::vector<Value *> callocArgs;
-  callocArgs.push_back(oneV); 
-  callocArgs.push_back(ConstantInt::get(Type::getInt64Ty(TheContext), sizeOfUberRecord));
-  auto *calloc = Builder.CreateCall(callocFun, callocArgs, "callocedPtr");
+llvm::Value* ASTRecordExpr::codegen(CodeGenContext &ctx) {
+  auto layout = ctx.recordLayouts->getLayout(this);
+  auto *recordType = ctx.getRecordType(layout);
+  auto *ptrToRecordType = PointerType::get(recordType, 0);
+
+  //Allocate the a pointer to a record
+  auto *allocaRecord = ctx.Builder.CreateAlloca(ptrToRecordType);
+
+  // Allocate the record on the heap, slots beyond the 61st share a bit
+  uint64_t references = 0;
+  auto &slotReferences = ctx.recordLayouts->getReferences(layout);
+  for (int i = 0; i < slotReferences.size(); i++) {
+    if (slotReferences[i]) {
+      references |= uint64_t(1) << std::min(i, 61);
+    }
+  }
+  auto sizeOfRecord = ctx.CurrentModule->getDataLayout().getStructLayout(recordType)->getSizeInBytes();
+  auto *heapPtr = ctx.CreateHeapAlloc(sizeOfRecord, references, "recordPtr");
 
-  //Bitcast the calloc call to theStruct Type
-  auto *recordPtr = Builder.CreatePointerCast(calloc, ptrToUberRecordType, "recordCalloc");
+  //Bitcast the heap memory to theStruct Type
+  auto *recordPtr = ctx.Builder.CreatePointerCast(heapPtr, ptrToRecordType, "recordAlloc");
 
   //Store the ptr to the record in the record alloc
-  Builder.CreateStore(recordPtr, allocaRecord);
+  ctx.Builder.CreateStore(recordPtr, allocaRecord);
+  ctx.PushGCTemp(recordPtr);
 
   //Load allocaRecord
-  auto loadInst = Builder.CreateLoad(ptrToUberRecordType,allocaRecord);
+  auto loadInst = ctx.Builder.CreateLoad(ptrToRecordType,allocaRecord);
 
-  //For each field, generate GEP for location of field in the uberRecord
+  //For each field, generate GEP for location of field in the record
   //Generate the code for the field and store it in the GEP
   for(auto const &field : getFields()){
-      auto *gep = Builder.CreateStructGEP(uberRecordType, loadInst, fieldIndex[field->getField()], field->getField());
-      auto value = field->codegen();
-      Builder.CreateStore(value, gep);
+      auto index = ctx.getFieldIndex(layout, field->getField());
+      auto *gep = ctx.Builder.CreateStructGEP(recordType, loadInst, index, field->getField());
+      auto value = field->codegen(ctx);
+      ctx.Builder.CreateStore(value, gep);
   }
+  ctx.PopGCTemp();
 
   //Return int64 pointer to the record
-  return Builder.CreatePtrToInt(recordPtr, Type::getInt64Ty(TheContext), "recordPtr");
+  return ctx.Builder.CreatePtrToInt(recordPtr, Type::getInt64Ty(ctx.TheContext), "recordPtr");
 }
 
 /* field : val field expression
  *
  * Expression for generating the code for the value of a field
  */
-llvm::Value* ASTFieldExpr::codegen() {
-  return this->getInitializer()->codegen();
+llvm::Value* ASTFieldExpr::codegen(CodeGenContext &ctx) {
+  return this->getInitializer()->codegen(ctx);
 }
 
 /* record.field Access Expression
@@ -690,29 +646,29 @@ llvm::Value* ASTFieldExpr::codegen() {
  * In an l-value context this returns the location of the field being accessed
  * In an r-value context this returns the value of the field being accessed
  */
-llvm::Value* ASTAccessExpr::codegen() {
-    bool isLValue = lValueGen;
+llvm::Value* ASTAccessExpr::codegen(CodeGenContext &ctx) {
+    bool isLValue = ctx.lValueGen;
 
     if (isLValue) {
         // This flag is reset here so that sub-expressions are treated as r-values
-        lValueGen = false;
+        ctx.lValueGen = false;
     }
 
-    //Get current field and check if it exists
+    //Get current field and check if it exists in the layout of the record
     auto currField = this->getField();
-    if(fieldIndex.count(currField) == 0){
+    auto layout = ctx.recordLayouts->getLayout(this);
+    auto index = ctx.getFieldIndex(layout, currField);
+    if(index < 0){
       throw InternalError("This field doesn't exist");
     }
+    auto *recordType = ctx.getRecordType(layout);
 
   //Generate record instruction address
-  Value *recordVal = this->getRecord()->codegen();
-  Value *recordAddress = Builder.CreateIntToPtr(recordVal, ptrToUberRecordType);
-
-  //Generate the field index
-  auto index = fieldIndex[currField];
+  Value *recordVal = this->getRecord()->codegen(ctx);
+  Value *recordAddress = ctx.Builder.CreateIntToPtr(recordVal, PointerType::get(recordType, 0));
 
   //Generate the location of the field
-  auto *gep = Builder.CreateStructGEP(uberRecordType, recordAddress, index, currField);
+  auto *gep = ctx.Builder.CreateStructGEP(recordType, recordAddress, index, currField);
 
   //If LHS, return location of field
   if(isLValue){
@@ -720,64 +676,74 @@ llvm::Value* ASTAccessExpr::codegen() {
   }
 
   //Load value at GEP and return it
-  auto fieldLoad = Builder.CreateLoad(IntegerType::getInt64Ty(TheContext), gep);
-  return Builder.CreatePtrToInt(fieldLoad, Type::getInt64Ty(TheContext), "fieldAccess");
+  auto fieldLoad = ctx.Builder.CreateLoad(IntegerType::getInt64Ty(ctx.TheContext), gep);
+  return ctx.Builder.CreatePtrToInt(fieldLoad, Type::getInt64Ty(ctx.TheContext), "fieldAccess");
 }
 
-llvm::Value* ASTDeclNode::codegen() {
+llvm::Value* ASTDeclNode::codegen(CodeGenContext &ctx) {
   throw InternalError("Declarations do not emit code");
 }
 
-llvm::Value* ASTDeclStmt::codegen() {
+llvm::Value* ASTDeclStmt::codegen(CodeGenContext &ctx) {
   // The LLVM builder records the function we are currently generating
-  llvm::Function *TheFunction = Builder.GetInsertBlock()->getParent();
+  llvm::Function *TheFunction = ctx.Builder.GetInsertBlock()->getParent();
 
   AllocaInst *localAlloca = nullptr;
 
   // Register all variables and emit their initializer.
   for (auto l : getVars()) {
-    localAlloca = CreateEntryBlockAlloca(TheFunction, l->getName());
+    localAlloca = ctx.CreateEntryBlockAlloca(TheFunction, l->getName());
 
     // Initialize all locals to "0"
-    Builder.CreateStore(zeroV, localAlloca);
+    ctx.Builder.CreateStore(ctx.zeroV, localAlloca);
 
-    // Remember this binding.
-    NamedValues[l->getName()] = localAlloca;
+    // Remember the alloca in the slot of the local.
+    ctx.Locals.push_back(localAlloca);
+    ctx.AddGCRoot(l, localAlloca);
   }
 
   // Return the body computation.
   return localAlloca;
 }
 
-llvm::Value* ASTAssignStmt::codegen() {
+llvm::Value* ASTAssignStmt::codegen(CodeGenContext &ctx) {
   // trigger code generation for l-value expressions
-  lValueGen = true;
-  Value *lValue = getLHS()->codegen();
-  lValueGen = false;
+  ctx.lValueGen = true;
+  Value *lValue = getLHS()->codegen(ctx);
+  ctx.lValueGen = false;
 
   if (lValue == nullptr) {
     throw InternalError("failed to generate bitcode for the lhs of the assignment");
   }
 
-  Value *rValue = getRHS()->codegen();
+  // The location may be in a heap object only reachable from here
+  bool heapLocation = !isa<AllocaInst>(lValue);
+  if (heapLocation) {
+    ctx.PushGCTemp(lValue);
+  }
+
+  Value *rValue = getRHS()->codegen(ctx);
   if (rValue == nullptr) {
     throw InternalError("failed to generate bitcode for the rhs of the assignment");
   }
+  if (heapLocation) {
+    ctx.PopGCTemp();
+  }
 
-  return Builder.CreateStore(rValue, lValue);
+  return ctx.Builder.CreateStore(rValue, lValue);
 }
 
 
 
-llvm::Value* ASTBlockStmt::codegen() {
+llvm::Value* ASTBlockStmt::codegen(CodeGenContext &ctx) {
   Value *lastStmt = nullptr;
 
   for (auto const &s : getStmts()) {
-    lastStmt = s->codegen();
+    lastStmt = s->codegen(ctx);
   }
 
   // If the block was empty return a nop
-  return (lastStmt == nullptr) ? Builder.CreateCall(nop) : lastStmt;
+  return (lastStmt == nullptr) ? ctx.Builder.CreateCall(ctx.nop) : lastStmt;
 }
 
 /*
@@ -797,8 +763,8 @@ llvm::Value* ASTBlockStmt::codegen() {
  * is generated into a basic block since it will be branched to after the
  * body executes.
  */
-llvm::Value* ASTWhileStmt::codegen() {
-  llvm::Function *TheFunction = Builder.GetInsertBlock()->getParent();
+llvm::Value* ASTWhileStmt::codegen(CodeGenContext &ctx) {
+  llvm::Function *TheFunction = ctx.Builder.GetInsertBlock()->getParent();
 
   /*
    * Create blocks for the loop header, body, and exit; HeaderBB is first
@@ -808,50 +774,50 @@ llvm::Value* ASTWhileStmt::codegen() {
    * any particular way because we will explicitly branch between them.
    * This can be optimized by later passes.
    */
-  labelNum++; // create unique labels for these BBs
+  ctx.labelNum++; // create unique labels for these BBs
 
   BasicBlock *HeaderBB = BasicBlock::Create(
-      TheContext, "header" + std::to_string(labelNum), TheFunction);
+      ctx.TheContext, "header" + std::to_string(ctx.labelNum), TheFunction);
   BasicBlock *BodyBB =
-      BasicBlock::Create(TheContext, "body" + std::to_string(labelNum));
+      BasicBlock::Create(ctx.TheContext, "body" + std::to_string(ctx.labelNum));
   BasicBlock *ExitBB =
-      BasicBlock::Create(TheContext, "exit" + std::to_string(labelNum));
+      BasicBlock::Create(ctx.TheContext, "exit" + std::to_string(ctx.labelNum));
 
   // Add an explicit branch from the current BB to the header
-  Builder.CreateBr(HeaderBB);
+  ctx.Builder.CreateBr(HeaderBB);
 
   // Emit loop header
   {
-    Builder.SetInsertPoint(HeaderBB);
+    ctx.Builder.SetInsertPoint(HeaderBB);
 
-    Value *CondV = getCondition()->codegen();
+    Value *CondV = getCondition()->codegen(ctx);
     if (CondV == nullptr) {
       throw InternalError("failed to generate bitcode for the conditional");
     }
 
     // Convert condition to a bool by comparing non-equal to 0.
-    CondV = Builder.CreateICmpNE(CondV, ConstantInt::get(CondV->getType(), 0), "loopcond");
+    CondV = ctx.Builder.CreateICmpNE(CondV, ConstantInt::get(CondV->getType(), 0), "loopcond");
 
-    Builder.CreateCondBr(CondV, BodyBB, ExitBB);
+    ctx.Builder.CreateCondBr(CondV, BodyBB, ExitBB);
   }
 
   // Emit loop body
   {
     TheFunction->getBasicBlockList().push_back(BodyBB);
-    Builder.SetInsertPoint(BodyBB);
+    ctx.Builder.SetInsertPoint(BodyBB);
 
-    Value *BodyV = getBody()->codegen();
+    Value *BodyV = getBody()->codegen(ctx);
     if (BodyV == nullptr) {
       throw InternalError("failed to generate bitcode for the loop body");
     }
 
-    Builder.CreateBr(HeaderBB);
+    ctx.Builder.CreateBr(HeaderBB);
   }
 
   // Emit loop exit block.
   TheFunction->getBasicBlockList().push_back(ExitBB);
-  Builder.SetInsertPoint(ExitBB);
-  return Builder.CreateCall(nop);
+  ctx.Builder.SetInsertPoint(ExitBB);
+  return ctx.Builder.CreateCall(ctx.nop);
 }
 
 /*
@@ -869,16 +835,16 @@ llvm::Value* ASTWhileStmt::codegen() {
  * the insertion point, and then letting other codegen functions write
  * code at that insertion point.
  */
-llvm::Value* ASTIfStmt::codegen() {
-  Value *CondV = getCondition()->codegen();
+llvm::Value* ASTIfStmt::codegen(CodeGenContext &ctx) {
+  Value *CondV = getCondition()->codegen(ctx);
   if (CondV == nullptr) {
     throw InternalError("failed to generate bitcode for the condition of the if statement");
   }
 
   // Convert condition to a bool by comparing non-equal to 0.
-  CondV = Builder.CreateICmpNE(CondV, ConstantInt::get(CondV->getType(), 0), "ifcond");
+  CondV = ctx.Builder.CreateICmpNE(CondV, ConstantInt::get(CondV->getType(), 0), "ifcond");
 
-  llvm::Function *TheFunction = Builder.GetInsertBlock()->getParent();
+  llvm::Function *TheFunction = ctx.Builder.GetInsertBlock()->getParent();
 
   /*
    * Create blocks for the then and else cases.  The then block is first so
@@ -890,91 +856,92 @@ llvm::Value* ASTIfStmt::codegen() {
    * any particular way because we will explicitly branch between them.
    * This can be optimized to fall through behavior by later passes.
    */
-  labelNum++; // create unique labels for these BBs
+  ctx.labelNum++; // create unique labels for these BBs
   BasicBlock *ThenBB = BasicBlock::Create(
-      TheContext, "then" + std::to_string(labelNum), TheFunction);
+      ctx.TheContext, "then" + std::to_string(ctx.labelNum), TheFunction);
   BasicBlock *ElseBB =
-      BasicBlock::Create(TheContext, "else" + std::to_string(labelNum));
+      BasicBlock::Create(ctx.TheContext, "else" + std::to_string(ctx.labelNum));
   BasicBlock *MergeBB =
-      BasicBlock::Create(TheContext, "ifmerge" + std::to_string(labelNum));
+      BasicBlock::Create(ctx.TheContext, "ifmerge" + std::to_string(ctx.labelNum));
 
-  Builder.CreateCondBr(CondV, ThenBB, ElseBB);
+  ctx.Builder.CreateCondBr(CondV, ThenBB, ElseBB);
 
   // Emit then block.
   {
-    Builder.SetInsertPoint(ThenBB);
+    ctx.Builder.SetInsertPoint(ThenBB);
 
-    Value *ThenV = getThen()->codegen();
+    Value *ThenV = getThen()->codegen(ctx);
     if (ThenV == nullptr) {
       throw InternalError("failed to generate bitcode for the then block");
     }
 
-    Builder.CreateBr(MergeBB);
+    ctx.Builder.CreateBr(MergeBB);
   }
 
   // Emit else block.
   {
     TheFunction->getBasicBlockList().push_back(ElseBB);
-    Builder.SetInsertPoint(ElseBB);
+    ctx.Builder.SetInsertPoint(ElseBB);
 
     // if there is no ELSE then exist emit a "nop"
     Value *ElseV = nullptr;
     if (getElse() != nullptr) {
-      ElseV = getElse()->codegen();
+      ElseV = getElse()->codegen(ctx);
       if (ElseV == nullptr) {
         throw InternalError("failed to generate bitcode for the else block");
       }
     } else {
-      Builder.CreateCall(nop);
+      ctx.Builder.CreateCall(ctx.nop);
     }
 
-    Builder.CreateBr(MergeBB);
+    ctx.Builder.CreateBr(MergeBB);
   }
 
   // Emit merge block.
   TheFunction->getBasicBlockList().push_back(MergeBB);
-  Builder.SetInsertPoint(MergeBB);
-  return Builder.CreateCall(nop);
+  ctx.Builder.SetInsertPoint(MergeBB);
+  return ctx.Builder.CreateCall(ctx.nop);
 }
 
-llvm::Value* ASTOutputStmt::codegen() {
-  if (outputIntrinsic == nullptr) {
-    std::vector<Type *> oneInt(1, Type::getInt64Ty(TheContext));
-    auto *FT = FunctionType::get(Type::getInt64Ty(TheContext), oneInt, false);
-    outputIntrinsic =
+llvm::Value* ASTOutputStmt::codegen(CodeGenContext &ctx) {
+  if (ctx.outputIntrinsic == nullptr) {
+    std::vector<Type *> oneInt(1, Type::getInt64Ty(ctx.TheContext));
+    auto *FT = FunctionType::get(Type::getInt64Ty(ctx.TheContext), oneInt, false);
+    ctx.outputIntrinsic =
         llvm::Function::Create(FT, llvm::Function::ExternalLinkage,
-                               "_tip_output", CurrentModule.get());
+                               "_tip_output", ctx.CurrentModule.get());
   }
 
-  Value *argVal = getArg()->codegen();
+  Value *argVal = getArg()->codegen(ctx);
   if (argVal == nullptr) {
     throw InternalError("failed to generate bitcode for the argument of the output statement");
   }
 
   std::vector<Value *> ArgsV(1, argVal);
 
-  return Builder.CreateCall(outputIntrinsic, ArgsV);
+  return ctx.Builder.CreateCall(ctx.outputIntrinsic, ArgsV);
 }
 
-llvm::Value* ASTErrorStmt::codegen() {
-  if (errorIntrinsic == nullptr) {
-    std::vector<Type *> oneInt(1, Type::getInt64Ty(TheContext));
-    auto *FT = FunctionType::get(Type::getInt64Ty(TheContext), oneInt, false);
-    errorIntrinsic = llvm::Function::Create(FT, llvm::Function::ExternalLinkage,
-                                            "_tip_error", CurrentModule.get());
+llvm::Value* ASTErrorStmt::codegen(CodeGenContext &ctx) {
+  if (ctx.errorIntrinsic == nullptr) {
+    std::vector<Type *> oneInt(1, Type::getInt64Ty(ctx.TheContext));
+    auto *FT = FunctionType::get(Type::getInt64Ty(ctx.TheContext), oneInt, false);
+    ctx.errorIntrinsic = llvm::Function::Create(FT, llvm::Function::ExternalLinkage,
+                                            "_tip_error", ctx.CurrentModule.get());
   }
 
-  Value *argVal = getArg()->codegen();
+  Value *argVal = getArg()->codegen(ctx);
   if (argVal == nullptr) {
     throw InternalError("failed to generate bitcode for the argument of the error statement");
   }
 
   std::vector<Value *> ArgsV(1, argVal);
 
-  return Builder.CreateCall(errorIntrinsic, ArgsV);
+  return ctx.Builder.CreateCall(ctx.errorIntrinsic, ArgsV);
 }
 
-llvm::Value* ASTReturnStmt::codegen() {
-  Value *argVal = getArg()->codegen();
-  return Builder.CreateRet(argVal);
+llvm::Value* ASTReturnStmt::codegen(CodeGenContext &ctx) {
+  Value *argVal = getArg()->codegen(ctx);
+  ctx.CreateGCFramePop();
+  return ctx.Builder.CreateRet(argVal);
 }
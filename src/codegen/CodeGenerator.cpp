@@ -1,13 +1,226 @@
 #include "CodeGenerator.h"
+#include "FunctionGraph.h"
+#include "InternalError.h"
+#include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/Linker/Linker.h"
+#include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Target/TargetOptions.h"
+#include "llvm/Transforms/IPO/Internalize.h"
+#include "loguru.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <thread>
 
 using namespace llvm;
 
+#ifdef TIP_EMBED_RUNTIME
+// The bitcode of the runtime library, generated from rtlib/tip_rtlib.c by the build
+extern const unsigned char tipRuntimeBitcode[];
+extern const std::size_t tipRuntimeBitcodeSize;
+#endif
+
 std::unique_ptr<Module> CodeGenerator::generate(ASTProgram* program, 
-                                SemanticAnalysis* analysisResults, std::string fileName) {
-  return std::move(program->codegen(analysisResults, fileName));
+                                SemanticAnalysis* analysisResults, std::string fileName,
+                                LLVMContext &context, bool gc) {
+  return std::move(program->codegen(analysisResults, fileName, context, gc));
+}
+
+namespace {
+
+/*
+ * Generate a partition in a private context, transform it and return its
+ * bitcode.  Safe to call on several threads at once.
+ */
+SmallVector<char, 0> generatePartition(ASTProgram* program, SemanticAnalysis* analysisResults,
+                                       const std::string &fileName,
+                                       const std::vector<ASTFunction*> &partition,
+                                       bool definesGlobals, bool gc, bool declareAll,
+                                       const std::function<void(Module*)> &transform) {
+  LLVMContext partContext;
+  auto m = program->codegenPartition(analysisResults, fileName, partContext, partition,
+                                     definesGlobals, gc, declareAll);
+  if (transform) {
+    transform(m.get());
+  }
+  SmallVector<char, 0> bitcode;
+  raw_svector_ostream os(bitcode);
+  WriteBitcodeToFile(*m, os);
+  return bitcode;
+}
+
+// Run the task for every index on up to jobs threads and rethrow the first failure.
+void forEachParallel(std::size_t count, unsigned jobs, const std::function<void(std::size_t)> &task) {
+  std::atomic<std::size_t> next{0};
+  std::vector<std::exception_ptr> errors(count);
+  std::vector<std::thread> workers;
+  for (unsigned w = 0; w < std::max(1u, std::min<unsigned>(jobs, count)); w++) {
+    workers.emplace_back([&] {
+      for (auto i = next++; i < count; i = next++) {
+        try {
+          task(i);
+        } catch (...) {
+          errors[i] = std::current_exception();
+        }
+      }
+    });
+  }
+  for (auto &w : workers) {
+    w.join();
+  }
+  for (auto &e : errors) {
+    if (e) {
+      std::rethrow_exception(e);
+    }
+  }
+}
+
+// Link the partitions in order so that the output does not depend on scheduling.
+std::unique_ptr<Module> linkPartitions(std::vector<SmallVector<char, 0>> &bitcode,
+                                       const std::string &fileName, LLVMContext &context) {
+  std::unique_ptr<Module> linked;
+  for (auto &b : bitcode) {
+    auto m = parseBitcodeFile(MemoryBufferRef(StringRef(b.data(), b.size()), fileName), context);
+    if (!m) {
+      throw InternalError("failed to read generated module: " + toString(m.takeError()));
+    }
+    if (!linked) {
+      linked = std::move(*m);
+    } else if (Linker::linkModules(*linked, std::move(*m))) {
+      throw InternalError("failed to link generated modules");
+    }
+  }
+  linked->setSourceFileName(fileName);
+
+  // The dispatch table was only exported so the partitions could share it
+  linked->getGlobalVariable("_tip_ftable")->setLinkage(GlobalValue::InternalLinkage);
+
+  return linked;
+}
+
+// Inferred types are computed on first use, which must not race
+void computeInferredTypes(SemanticAnalysis* analysisResults) {
+  auto symbols = analysisResults->getSymbolTable();
+  for (auto f : symbols->getFunctions()) {
+    for (auto l : symbols->getLocals(f)) {
+      analysisResults->getTypeResults()->getInferredType(l);
+    }
+  }
+}
+
+/*
+ * The partitions are the groups of mutually recursive functions in the order
+ * of the program, file by file, preceded by an empty partition that defines
+ * the shared globals.
+ */
+std::vector<std::vector<ASTFunction*>> groupPartitions(ASTProgram* program) {
+  FunctionGraphCreator graph{ program };
+  auto queue = graph.InverseTopoSort();
+  std::map<int, std::vector<ASTFunction*>> ordered;
+  while (!queue.empty()) {
+    ordered.emplace(queue.front()->GetSourceIndex(), queue.front()->GetFuncsInSourceOrder());
+    queue.pop();
+  }
+  std::vector<std::vector<ASTFunction*>> groups { std::vector<ASTFunction*>() };
+  for (auto &group : ordered) {
+    groups.push_back(std::move(group.second));
+  }
+  return groups;
+}
+
+}
+
+/*
+ * Modules can only be linked within a single LLVM context, but contexts are
+ * not thread safe.  Each partition is therefore generated in a private
+ * context on its worker thread and handed back as bitcode, which is read
+ * into the destination context before linking.
+ */
+std::unique_ptr<Module> CodeGenerator::generate(ASTProgram* program,
+                                SemanticAnalysis* analysisResults, std::string fileName,
+                                LLVMContext &context, unsigned jobs,
+                                std::function<void(Module*)> transform, bool gc,
+                                CodeGenCache* cache) {
+  if (cache != nullptr) {
+    return generateCached(program, analysisResults, fileName, context, jobs, transform, gc, *cache);
+  }
+
+  auto functions = program->getFunctions();
+  auto numParts = std::max<std::size_t>(1, std::min<std::size_t>(jobs, functions.size()));
+
+  if (numParts == 1) {
+    auto m = generate(program, analysisResults, fileName, context, gc);
+    if (transform) {
+      transform(m.get());
+    }
+    return m;
+  }
+
+  LOG_S(1) << "Generating " << functions.size() << " functions in " << numParts << " partitions";
+
+  if (gc) {
+    computeInferredTypes(analysisResults);
+  }
+
+  std::vector<SmallVector<char, 0>> bitcode(numParts);
+  forEachParallel(numParts, numParts, [&](std::size_t p) {
+    std::vector<ASTFunction*> partition(functions.begin() + p * functions.size() / numParts,
+                                        functions.begin() + (p + 1) * functions.size() / numParts);
+    bitcode[p] = generatePartition(program, analysisResults, fileName, partition, p == 0, gc, true, transform);
+  });
+
+  return linkPartitions(bitcode, fileName, context);
+}
+
+/*
+ * The keys of all partitions are computed up front, which also computes
+ * the inferred types they depend on before any worker thread starts.  Only
+ * the partitions missing from the cache are generated.  There is one per
+ * function group, so they only declare what they use to keep the cost of
+ * each proportional to the size of its group.
+ */
+std::unique_ptr<Module> CodeGenerator::generateCached(ASTProgram* program,
+                                SemanticAnalysis* analysisResults, std::string fileName,
+                                LLVMContext &context, unsigned jobs,
+                                std::function<void(Module*)> transform, bool gc,
+                                CodeGenCache &cache) {
+  auto partitions = groupPartitions(program);
+  if (gc) {
+    computeInferredTypes(analysisResults);
+  }
+
+  auto keys = cache.keys(program, analysisResults, partitions, gc);
+  std::vector<SmallVector<char, 0>> bitcode(partitions.size());
+  std::vector<std::size_t> missing;
+  for (std::size_t p = 0; p < partitions.size(); p++) {
+    if (!cache.lookup(keys[p], bitcode[p])) {
+      missing.push_back(p);
+    }
+  }
+
+  LOG_S(1) << "Generating " << missing.size() << " of " << partitions.size() << " partitions, "
+           << "the others are cached";
+
+  forEachParallel(missing.size(), jobs, [&](std::size_t i) {
+    auto p = missing[i];
+    bitcode[p] = generatePartition(program, analysisResults, fileName, partitions[p], p == 0, gc, false, transform);
+    cache.store(keys[p], StringRef(bitcode[p].data(), bitcode[p].size()));
+  });
+
+  return linkPartitions(bitcode, fileName, context);
 }
 
 void CodeGenerator::emit(Module* m) {
@@ -23,3 +236,121 @@ void CodeGenerator::emitHumanReadableAssembly(llvm::Module *m) {
     m->print(result.os(), nullptr);
     result.keep();
 }
+
+#ifdef TIP_EMBED_RUNTIME
+/*
+ * Only main is left visible.  The globals the compiled code shares with the
+ * runtime, e.g., the heap cursors and the input array, become internal too
+ * so that the optimizer sees every use of them.
+ */
+void CodeGenerator::linkRuntime(Module *m) {
+  // The embedded bitcode is copied since the reader expects aligned memory
+  auto buffer = MemoryBuffer::getMemBufferCopy(
+      StringRef(reinterpret_cast<const char *>(tipRuntimeBitcode), tipRuntimeBitcodeSize),
+      "tip_rtlib.bc");
+  auto runtime = parseBitcodeFile(buffer->getMemBufferRef(), m->getContext());
+  if (!runtime) {
+    throw InternalError("cannot read the runtime library: " + toString(runtime.takeError()));
+  }
+  (*runtime)->setTargetTriple(m->getTargetTriple());
+
+  LOG_S(1) << "Linking the runtime library into " << m->getModuleIdentifier();
+  if (Linker::linkModules(*m, std::move(*runtime))) {
+    throw InternalError("cannot link the runtime library into " + m->getModuleIdentifier());
+  }
+  internalizeModule(*m, [](const GlobalValue &gv) { return gv.getName() == "main"; });
+}
+#endif
+
+namespace {
+
+/*
+ * Lower the module to native code for its target, the host, with the
+ * code generator of LLVM.  The code is position independent so that it can
+ * be linked into the position independent executables produced by default
+ * on most systems.
+ */
+void emitNativeTo(Module *m, raw_pwrite_stream &os, CodeGenFileType fileType) {
+  InitializeNativeTarget();
+  InitializeNativeTargetAsmPrinter();
+
+  std::string error;
+  auto triple = m->getTargetTriple();
+  auto *target = TargetRegistry::lookupTarget(triple, error);
+  if (target == nullptr) {
+    throw InternalError("cannot generate code for " + triple + ": " + error);
+  }
+
+  std::unique_ptr<TargetMachine> machine(target->createTargetMachine(
+      triple, "generic", "", TargetOptions(), Optional<Reloc::Model>(Reloc::PIC_)));
+  m->setDataLayout(machine->createDataLayout());
+
+  legacy::PassManager passes;
+  if (machine->addPassesToEmitFile(passes, os, nullptr, fileType)) {
+    throw InternalError("cannot emit this kind of file for " + triple);
+  }
+  passes.run(*m);
+}
+
+}
+
+void CodeGenerator::emitNative(Module *m, bool assembly) {
+  auto fileName = m->getModuleIdentifier() + (assembly ? NATIVE_ASM_EXT : NATIVE_OBJ_EXT);
+  std::error_code ec;
+  ToolOutputFile result(fileName, ec, assembly ? sys::fs::OF_Text : sys::fs::OF_None);
+  if (ec) {
+    throw InternalError("cannot open " + fileName + ": " + ec.message());
+  }
+  emitNativeTo(m, result.os(), assembly ? CGFT_AssemblyFile : CGFT_ObjectFile);
+  result.keep();
+}
+
+/*
+ * There is no linker among the LLVM libraries, so the object file is linked
+ * with the runtime by the system C compiler driver, which knows where the
+ * C library and its startup files live.  This replaces the compilation of
+ * the program and the runtime by clang with a single link step.
+ */
+void CodeGenerator::emitExecutable(Module *m, const std::string &runtime) {
+  // Written next to the source, like the other outputs, without its extension
+  SmallString<128> path(m->getModuleIdentifier());
+  sys::path::replace_extension(path, "");
+  auto executable = path.str().str();
+  if (executable == m->getModuleIdentifier() || sys::path::filename(path).empty()) {
+    throw InternalError("cannot name the executable of " + m->getModuleIdentifier() +
+                        " since it has no extension, the source would be overwritten");
+  }
+
+  if (!runtime.empty() && !sys::fs::exists(runtime)) {
+    throw InternalError("runtime library object " + runtime + " was not found");
+  }
+
+  SmallString<128> objectFile;
+  if (auto ec = sys::fs::createTemporaryFile("tipc", "o", objectFile)) {
+    throw InternalError("cannot create a temporary object file: " + ec.message());
+  }
+  FileRemover remover(objectFile);
+  {
+    std::error_code ec;
+    raw_fd_ostream os(objectFile, ec, sys::fs::OF_None);
+    if (ec) {
+      throw InternalError("cannot open " + objectFile.str().str() + ": " + ec.message());
+    }
+    emitNativeTo(m, os, CGFT_ObjectFile);
+  }
+
+  auto linker = sys::findProgramByName("cc");
+  if (!linker) {
+    throw InternalError("cannot find the system linker driver cc: " + linker.getError().message());
+  }
+
+  std::vector<StringRef> args { "cc", "-o", executable, objectFile };
+  if (!runtime.empty()) {
+    args.push_back(runtime);
+  }
+  LOG_S(1) << "Linking " << executable << " with " << *linker;
+  std::string error;
+  if (sys::ExecuteAndWait(*linker, args, None, {}, 0, 0, &error) != 0) {
+    throw InternalError("linking " + executable + " failed" + (error.empty() ? "" : ": " + error));
+  }
+}
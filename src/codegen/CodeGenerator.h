@@ -1,11 +1,16 @@
 #pragma once
 
 #include "ASTProgram.h"
+#include "CodeGenCache.h"
 #include "SemanticAnalysis.h"
+#include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
+#include <functional>
 
 static const char *const LLVM_ASM_EXT = ".ll";
 static const char *const LLVM_BC_EXT = ".bc";
+static const char *const NATIVE_ASM_EXT = ".s";
+static const char *const NATIVE_OBJ_EXT = ".o";
 
 /*! \class CodeGenerator
  *  \brief Routines to optimize generated code.
@@ -23,9 +28,55 @@ public:
    * \param program the root of an AST encoding the program
    * \param analysisResults the results from semantic analysis of the program
    * \param fileName the name of the source file holding the program
+   * \param context the LLVM context owning the module, one per compilation
+   * \param gc whether the heap is managed by the garbage collector
    * \return the LLVM module holding the generated program
    */
-  static std::unique_ptr<llvm::Module> generate(ASTProgram* program, SemanticAnalysis* analysisResults, std::string fileName);
+  static std::unique_ptr<llvm::Module> generate(ASTProgram* program, SemanticAnalysis* analysisResults,
+                                                std::string fileName, llvm::LLVMContext &context,
+                                                bool gc = false);
+
+  /*! \fn generate
+   *  \brief Generate LLVM IR for ast using several threads.
+   *
+   * The functions of the program are split into contiguous partitions, one
+   * per job.  Each partition is generated into its own module and LLVM
+   * context and transformed, e.g., optimized, on its own thread.  The
+   * resulting modules are then linked into a single module in the given
+   * context.  With a single job this is generate followed by transform.
+   * \param program the root of an AST encoding the program
+   * \param analysisResults the results from semantic analysis of the program
+   * \param fileName the name of the source file holding the program
+   * \param context the LLVM context owning the linked module
+   * \param jobs the number of threads to use
+   * \param transform applied to each generated module, may be empty
+   * \param gc whether the heap is managed by the garbage collector
+   * \param cache reuse the transformed code of unchanged function groups
+   *        from this cache, may be null
+   * \return the LLVM module holding the generated program
+   * \sa CodeGenCache
+   */
+  static std::unique_ptr<llvm::Module> generate(ASTProgram* program, SemanticAnalysis* analysisResults,
+                                                std::string fileName, llvm::LLVMContext &context,
+                                                unsigned jobs,
+                                                std::function<void(llvm::Module*)> transform,
+                                                bool gc = false, CodeGenCache* cache = nullptr);
+
+#ifdef TIP_EMBED_RUNTIME
+  /*! \fn linkRuntime
+   *  \brief Link the runtime library into the program.
+   *
+   * The bitcode of the runtime library, which is embedded in tipc, is linked
+   * into the module and every symbol except main is internalized.  Calls
+   * into the runtime, e.g., for IO and heap allocation, can then be inlined
+   * and specialized when the module is optimized.  The module becomes a
+   * complete program that is linked without the runtime library.  Only
+   * available when tipc is built with the TIP_EMBED_RUNTIME option.
+   * \param m the LLVM module holding the generated program
+   * \throws InternalError if the runtime library cannot be linked
+   */
+  static void linkRuntime(llvm::Module* m);
+#endif
 
   /*! \fn emit
    *  \brief Emit LLVM IR to a file.
@@ -40,4 +91,34 @@ public:
    * \param m the LLVM module holding the generated program
    */
   static void emitHumanReadableAssembly(llvm::Module* m);
+
+  /*! \fn emitNative
+   *  \brief Emit native code for the host to a file.
+   *
+   * Object files are suffixed by ".o" and assembly files by ".s".
+   * \param m the LLVM module holding the generated program
+   * \param assembly whether to emit assembly language instead of an object file
+   * \throws InternalError if no code can be generated for the host
+   */
+  static void emitNative(llvm::Module* m, bool assembly);
+
+  /*! \fn emitExecutable
+   *  \brief Emit an executable linked with the runtime library.
+   *
+   * The executable is written next to the source file and named after it
+   * without its extension.
+   * \param m the LLVM module holding the generated program
+   * \param runtime the path of the precompiled runtime library object, or
+   *        empty if the runtime has been linked into the module
+   * \throws InternalError if the program cannot be compiled or linked, or if
+   *         the source file has no extension to drop
+   */
+  static void emitExecutable(llvm::Module* m, const std::string &runtime);
+
+private:
+  static std::unique_ptr<llvm::Module> generateCached(ASTProgram* program, SemanticAnalysis* analysisResults,
+                                                      std::string fileName, llvm::LLVMContext &context,
+                                                      unsigned jobs,
+                                                      std::function<void(llvm::Module*)> transform,
+                                                      bool gc, CodeGenCache &cache);
 };
@@ -4,12 +4,23 @@
 #include "TIPLexer.h"
 #include "TIPParser.h"
 #include "ASTBuilder.h"
+#include "DescentParser.h"
 #include "PrettyPrinter.h"
 #include "ParseError.h"
+#include "SourceStream.h"
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <thread>
 
 using namespace std;
 using namespace antlr4;
 
+/*
+ * The error listeners keep no state and each parse has its own, so parses
+ * on different threads report their errors independently.
+ */
+
 //! \brief Lexer error listener for redirecting ANTLR4 errors to ParseError.
 class LexerErrorListener : public BaseErrorListener {
 public:
@@ -43,8 +54,33 @@ void ParserErrorListener::syntaxError(Recognizer *recognizer, Token *offendingSy
 }
 
 
-std::unique_ptr<ASTProgram> FrontEnd::parse(std::ifstream& stream){
-  ANTLRInputStream input(stream);
+/*
+ * A program using every construct of the grammar, which is parsed once by
+ * prewarm() to fill the caches of the lexer and the parser.
+ */
+static const char *const warmupProgram = R"(
+  f(a, b) { var x, y, z; x = alloc {p: a, q: null}; y = &z; *y = input; (*x).p = -1;
+    while (a > b) { if (a == b) { output a * b / 2; } else { error a != b; } a = a - 1; }
+    z = f(b + 1, a)(x.q); return z; }
+  /* block */ // line
+  main() { return f(1, 2); }
+)";
+
+/*
+ * The first stage predicts in SLL mode, which ignores the full context of a
+ * decision and so never falls back to the expensive full context prediction
+ * of LL mode.  For TIP it finds the same parse except on rare inputs where it
+ * rejects a valid program, so the bail out strategy stops at the first error
+ * and the input is parsed again in full LL mode, which also reports genuine
+ * syntax errors.
+ */
+std::unique_ptr<ASTProgram> FrontEnd::parse(std::string_view source, ParserKind parserKind,
+                                            std::shared_ptr<SymbolInterner> symbols){
+  if (parserKind == DESCENT) {
+    return DescentParser::parse(source, std::move(symbols));
+  }
+
+  SourceStream input(source);
   TIPLexer lexer(&input);
   CommonTokenStream tokens(&lexer);
   TIPParser parser(&tokens);
@@ -59,12 +95,70 @@ std::unique_ptr<ASTProgram> FrontEnd::parse(std::ifstream& stream){
   parser.removeErrorListeners();
   parser.addErrorListener(&parserErrorListener);
 
-  TIPParser::ProgramContext *tree = parser.program();
+  auto *interpreter = parser.getInterpreter<atn::ParserATNSimulator>();
+  interpreter->setPredictionMode(atn::PredictionMode::SLL);
+  parser.setErrorHandler(std::make_shared<BailErrorStrategy>());
 
-  ASTBuilder ab(&parser);
+  TIPParser::ProgramContext *tree;
+  try {
+    tree = parser.program();
+  } catch (ParseCancellationException &e) {
+    parser.reset();
+    interpreter->setPredictionMode(atn::PredictionMode::LL);
+    parser.setErrorHandler(std::make_shared<DefaultErrorStrategy>());
+    tree = parser.program();
+  }
+
+  ASTBuilder ab(&parser, std::move(symbols));
   return ab.build(tree);
 }
 
+/*
+ * Each worker takes the next file to parse until none are left.  Failures are
+ * kept by file and the first one in file order is rethrown, so the error
+ * reported does not depend on scheduling.
+ */
+std::unique_ptr<ASTProgram> FrontEnd::parse(const std::vector<Source> &sources, ParserKind parserKind,
+                                            unsigned jobs) {
+  std::vector<std::unique_ptr<ASTProgram>> programs(sources.size());
+  std::vector<std::exception_ptr> errors(sources.size());
+  auto symbols = std::make_shared<SymbolInterner>();
+  std::atomic<std::size_t> next{0};
+  std::vector<std::thread> workers;
+  for (unsigned w = 0; w < std::max<std::size_t>(1, std::min<std::size_t>(jobs, sources.size())); w++) {
+    workers.emplace_back([&] {
+      for (auto i = next++; i < sources.size(); i = next++) {
+        try {
+          programs[i] = parse(sources[i].text, parserKind, symbols);
+          programs[i]->setSourceFile(sources[i].name);
+        } catch (ParseError &e) {
+          errors[i] = std::make_exception_ptr(ParseError(sources[i].name + ": " + e.what()));
+        } catch (...) {
+          errors[i] = std::current_exception();
+        }
+      }
+    });
+  }
+  for (auto &w : workers) {
+    w.join();
+  }
+  for (auto &e : errors) {
+    if (e) {
+      std::rethrow_exception(e);
+    }
+  }
+  return ASTProgram::merge(std::move(programs));
+}
+
+std::unique_ptr<ASTProgram> FrontEnd::parse(std::istream& stream){
+  std::string source{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+  return parse(source);
+}
+
+void FrontEnd::prewarm() {
+  parse(warmupProgram);
+}
+
 void FrontEnd::prettyprint(ASTProgram* program, std::ostream& os) {
   PrettyPrinter::print(program, os, ' ', 2);
 }
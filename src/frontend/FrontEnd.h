@@ -3,22 +3,81 @@
 #include "ASTProgram.h"
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
 
 /*! \class FrontEnd
  *  \brief A collection of routines implementing the compiler front end.
  */
 class FrontEnd {
 public:
+  //! \brief The parsers of the front end.
+  enum ParserKind {
+    ANTLR,  //!< The parser generated by ANTLR from TIP.g4
+    DESCENT //!< The hand written DescentParser, which builds the AST directly
+  };
+
   /*! \fn parse
-   *  \brief Parse an input stream and return an AST.
+   *  \brief Parse program text and return an AST.
    *
    * Parsing can detect errors, which are reported via throw of a ParseError
    * exception.  In the absence of errors, ownership of the generated AST is 
-   * transfered to the caller.
+   * transfered to the caller.  Input is parsed in the fast SLL prediction
+   * mode of ANTLR first and only parsed again in full LL mode if that fails.
+   * The text is lexed in place, e.g., from a MappedFile, without a copy.
+   * Both parsers build the same AST and report errors at the same places.
+   * \param source the program text.
+   * \param parser the parser to use.
+   * \param symbols the interner of the names of the program, by default
+   *        one of its own, so the names are released with the AST.
+   * \return the generated AST.
+   */
+  static std::unique_ptr<ASTProgram>
+  parse(std::string_view source, ParserKind parser = ANTLR,
+        std::shared_ptr<SymbolInterner> symbols = std::make_shared<SymbolInterner>());
+
+  //! \brief The text of a source file and the name it is reported by.
+  struct Source {
+    std::string name;
+    std::string_view text;
+  };
+
+  /*! \fn parse
+   *  \brief Parse several source files into the AST of one program.
+   *
+   * The files are parsed independently on up to jobs threads and their
+   * functions are joined in the order of the files, so the time to parse is
+   * that of the largest file rather than the sum over all files.  The files
+   * share one interner for the names of the program.  Each function records
+   * the file it came from.  A ParseError names the file it
+   * was found in and is that of the first file, in order, that has errors.
+   * \param sources the files of the program.
+   * \param parser the parser to use.
+   * \param jobs the number of threads to parse on.
+   * \return the generated AST.
+   */
+  static std::unique_ptr<ASTProgram> parse(const std::vector<Source> &sources, ParserKind parser = ANTLR,
+                                           unsigned jobs = 1);
+
+  /*! \fn parse
+   *  \brief Parse an input stream and return an AST.
+   *
+   * The stream is read into memory and parsed as program text.
    * \param stream the input stream holding the program text.
    * \return the generated AST.
    */
-  static std::unique_ptr<ASTProgram> parse(std::ifstream& stream);
+  static std::unique_ptr<ASTProgram> parse(std::istream& stream);
+
+  /*! \fn prewarm
+   *  \brief Fill the prediction caches shared by all parses in the process.
+   *
+   * ANTLR caches the decisions of the parser in a DFA that is shared by every
+   * parser and grows as inputs exercise the grammar, so the first parses of
+   * a process are the slowest.  Parsing a program that uses every construct
+   * up front lets long running compilers, e.g., a compile server, start warm.
+   */
+  static void prewarm();
 
   /*! \fn print
    *  \brief Print program in a standard form to cout.
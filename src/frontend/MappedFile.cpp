@@ -0,0 +1,49 @@
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string &path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+
+  struct stat status;
+  if (::fstat(fd, &status) == 0 && S_ISREG(status.st_mode)) {
+    // An empty file cannot be mapped and has no contents to map
+    if (status.st_size == 0) {
+      opened = true;
+    } else {
+      void *address = ::mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (address != MAP_FAILED) {
+        // The lexer reads the source once from start to end
+        ::madvise(address, status.st_size, MADV_SEQUENTIAL);
+        mapping = address;
+        contents = std::string_view(static_cast<const char *>(address), status.st_size);
+        opened = true;
+      }
+    }
+  }
+
+  if (!opened) {
+    char chunk[65536];
+    ssize_t count;
+    while ((count = ::read(fd, chunk, sizeof(chunk))) > 0) {
+      buffer.append(chunk, count);
+    }
+    if (count == 0) {
+      contents = buffer;
+      opened = true;
+    }
+  }
+  ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (mapping != nullptr) {
+    ::munmap(mapping, contents.size());
+  }
+}
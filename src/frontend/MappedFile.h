@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+/*! \class MappedFile
+ *  \brief The contents of a source file mapped read only into memory.
+ *
+ * The operating system reads the pages of a mapped file as they are first
+ * touched and shares them with its page cache, so a large source is neither
+ * copied nor held in memory beyond what the lexer has reached.  Files that
+ * cannot be mapped, e.g., pipes, are read into memory instead.
+ */
+class MappedFile {
+public:
+  /*! \brief Map the file.
+   *
+   * Like opening a std::ifstream, failure is reported by good().
+   * \param path the path of the file
+   */
+  explicit MappedFile(const std::string &path);
+
+  //! \brief Unmap the file, invalidating its contents.
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  //! \brief Whether the file was opened and mapped or read.
+  bool good() const { return opened; }
+
+  //! \brief The bytes of the file, valid for the lifetime of this object.
+  std::string_view getContents() const { return contents; }
+
+private:
+  bool opened = false;
+  void *mapping = nullptr;
+  std::string buffer;
+  std::string_view contents;
+};
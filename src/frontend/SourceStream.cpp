@@ -0,0 +1,62 @@
+#include "SourceStream.h"
+
+#include <algorithm>
+
+using namespace antlr4;
+
+SourceStream::SourceStream(std::string_view source, std::string name)
+    : source(source), name(std::move(name)) {}
+
+void SourceStream::consume() {
+  if (p >= source.size()) {
+    throw IllegalStateException("cannot consume EOF");
+  }
+  p++;
+}
+
+// As in ANTLRInputStream, LA(1) is the current character and LA(-1) the previous one
+size_t SourceStream::LA(ssize_t i) {
+  if (i == 0) {
+    return 0; // undefined
+  }
+  ssize_t position = static_cast<ssize_t>(p) + (i < 0 ? i : i - 1);
+  if (position < 0 || position >= static_cast<ssize_t>(source.size())) {
+    return IntStream::EOF;
+  }
+  return static_cast<unsigned char>(source[position]);
+}
+
+// The whole source is always available, so marks need no bookkeeping
+ssize_t SourceStream::mark() {
+  return -1;
+}
+
+void SourceStream::release(ssize_t marker) {}
+
+size_t SourceStream::index() {
+  return p;
+}
+
+void SourceStream::seek(size_t index) {
+  p = std::min(index, source.size());
+}
+
+size_t SourceStream::size() {
+  return source.size();
+}
+
+std::string SourceStream::getSourceName() const {
+  return name.empty() ? IntStream::UNKNOWN_SOURCE_NAME : name;
+}
+
+std::string SourceStream::getText(const misc::Interval &interval) {
+  if (interval.a < 0 || interval.b < interval.a || static_cast<size_t>(interval.a) >= source.size()) {
+    return "";
+  }
+  size_t stop = std::min(static_cast<size_t>(interval.b), source.size() - 1);
+  return std::string(source.substr(interval.a, stop - interval.a + 1));
+}
+
+std::string SourceStream::toString() const {
+  return std::string(source);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "antlr4-runtime.h"
+#include <string_view>
+
+/*! \class SourceStream
+ *  \brief An ANTLR character stream over the bytes of a TIP source.
+ *
+ * ANTLRInputStream decodes its input from UTF-8 into a copy holding a 32 bit
+ * code point per character, four times the size of the source.  TIP programs
+ * are ASCII, so this stream gives the lexer the bytes of the source as they
+ * are, e.g., straight from a MappedFile, without copying them.  Bytes outside
+ * of ASCII only occur in comments of valid programs and are skipped there.
+ *
+ * Tokens read their text from the stream, so the source must outlive both
+ * the stream and the tokens lexed from it.
+ */
+class SourceStream : public antlr4::CharStream {
+public:
+  /*! \brief A stream over the source.
+   *
+   * \param source the program text, which is not copied
+   * \param name the name of the source reported by getSourceName()
+   */
+  explicit SourceStream(std::string_view source, std::string name = "");
+
+  void consume() override;
+  size_t LA(ssize_t i) override;
+  ssize_t mark() override;
+  void release(ssize_t marker) override;
+  size_t index() override;
+  void seek(size_t index) override;
+  size_t size() override;
+  std::string getSourceName() const override;
+  std::string getText(const antlr4::misc::Interval &interval) override;
+  std::string toString() const override;
+
+private:
+  std::string_view source;
+  std::string name;
+  size_t p = 0;
+};
@@ -0,0 +1,32 @@
+#include "ASTArena.h"
+#include "InternalError.h"
+
+ASTArena::ASTArena(std::shared_ptr<SymbolInterner> symbols) : symbols(std::move(symbols)) {}
+
+/*
+ * The keys of the cache are views of the interned names themselves, which
+ * live as long as the interner the arena keeps alive.
+ */
+const std::string *ASTArena::intern(std::string_view name) {
+  auto found = names.find(name);
+  if (found == names.end()) {
+    auto symbol = symbols->intern(name);
+    found = names.emplace(*symbol, symbol).first;
+  }
+  return found->second;
+}
+
+void ASTArena::adopt(std::unique_ptr<ASTArena> other) {
+  if (other->symbols != symbols) {
+    throw InternalError("cannot adopt an arena with names of another interner");
+  }
+  adopted.push_back(std::move(other));
+}
+
+size_t ASTArena::getBytesAllocated() const {
+  size_t bytes = allocator.getBytesAllocated();
+  for (auto &arena : adopted) {
+    bytes += arena->getBytesAllocated();
+  }
+  return bytes;
+}
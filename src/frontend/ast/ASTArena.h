@@ -0,0 +1,85 @@
+#pragma once
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/Allocator.h"
+#include "SymbolInterner.h"
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/*! \class ASTArena
+ *  \brief The memory of the nodes of an AST and of the names they use.
+ *
+ * Nodes are bump allocated, so that nodes built one after another lie next
+ * to each other in memory, and the whole tree is released in one shot when
+ * the arena is destroyed.  The destructors of the nodes are never run, which
+ * is why node types must be trivially destructible: a node refers to its
+ * children and names through plain pointers into the arena rather than
+ * owning them.  The lists of children of a node are arrays in the arena and
+ * names are interned by a SymbolInterner, which the arenas of the files of a
+ * program share, so each distinct name is stored once per compilation.
+ */
+class ASTArena {
+public:
+  /*! \brief An arena interning its names with the given interner.
+   *
+   * \param symbols the interner, by default one of the arena's own
+   */
+  explicit ASTArena(std::shared_ptr<SymbolInterner> symbols = std::make_shared<SymbolInterner>());
+  ASTArena(const ASTArena &) = delete;
+  ASTArena &operator=(const ASTArena &) = delete;
+
+  /*! \brief Construct a node in the arena.
+   *
+   * \return the node, which lives as long as the arena
+   */
+  template <typename T, typename... Args> T *make(Args &&... args) {
+    static_assert(std::is_trivially_destructible<T>::value, "the destructors of AST nodes are never run");
+    return new (allocator.Allocate<T>()) T(std::forward<Args>(args)...);
+  }
+
+  //! \brief Copy a list of children into the arena.
+  template <typename T> llvm::ArrayRef<T *> copy(const std::vector<T *> &list) {
+    if (list.empty()) {
+      return llvm::ArrayRef<T *>();
+    }
+    T **array = allocator.Allocate<T *>(list.size());
+    std::copy(list.begin(), list.end(), array);
+    return llvm::ArrayRef<T *>(array, list.size());
+  }
+
+  /*! \brief The interned copy of a name.
+   *
+   * Equal names are interned to the same string by all arenas sharing an
+   * interner.  The names seen by the arena are cached so that parsers
+   * running on several threads rarely wait on the shared SymbolInterner.
+   */
+  const std::string *intern(std::string_view name);
+
+  //! \brief The interner of the names of the arena, which it keeps alive.
+  const std::shared_ptr<SymbolInterner> &getSymbols() const { return symbols; }
+
+  /*! \brief Keep the nodes of another arena alive as long as this one.
+   *
+   * This lets the trees of separately parsed files be joined into one tree
+   * without copying their nodes.
+   * \throws InternalError if the arenas do not share an interner, since
+   *         their names would not agree
+   */
+  void adopt(std::unique_ptr<ASTArena> other);
+
+  //! \brief The number of bytes allocated for nodes and lists of children.
+  size_t getBytesAllocated() const;
+
+private:
+  llvm::BumpPtrAllocator allocator;
+  std::shared_ptr<SymbolInterner> symbols;
+  std::unordered_map<std::string_view, const std::string *> names;
+  std::vector<std::unique_ptr<ASTArena>> adopted;
+};
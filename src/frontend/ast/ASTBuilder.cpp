@@ -3,52 +3,31 @@
 
 using namespace antlrcpp;
 
-ASTBuilder::ASTBuilder(TIPParser *p) : parser{p} {}
+ASTBuilder::ASTBuilder(TIPParser *p, std::shared_ptr<SymbolInterner> s) : parser{p}, symbols{std::move(s)} {}
 
-std::string ASTBuilder::opString(int op) {
-  std::string opStr;
+ASTBinaryExpr::Op ASTBuilder::binaryOp(int op) {
   switch (op) {
   case TIPParser::MUL:
-    opStr = "*";
-    break;
+    return ASTBinaryExpr::MUL;
   case TIPParser::DIV:
-    opStr = "/";
-    break;
+    return ASTBinaryExpr::DIV;
   case TIPParser::ADD:
-    opStr = "+";
-    break;
+    return ASTBinaryExpr::ADD;
   case TIPParser::SUB:
-    opStr = "-";
-    break;
+    return ASTBinaryExpr::SUB;
   case TIPParser::GT:
-    opStr = ">";
-    break;
+    return ASTBinaryExpr::GT;
   case TIPParser::EQ:
-    opStr = "==";
-    break;
+    return ASTBinaryExpr::EQ;
   case TIPParser::NE:
-    opStr = "!=";
-    break;
+    return ASTBinaryExpr::NE;
   default:
-    std::runtime_error(
+    throw std::runtime_error(
         "unknown operator :" +
         ASTBuilder::parser->getVocabulary().getLiteralName(op));
   }
-  return opStr;
 }
 
-/*
- * Globals for communicating information up from visited subtrees
- * These are overwritten by every visit call.
- * We use multiple variables here to avoid downcasting of unique smart pointers.
- */
-static std::unique_ptr<ASTStmt> visitedStmt = nullptr;
-static std::unique_ptr<ASTDeclNode> visitedDeclNode = nullptr;
-static std::unique_ptr<ASTDeclStmt> visitedDeclStmt = nullptr;
-static std::unique_ptr<ASTExpr> visitedExpr = nullptr;
-static std::unique_ptr<ASTFieldExpr> visitedFieldExpr = nullptr;
-static std::unique_ptr<ASTFunction> visitedFunction = nullptr;
-
 /**********************************************************************
  * These methods override selected methods in the TIPBaseVisitor.
  *
@@ -67,7 +46,8 @@ static std::unique_ptr<ASTFunction> visitedFunction = nullptr;
  * be lost by the methods you don't override).  Instead you must create
  * your own structure that is local to the visitor to communicate between
  * the calls during the visit.  In the case of this visitor it is the
- * visitedX variables above.
+ * visitedX members of the builder, which also keep builders running on
+ * different threads independent of each other.
  *
  * Note that the visit methods are required to return a value, but
  * we make no use of that value, so we simply return the empty string ("")
@@ -79,47 +59,48 @@ static std::unique_ptr<ASTFunction> visitedFunction = nullptr;
  */
 
 std::unique_ptr<ASTProgram> ASTBuilder::build(TIPParser::ProgramContext *ctx) {
-  std::vector<std::unique_ptr<ASTFunction>> pFunctions;
+  arena = std::make_unique<ASTArena>(symbols);
+  std::vector<ASTFunction*> pFunctions;
   for (auto fn : ctx->function()) {
     visit(fn);
-    pFunctions.push_back(std::move(visitedFunction));
+    pFunctions.push_back(visitedFunction);
   }
-  return std::make_unique<ASTProgram>(std::move(pFunctions));
+  return std::make_unique<ASTProgram>(std::move(arena), pFunctions);
 }
 
 Any ASTBuilder::visitFunction(TIPParser::FunctionContext *ctx) {
-  std::unique_ptr<ASTDeclNode> fName;
-  std::vector<std::unique_ptr<ASTDeclNode>> fParams;
-  std::vector<std::unique_ptr<ASTDeclStmt>> fDecls;
-  std::vector<std::unique_ptr<ASTStmt>> fBody;
+  ASTDeclNode *fName = nullptr;
+  std::vector<ASTDeclNode*> fParams;
+  std::vector<ASTDeclStmt*> fDecls;
+  std::vector<ASTStmt*> fBody;
 
   bool firstId = true;
   for (auto decl : ctx->nameDeclaration()) {
     visit(decl);
     if (firstId) {
       firstId = !firstId;
-      fName = std::move(visitedDeclNode);
+      fName = visitedDeclNode;
     } else {
-      fParams.push_back(std::move(visitedDeclNode));
+      fParams.push_back(visitedDeclNode);
     }
   }
 
   for (auto decl : ctx->declaration()) {
     visit(decl);
-    fDecls.push_back(std::move(visitedDeclStmt));
+    fDecls.push_back(visitedDeclStmt);
   }
 
   for (auto stmt : ctx->statement()) {
     visit(stmt);
-    fBody.push_back(std::move(visitedStmt));
+    fBody.push_back(visitedStmt);
   }
 
   // return statement is always the last statement in a TIP function body
   visit(ctx->returnStmt());
-  fBody.push_back(std::move(visitedStmt));
+  fBody.push_back(visitedStmt);
 
-  visitedFunction = std::make_unique<ASTFunction>(
-      std::move(fName), std::move(fParams), std::move(fDecls), std::move(fBody));
+  visitedFunction = arena->make<ASTFunction>(
+      fName, arena->copy(fParams), arena->copy(fDecls), arena->copy(fBody));
 
   // Set source location 
   visitedFunction->setLocation(ctx->getStart()->getLine(), 
@@ -130,7 +111,7 @@ Any ASTBuilder::visitFunction(TIPParser::FunctionContext *ctx) {
 Any ASTBuilder::visitNegNumber(TIPParser::NegNumberContext *ctx) {
   int val = std::stoi(ctx->NUMBER()->getText());
   val = -val;
-  visitedExpr = std::make_unique<ASTNumberExpr>(val);
+  visitedExpr = arena->make<ASTNumberExpr>(val);
 
   // Set source location 
   visitedExpr->setLocation(ctx->getStart()->getLine(), 
@@ -149,15 +130,15 @@ Any ASTBuilder::visitNegNumber(TIPParser::NegNumberContext *ctx) {
  * mechanism for handling operator precedence would be needed.
  */
 Any ASTBuilder::visitAdditiveExpr(TIPParser::AdditiveExprContext *ctx) {
-  std::string op = opString(ctx->op->getType());
+  ASTBinaryExpr::Op op = binaryOp(ctx->op->getType());
 
   visit(ctx->expr(0));
-  auto lhs = std::move(visitedExpr);
+  auto lhs = visitedExpr;
 
   visit(ctx->expr(1));
-  auto rhs = std::move(visitedExpr);
+  auto rhs = visitedExpr;
 
-  visitedExpr = std::make_unique<ASTBinaryExpr>(op, std::move(lhs), std::move(rhs));
+  visitedExpr = arena->make<ASTBinaryExpr>(op, lhs, rhs);
 
   // Set source location 
   visitedExpr->setLocation(ctx->getStart()->getLine(), 
@@ -166,15 +147,15 @@ Any ASTBuilder::visitAdditiveExpr(TIPParser::AdditiveExprContext *ctx) {
 }
 
 Any ASTBuilder::visitRelationalExpr(TIPParser::RelationalExprContext *ctx) {
-  std::string op = opString(ctx->op->getType());
+  ASTBinaryExpr::Op op = binaryOp(ctx->op->getType());
 
   visit(ctx->expr(0));
-  auto lhs = std::move(visitedExpr);
+  auto lhs = visitedExpr;
 
   visit(ctx->expr(1));
-  auto rhs = std::move(visitedExpr);
+  auto rhs = visitedExpr;
 
-  visitedExpr = std::make_unique<ASTBinaryExpr>(op, std::move(lhs), std::move(rhs));
+  visitedExpr = arena->make<ASTBinaryExpr>(op, lhs, rhs);
 
   // Set source location 
   visitedExpr->setLocation(ctx->getStart()->getLine(), 
@@ -184,15 +165,15 @@ Any ASTBuilder::visitRelationalExpr(TIPParser::RelationalExprContext *ctx) {
 
 Any ASTBuilder::visitMultiplicativeExpr(
     TIPParser::MultiplicativeExprContext *ctx) {
-  std::string op = opString(ctx->op->getType());
+  ASTBinaryExpr::Op op = binaryOp(ctx->op->getType());
 
   visit(ctx->expr(0));
-  auto lhs = std::move(visitedExpr);
+  auto lhs = visitedExpr;
 
   visit(ctx->expr(1));
-  auto rhs = std::move(visitedExpr);
+  auto rhs = visitedExpr;
 
-  visitedExpr = std::make_unique<ASTBinaryExpr>(op, std::move(lhs), std::move(rhs));
+  visitedExpr = arena->make<ASTBinaryExpr>(op, lhs, rhs);
 
   // Set source location 
   visitedExpr->setLocation(ctx->getStart()->getLine(), 
@@ -201,15 +182,15 @@ Any ASTBuilder::visitMultiplicativeExpr(
 }
 
 Any ASTBuilder::visitEqualityExpr(TIPParser::EqualityExprContext *ctx) {
-  std::string op = opString(ctx->op->getType());
+  ASTBinaryExpr::Op op = binaryOp(ctx->op->getType());
 
   visit(ctx->expr(0));
-  auto lhs = std::move(visitedExpr);
+  auto lhs = visitedExpr;
 
   visit(ctx->expr(1));
-  auto rhs = std::move(visitedExpr);
+  auto rhs = visitedExpr;
 
-  visitedExpr = std::make_unique<ASTBinaryExpr>(op, std::move(lhs), std::move(rhs));
+  visitedExpr = arena->make<ASTBinaryExpr>(op, lhs, rhs);
 
   // Set source location 
   visitedExpr->setLocation(ctx->getStart()->getLine(), 
@@ -225,7 +206,7 @@ Any ASTBuilder::visitParenExpr(TIPParser::ParenExprContext *ctx) {
 
 Any ASTBuilder::visitNumExpr(TIPParser::NumExprContext *ctx) {
   int val = std::stoi(ctx->NUMBER()->getText());
-  visitedExpr = std::make_unique<ASTNumberExpr>(val);
+  visitedExpr = arena->make<ASTNumberExpr>(val);
 
   // Set source location 
   visitedExpr->setLocation(ctx->getStart()->getLine(), 
@@ -234,8 +215,8 @@ Any ASTBuilder::visitNumExpr(TIPParser::NumExprContext *ctx) {
 }
 
 Any ASTBuilder::visitVarExpr(TIPParser::VarExprContext *ctx) {
-  std::string name = ctx->IDENTIFIER()->getText();
-  visitedExpr = std::make_unique<ASTVariableExpr>(name);
+  auto name = arena->intern(ctx->IDENTIFIER()->getText());
+  visitedExpr = arena->make<ASTVariableExpr>(name);
 
   // Set source location 
   visitedExpr->setLocation(ctx->getStart()->getLine(), 
@@ -244,7 +225,7 @@ Any ASTBuilder::visitVarExpr(TIPParser::VarExprContext *ctx) {
 }
 
 Any ASTBuilder::visitInputExpr(TIPParser::InputExprContext *ctx) {
-  visitedExpr = std::make_unique<ASTInputExpr>();
+  visitedExpr = arena->make<ASTInputExpr>();
 
   // Set source location 
   visitedExpr->setLocation(ctx->getStart()->getLine(), 
@@ -253,22 +234,22 @@ Any ASTBuilder::visitInputExpr(TIPParser::InputExprContext *ctx) {
 }
 
 Any ASTBuilder::visitFunAppExpr(TIPParser::FunAppExprContext *ctx) {
-  std::unique_ptr<ASTExpr> fExpr = nullptr;
-  std::vector<std::unique_ptr<ASTExpr>> fArgs;
+  ASTExpr *fExpr = nullptr;
+  std::vector<ASTExpr*> fArgs;
 
   // First expression is the function, the rest are the args
   bool first = true; 
   for (auto e : ctx->expr()) {
     visit(e);
     if (first) {
-      fExpr = std::move(visitedExpr);
+      fExpr = visitedExpr;
       first = false;
     } else {
-      fArgs.push_back(std::move(visitedExpr));
+      fArgs.push_back(visitedExpr);
     }
   }
 
-  visitedExpr = std::make_unique<ASTFunAppExpr>(std::move(fExpr), std::move(fArgs));
+  visitedExpr = arena->make<ASTFunAppExpr>(fExpr, arena->copy(fArgs));
 
   // Set source location 
   visitedExpr->setLocation(ctx->getStart()->getLine(), 
@@ -278,7 +259,7 @@ Any ASTBuilder::visitFunAppExpr(TIPParser::FunAppExprContext *ctx) {
 
 Any ASTBuilder::visitAllocExpr(TIPParser::AllocExprContext *ctx) {
   visit(ctx->expr());
-  visitedExpr = std::make_unique<ASTAllocExpr>(std::move(visitedExpr));
+  visitedExpr = arena->make<ASTAllocExpr>(visitedExpr);
 
   // Set source location 
   visitedExpr->setLocation(ctx->getStart()->getLine(), 
@@ -288,7 +269,7 @@ Any ASTBuilder::visitAllocExpr(TIPParser::AllocExprContext *ctx) {
 
 Any ASTBuilder::visitRefExpr(TIPParser::RefExprContext *ctx) {
   visit(ctx->expr());
-  visitedExpr = std::make_unique<ASTRefExpr>(std::move(visitedExpr));
+  visitedExpr = arena->make<ASTRefExpr>(visitedExpr);
 
   // Set source location 
   visitedExpr->setLocation(ctx->getStart()->getLine(), 
@@ -298,7 +279,7 @@ Any ASTBuilder::visitRefExpr(TIPParser::RefExprContext *ctx) {
 
 Any ASTBuilder::visitDeRefExpr(TIPParser::DeRefExprContext *ctx) {
   visit(ctx->expr());
-  visitedExpr = std::make_unique<ASTDeRefExpr>(std::move(visitedExpr));
+  visitedExpr = arena->make<ASTDeRefExpr>(visitedExpr);
 
   // Set source location 
   visitedExpr->setLocation(ctx->getStart()->getLine(), 
@@ -307,7 +288,7 @@ Any ASTBuilder::visitDeRefExpr(TIPParser::DeRefExprContext *ctx) {
 }
 
 Any ASTBuilder::visitNullExpr(TIPParser::NullExprContext *ctx) {
-  visitedExpr = std::make_unique<ASTNullExpr>();
+  visitedExpr = arena->make<ASTNullExpr>();
 
   // Set source location 
   visitedExpr->setLocation(ctx->getStart()->getLine(), 
@@ -316,13 +297,13 @@ Any ASTBuilder::visitNullExpr(TIPParser::NullExprContext *ctx) {
 }
 
 Any ASTBuilder::visitRecordExpr(TIPParser::RecordExprContext *ctx) {
-  std::vector<std::unique_ptr<ASTFieldExpr>> rFields;
+  std::vector<ASTFieldExpr*> rFields;
   for (auto fn : ctx->fieldExpr()) {
     visit(fn);
-    rFields.push_back(std::move(visitedFieldExpr));
+    rFields.push_back(visitedFieldExpr);
   }
 
-  visitedExpr = std::make_unique<ASTRecordExpr>(std::move(rFields));
+  visitedExpr = arena->make<ASTRecordExpr>(arena->copy(rFields));
 
   // Set source location 
   visitedExpr->setLocation(ctx->getStart()->getLine(), 
@@ -331,9 +312,9 @@ Any ASTBuilder::visitRecordExpr(TIPParser::RecordExprContext *ctx) {
 }
 
 Any ASTBuilder::visitFieldExpr(TIPParser::FieldExprContext *ctx) {
-  std::string fName = ctx->IDENTIFIER()->getText();
+  auto fName = arena->intern(ctx->IDENTIFIER()->getText());
   visit(ctx->expr());
-  visitedFieldExpr = std::make_unique<ASTFieldExpr>(fName, std::move(visitedExpr));
+  visitedFieldExpr = arena->make<ASTFieldExpr>(fName, visitedExpr);
 
   // Set source location 
   visitedFieldExpr->setLocation(ctx->getStart()->getLine(), 
@@ -342,12 +323,12 @@ Any ASTBuilder::visitFieldExpr(TIPParser::FieldExprContext *ctx) {
 }
 
 Any ASTBuilder::visitAccessExpr(TIPParser::AccessExprContext *ctx) {
-  std::string fName = ctx->IDENTIFIER()->getText();
+  auto fName = arena->intern(ctx->IDENTIFIER()->getText());
 
   visit(ctx->expr());
-  auto rExpr = std::move(visitedExpr);
+  auto rExpr = visitedExpr;
 
-  visitedExpr = std::make_unique<ASTAccessExpr>(std::move(rExpr), fName);
+  visitedExpr = arena->make<ASTAccessExpr>(rExpr, fName);
 
   // Set source location 
   visitedExpr->setLocation(ctx->getStart()->getLine(), 
@@ -356,12 +337,12 @@ Any ASTBuilder::visitAccessExpr(TIPParser::AccessExprContext *ctx) {
 }
 
 Any ASTBuilder::visitDeclaration(TIPParser::DeclarationContext *ctx) {
-  std::vector<std::unique_ptr<ASTDeclNode>> dVars;
+  std::vector<ASTDeclNode*> dVars;
   for (auto decl : ctx->nameDeclaration()) {
     visit(decl);
-    dVars.push_back(std::move(visitedDeclNode));
+    dVars.push_back(visitedDeclNode);
   }
-  visitedDeclStmt = std::make_unique<ASTDeclStmt>(std::move(dVars));
+  visitedDeclStmt = arena->make<ASTDeclStmt>(arena->copy(dVars));
 
   // Set source location 
   visitedDeclStmt->setLocation(ctx->getStart()->getLine(), 
@@ -370,8 +351,8 @@ Any ASTBuilder::visitDeclaration(TIPParser::DeclarationContext *ctx) {
 }
 
 Any ASTBuilder::visitNameDeclaration(TIPParser::NameDeclarationContext *ctx) {
-  std::string name = ctx->IDENTIFIER()->getText();
-  visitedDeclNode = std::make_unique<ASTDeclNode>(name);
+  auto name = arena->intern(ctx->IDENTIFIER()->getText());
+  visitedDeclNode = arena->make<ASTDeclNode>(name);
 
   // Set source location 
   visitedDeclNode->setLocation(ctx->getStart()->getLine(), 
@@ -380,12 +361,12 @@ Any ASTBuilder::visitNameDeclaration(TIPParser::NameDeclarationContext *ctx) {
 }
 
 Any ASTBuilder::visitBlockStmt(TIPParser::BlockStmtContext *ctx) {
-  std::vector<std::unique_ptr<ASTStmt>> bStmts;
+  std::vector<ASTStmt*> bStmts;
   for (auto s : ctx->statement()) {
     visit(s);
-    bStmts.push_back(std::move(visitedStmt));
+    bStmts.push_back(visitedStmt);
   }
-  visitedStmt = std::make_unique<ASTBlockStmt>(std::move(bStmts));
+  visitedStmt = arena->make<ASTBlockStmt>(arena->copy(bStmts));
 
   // Set source location 
   visitedStmt->setLocation(ctx->getStart()->getLine(), 
@@ -395,10 +376,10 @@ Any ASTBuilder::visitBlockStmt(TIPParser::BlockStmtContext *ctx) {
 
 Any ASTBuilder::visitWhileStmt(TIPParser::WhileStmtContext *ctx) {
   visit(ctx->expr());
-  auto cond = std::move(visitedExpr);
+  auto cond = visitedExpr;
   visit(ctx->statement());
-  auto body = std::move(visitedStmt);
-  visitedStmt = std::make_unique<ASTWhileStmt>(std::move(cond), std::move(body));
+  auto body = visitedStmt;
+  visitedStmt = arena->make<ASTWhileStmt>(cond, body);
 
   // Set source location 
   visitedStmt->setLocation(ctx->getStart()->getLine(), 
@@ -408,19 +389,18 @@ Any ASTBuilder::visitWhileStmt(TIPParser::WhileStmtContext *ctx) {
 
 Any ASTBuilder::visitIfStmt(TIPParser::IfStmtContext *ctx) {
   visit(ctx->expr());
-  auto cond = std::move(visitedExpr);
+  auto cond = visitedExpr;
   visit(ctx->statement(0));
-  auto thenBody = std::move(visitedStmt);
+  auto thenBody = visitedStmt;
 
   // else is optional
-  std::unique_ptr<ASTStmt> elseBody = nullptr;
+  ASTStmt *elseBody = nullptr;
   if (ctx->statement().size() == 2) {
     visit(ctx->statement(1));
-    elseBody = std::move(visitedStmt);
+    elseBody = visitedStmt;
   }
 
-  visitedStmt = std::make_unique<ASTIfStmt>(std::move(cond), std::move(thenBody),
-                                            std::move(elseBody));
+  visitedStmt = arena->make<ASTIfStmt>(cond, thenBody, elseBody);
 
   // Set source location 
   visitedStmt->setLocation(ctx->getStart()->getLine(), 
@@ -430,7 +410,7 @@ Any ASTBuilder::visitIfStmt(TIPParser::IfStmtContext *ctx) {
 
 Any ASTBuilder::visitOutputStmt(TIPParser::OutputStmtContext *ctx) {
   visit(ctx->expr());
-  visitedStmt = std::make_unique<ASTOutputStmt>(std::move(visitedExpr));
+  visitedStmt = arena->make<ASTOutputStmt>(visitedExpr);
 
   // Set source location 
   visitedStmt->setLocation(ctx->getStart()->getLine(), 
@@ -440,7 +420,7 @@ Any ASTBuilder::visitOutputStmt(TIPParser::OutputStmtContext *ctx) {
 
 Any ASTBuilder::visitErrorStmt(TIPParser::ErrorStmtContext *ctx) {
   visit(ctx->expr());
-  visitedStmt = std::make_unique<ASTErrorStmt>(std::move(visitedExpr));
+  visitedStmt = arena->make<ASTErrorStmt>(visitedExpr);
 
   // Set source location 
   visitedStmt->setLocation(ctx->getStart()->getLine(), 
@@ -450,7 +430,7 @@ Any ASTBuilder::visitErrorStmt(TIPParser::ErrorStmtContext *ctx) {
 
 Any ASTBuilder::visitReturnStmt(TIPParser::ReturnStmtContext *ctx) {
   visit(ctx->expr());
-  visitedStmt = std::make_unique<ASTReturnStmt>(std::move(visitedExpr));
+  visitedStmt = arena->make<ASTReturnStmt>(visitedExpr);
 
   // Set source location 
   visitedStmt->setLocation(ctx->getStart()->getLine(), 
@@ -460,10 +440,10 @@ Any ASTBuilder::visitReturnStmt(TIPParser::ReturnStmtContext *ctx) {
 
 Any ASTBuilder::visitAssignStmt(TIPParser::AssignStmtContext *ctx) {
     visit(ctx->expr(0));
-    auto lhs = std::move(visitedExpr);
+    auto lhs = visitedExpr;
     visit(ctx->expr(1));
-    auto rhs = std::move(visitedExpr);
-    visitedStmt = std::make_unique<ASTAssignStmt>(std::move(lhs), std::move(rhs));
+    auto rhs = visitedExpr;
+    visitedStmt = arena->make<ASTAssignStmt>(lhs, rhs);
 
   // Set source location 
   visitedStmt->setLocation(ctx->getStart()->getLine(), 
@@ -16,15 +16,32 @@ using namespace antlrcpp;
  * As such its structure follows that of the ANTLR4 generated TIPBaseVisitor.
  * The primary entry point is the build method which initiates the traversal
  * of the parse tree and, if succesful, generates a unique ASTProgram whose 
- * ownership is transferred to the caller.  
+ * ownership is transferred to the caller.  The nodes of the program are
+ * allocated in a new arena, which the program owns, and its names are
+ * interned by the interner given to the builder.  A builder keeps
+ * no state outside of itself, so builders can run on several threads at once.
  */
 class ASTBuilder : public TIPBaseVisitor {
 private:
   TIPParser *parser;
-  std::string opString(int op);
+  std::shared_ptr<SymbolInterner> symbols;
+  std::unique_ptr<ASTArena> arena;
+  ASTBinaryExpr::Op binaryOp(int op);
+
+  /*
+   * For communicating information up from visited subtrees.
+   * These are overwritten by every visit call.
+   * We use multiple members here to avoid downcasting.
+   */
+  ASTStmt *visitedStmt = nullptr;
+  ASTDeclNode *visitedDeclNode = nullptr;
+  ASTDeclStmt *visitedDeclStmt = nullptr;
+  ASTExpr *visitedExpr = nullptr;
+  ASTFieldExpr *visitedFieldExpr = nullptr;
+  ASTFunction *visitedFunction = nullptr;
 
 public:
-  ASTBuilder(TIPParser *parser);
+  ASTBuilder(TIPParser *parser, std::shared_ptr<SymbolInterner> symbols = std::make_shared<SymbolInterner>());
 
   /*! \fn build
    *  \brief Builds an instance of ASTProgram from an ANTLR4 parse tree.
@@ -0,0 +1,12 @@
+#include "SymbolInterner.h"
+
+const std::string *SymbolInterner::intern(std::string_view name) {
+  std::lock_guard<std::mutex> guard(lock);
+  return &*names.emplace(name).first;
+}
+
+const std::string *SymbolInterner::find(std::string_view name) {
+  std::lock_guard<std::mutex> guard(lock);
+  auto found = names.find(std::string(name));
+  return found == names.end() ? nullptr : &*found;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+/*! \class SymbolInterner
+ *  \brief The names of identifiers of one compilation, interned once.
+ *
+ * Every distinct name is stored exactly once, so two names are equal exactly
+ * when their interned strings are the same object.  Later phases key their
+ * tables by these pointers, so a name given as text, e.g., to the
+ * SymbolTable, is found here once and its characters are never hashed or
+ * compared again.  The arenas of the files of a program share one interner, see
+ * ASTArena, so names agree across separately parsed files, and the names
+ * are released with the last of those arenas.  A long running compiler,
+ * e.g., a compile server, thus holds only the names of the programs it is
+ * compiling.  Interning is safe on several threads at once.
+ */
+class SymbolInterner {
+public:
+  SymbolInterner() = default;
+  SymbolInterner(const SymbolInterner &) = delete;
+  SymbolInterner &operator=(const SymbolInterner &) = delete;
+
+  //! \brief The interned copy of a name, which lives as long as the interner.
+  const std::string *intern(std::string_view name);
+
+  //! \brief The interned copy of a name, or nullptr if it was never interned.
+  const std::string *find(std::string_view name);
+
+private:
+  // The elements of an unordered_set are never moved as it grows, so the
+  // pointers handed out stay valid.
+  std::mutex lock;
+  std::unordered_set<std::string> names;
+};
@@ -5,15 +5,16 @@
 /*! \brief Class for a record field access
  */
 class ASTAccessExpr : public ASTExpr {
-  std::unique_ptr<ASTExpr> RECORD;
-  std::string FIELD;
+  ASTExpr *RECORD;
+  const std::string *FIELD;
 public:
-  ASTAccessExpr(std::unique_ptr<ASTExpr> RECORD, const std::string &FIELD)
-      : RECORD(std::move(RECORD)), FIELD(FIELD) {}
-  std::string getField() const { return FIELD; }
-  ASTExpr* getRecord() const { return RECORD.get(); }
+  //! \param FIELD a name interned by the SymbolInterner
+  ASTAccessExpr(ASTExpr *RECORD, const std::string *FIELD)
+      : RECORD(RECORD), FIELD(FIELD) {}
+  const std::string &getField() const { return *FIELD; }
+  ASTExpr* getRecord() const { return RECORD; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
@@ -5,12 +5,12 @@
 /*! \brief Class for alloc expression
  */
 class ASTAllocExpr : public ASTExpr {
-  std::unique_ptr<ASTExpr> INIT;
+  ASTExpr *INIT;
 public:
-  ASTAllocExpr(std::unique_ptr<ASTExpr> INIT) : INIT(std::move(INIT)) {}
-  ASTExpr* getInitializer() const { return INIT.get(); }
+  ASTAllocExpr(ASTExpr *INIT) : INIT(INIT) {}
+  ASTExpr* getInitializer() const { return INIT; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
@@ -6,14 +6,14 @@
 /*! \brief Class for assignment
  */
 class ASTAssignStmt : public ASTStmt {
-  std::unique_ptr<ASTExpr> LHS, RHS;
+  ASTExpr *LHS, *RHS;
 public:
-  ASTAssignStmt(std::unique_ptr<ASTExpr> LHS, std::unique_ptr<ASTExpr> RHS)
-      : LHS(std::move(LHS)), RHS(std::move(RHS)) {}
-  ASTExpr* getLHS() const { return LHS.get(); }
-  ASTExpr* getRHS() const { return RHS.get(); }
+  ASTAssignStmt(ASTExpr *LHS, ASTExpr *RHS)
+      : LHS(LHS), RHS(RHS) {}
+  ASTExpr* getLHS() const { return LHS; }
+  ASTExpr* getRHS() const { return RHS; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
@@ -9,7 +9,27 @@ void ASTBinaryExpr::accept(ASTVisitor * visitor) {
   visitor->endVisit(this);
 }
 
+std::string ASTBinaryExpr::getOpText() const {
+  switch (getOp()) {
+  case ADD:
+    return "+";
+  case SUB:
+    return "-";
+  case MUL:
+    return "*";
+  case DIV:
+    return "/";
+  case GT:
+    return ">";
+  case EQ:
+    return "==";
+  case NE:
+    return "!=";
+  }
+  return "?";
+}
+
 std::ostream& ASTBinaryExpr::print(std::ostream &out) const {
-  out << "(" << *getLeft() << getOp() << *getRight() << ")";
+  out << "(" << *getLeft() << getOpText() << *getRight() << ")";
   return out;
 }
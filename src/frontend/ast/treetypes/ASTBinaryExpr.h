@@ -5,17 +5,23 @@
 /*! \brief Class for a binary operator.
  */
 class ASTBinaryExpr : public ASTExpr {
-  std::string OP;
-  std::unique_ptr<ASTExpr> LEFT, RIGHT;
 public:
-  ASTBinaryExpr(const std::string &OP, std::unique_ptr<ASTExpr> LEFT,
-             std::unique_ptr<ASTExpr> RIGHT)
-      : OP(OP), LEFT(std::move(LEFT)), RIGHT(std::move(RIGHT)) {}
-  std::string getOp() const { return OP; }
-  ASTExpr* getLeft() const { return LEFT.get(); }
-  ASTExpr* getRight() const { return RIGHT.get(); }
+  //! \brief The binary operators of TIP.
+  enum Op { ADD, SUB, MUL, DIV, GT, EQ, NE };
+
+private:
+  Op OP;
+  ASTExpr *LEFT, *RIGHT;
+public:
+  ASTBinaryExpr(Op OP, ASTExpr *LEFT, ASTExpr *RIGHT)
+      : OP(OP), LEFT(LEFT), RIGHT(RIGHT) {}
+  Op getOp() const { return OP; }
+  //! \brief The source text of the operator, e.g., "+" for ADD.
+  std::string getOpText() const;
+  ASTExpr* getLeft() const { return LEFT; }
+  ASTExpr* getRight() const { return RIGHT; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
@@ -1,10 +1,5 @@
 #include "ASTBlockStmt.h"
 #include "ASTVisitor.h"
-#include "ASTinternal.h"
-
-std::vector<ASTStmt*> ASTBlockStmt::getStmts() const {
-  return rawRefs(STMTS);
-}
 
 void ASTBlockStmt::accept(ASTVisitor * visitor) {
   if (visitor->visit(this)) {
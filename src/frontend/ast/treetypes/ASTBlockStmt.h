@@ -5,13 +5,13 @@
 /*! \brief Class for block of statements
  */
 class ASTBlockStmt : public ASTStmt {
-  std::vector<std::unique_ptr<ASTStmt>> STMTS;
+  llvm::ArrayRef<ASTStmt*> STMTS;
 public:
-  ASTBlockStmt(std::vector<std::unique_ptr<ASTStmt>> STMTS)
-      : STMTS(std::move(STMTS)) {}
-  std::vector<ASTStmt*> getStmts() const;
+  ASTBlockStmt(llvm::ArrayRef<ASTStmt*> STMTS)
+      : STMTS(STMTS) {}
+  llvm::ArrayRef<ASTStmt*> getStmts() const { return STMTS; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
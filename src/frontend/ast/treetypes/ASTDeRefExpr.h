@@ -5,12 +5,12 @@
 /*! \brief Class for dereferencing a pointer expression
  */
 class ASTDeRefExpr : public ASTExpr {
-  std::unique_ptr<ASTExpr> PTR;
+  ASTExpr *PTR;
 public:
-  ASTDeRefExpr(std::unique_ptr<ASTExpr> PTR) : PTR(std::move(PTR)) {}
-  ASTExpr* getPtr() const { return PTR.get(); }
+  ASTDeRefExpr(ASTExpr *PTR) : PTR(PTR) {}
+  ASTExpr* getPtr() const { return PTR; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
@@ -5,12 +5,15 @@
 /*! \brief Class for declaring a name, e.g., function, parameter, variable
  */
 class ASTDeclNode : public ASTNode {
-  std::string NAME;
+  const std::string *NAME;
 public:
-  ASTDeclNode(std::string NAME) : NAME(NAME) {}
-  std::string getName() const { return NAME; }
+  //! \param NAME a name interned by the SymbolInterner
+  ASTDeclNode(const std::string *NAME) : NAME(NAME) {}
+  const std::string &getName() const { return *NAME; }
+  //! \brief The interned name, equal for equal names.
+  const std::string *getSymbol() const { return NAME; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
@@ -1,10 +1,5 @@
 #include "ASTDeclStmt.h"
 #include "ASTVisitor.h"
-#include "ASTinternal.h"
-
-std::vector<ASTDeclNode*> ASTDeclStmt::getVars() const {
-  return rawRefs(VARS);
-}
 
 void ASTDeclStmt::accept(ASTVisitor * visitor) {
   if (visitor->visit(this)) {
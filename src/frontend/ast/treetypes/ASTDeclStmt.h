@@ -6,13 +6,13 @@
 /*! \brief Class for local variable declaration statement
  */
 class ASTDeclStmt : public ASTStmt {
-  std::vector<std::unique_ptr<ASTDeclNode>> VARS;
+  llvm::ArrayRef<ASTDeclNode*> VARS;
 public:
-  ASTDeclStmt(std::vector<std::unique_ptr<ASTDeclNode>> VARS) 
-          : VARS(std::move(VARS)) {}
-  std::vector<ASTDeclNode*> getVars() const;
+  ASTDeclStmt(llvm::ArrayRef<ASTDeclNode*> VARS) 
+          : VARS(VARS) {}
+  llvm::ArrayRef<ASTDeclNode*> getVars() const { return VARS; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
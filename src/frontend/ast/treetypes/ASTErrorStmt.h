@@ -6,12 +6,12 @@
 /*! \brief Class for a error statement
  */
 class ASTErrorStmt : public ASTStmt {
-  std::unique_ptr<ASTExpr> ARG;
+  ASTExpr *ARG;
 public:
-  ASTErrorStmt(std::unique_ptr<ASTExpr> ARG) : ARG(std::move(ARG)) {}
-  ASTExpr* getArg() const { return ARG.get(); }
+  ASTErrorStmt(ASTExpr *ARG) : ARG(ARG) {}
+  ASTExpr* getArg() const { return ARG; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
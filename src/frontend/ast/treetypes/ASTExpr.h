@@ -5,7 +5,7 @@
 /*! \brief Abstract class for all expression subtypes
  */
 class ASTExpr : public ASTNode {
-public:
+protected:
   ~ASTExpr() = default;
   // delegating the obligation to override accept, codegen, and print
 };
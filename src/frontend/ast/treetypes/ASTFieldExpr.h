@@ -5,15 +5,16 @@
 /*! \brief Class for the field of a record
  */
 class ASTFieldExpr : public ASTExpr {
-  std::string FIELD;
-  std::unique_ptr<ASTExpr> INIT;
+  const std::string *FIELD;
+  ASTExpr *INIT;
 public:
-  ASTFieldExpr(const std::string &FIELD, std::unique_ptr<ASTExpr> INIT)
-      : FIELD(FIELD), INIT(std::move(INIT)) {}
-  std::string getField() const { return FIELD; }
-  ASTExpr* getInitializer() const { return INIT.get(); }
+  //! \param FIELD a name interned by the SymbolInterner
+  ASTFieldExpr(const std::string *FIELD, ASTExpr *INIT)
+      : FIELD(FIELD), INIT(INIT) {}
+  const std::string &getField() const { return *FIELD; }
+  ASTExpr* getInitializer() const { return INIT; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
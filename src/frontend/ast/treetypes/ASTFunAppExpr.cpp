@@ -1,10 +1,5 @@
 #include "ASTFunAppExpr.h"
 #include "ASTVisitor.h"
-#include "ASTinternal.h"
-
-std::vector<ASTExpr*> ASTFunAppExpr::getActuals() const {
-  return rawRefs(ACTUALS);
-}
 
 void ASTFunAppExpr::accept(ASTVisitor * visitor) {
   if (visitor->visit(this)) {
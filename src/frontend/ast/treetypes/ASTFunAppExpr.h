@@ -5,16 +5,16 @@
 /*! \brief Class for function call expressions
  */
 class ASTFunAppExpr : public ASTExpr {
-  std::unique_ptr<ASTExpr> FUN;
-  std::vector<std::unique_ptr<ASTExpr>> ACTUALS;
+  ASTExpr *FUN;
+  llvm::ArrayRef<ASTExpr*> ACTUALS;
 public:
-  ASTFunAppExpr(std::unique_ptr<ASTExpr> FUN,
-                std::vector<std::unique_ptr<ASTExpr>> ACTUALS)
-      : FUN(std::move(FUN)), ACTUALS(std::move(ACTUALS)) {}
-  ASTExpr* getFunction() const { return FUN.get(); }
-  std::vector<ASTExpr*> getActuals() const;
+  ASTFunAppExpr(ASTExpr *FUN,
+                llvm::ArrayRef<ASTExpr*> ACTUALS)
+      : FUN(FUN), ACTUALS(ACTUALS) {}
+  ASTExpr* getFunction() const { return FUN; }
+  llvm::ArrayRef<ASTExpr*> getActuals() const { return ACTUALS; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
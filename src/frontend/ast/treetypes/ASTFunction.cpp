@@ -1,18 +1,5 @@
 #include "ASTFunction.h"
 #include "ASTVisitor.h"
-#include "ASTinternal.h"
-
-std::vector<ASTDeclNode*> ASTFunction::getFormals() const {
-  return rawRefs(FORMALS);
-}
-
-std::vector<ASTDeclStmt*> ASTFunction::getDeclarations() const {
-  return rawRefs(DECLS);
-}
-
-std::vector<ASTStmt*> ASTFunction::getStmts() const {
-  return rawRefs(BODY);
-}
 
 void ASTFunction::accept(ASTVisitor * visitor) {
   if (visitor->visit(this)) {
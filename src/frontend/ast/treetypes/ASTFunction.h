@@ -8,24 +8,28 @@
 /*! \brief Class for defining the signature, local declarations, and a body of a function.
  */
 class ASTFunction : public ASTNode {
-  std::unique_ptr<ASTDeclNode> DECL;
-  std::vector<std::unique_ptr<ASTDeclNode>> FORMALS;
-  std::vector<std::unique_ptr<ASTDeclStmt>> DECLS;
-  std::vector<std::unique_ptr<ASTStmt>> BODY;
+  ASTDeclNode *DECL;
+  llvm::ArrayRef<ASTDeclNode*> FORMALS;
+  llvm::ArrayRef<ASTDeclStmt*> DECLS;
+  llvm::ArrayRef<ASTStmt*> BODY;
+  const std::string *SOURCE = nullptr;
 public:
-  ASTFunction(std::unique_ptr<ASTDeclNode> DECL, 
-           std::vector<std::unique_ptr<ASTDeclNode>> FORMALS,
-           std::vector<std::unique_ptr<ASTDeclStmt>> DECLS,
-           std::vector<std::unique_ptr<ASTStmt>> BODY)
-      : DECL(std::move(DECL)), FORMALS(std::move(FORMALS)), 
-        DECLS(std::move(DECLS)), BODY(std::move(BODY)) {}
-  ASTDeclNode* getDecl() const { return DECL.get(); };
-  std::string getName() const { return DECL->getName(); };
-  std::vector<ASTDeclNode*> getFormals() const;
-  std::vector<ASTDeclStmt*> getDeclarations() const;
-  std::vector<ASTStmt*> getStmts() const;
+  ASTFunction(ASTDeclNode *DECL, 
+           llvm::ArrayRef<ASTDeclNode*> FORMALS,
+           llvm::ArrayRef<ASTDeclStmt*> DECLS,
+           llvm::ArrayRef<ASTStmt*> BODY)
+      : DECL(DECL), FORMALS(FORMALS), DECLS(DECLS), BODY(BODY) {}
+  ASTDeclNode* getDecl() const { return DECL; };
+  const std::string &getName() const { return DECL->getName(); };
+  llvm::ArrayRef<ASTDeclNode*> getFormals() const { return FORMALS; }
+  llvm::ArrayRef<ASTDeclStmt*> getDeclarations() const { return DECLS; }
+  llvm::ArrayRef<ASTStmt*> getStmts() const { return BODY; }
+  //! \brief Record the file the function was parsed from, an interned name.
+  void setSourceFile(const std::string *file) { SOURCE = file; }
+  //! \brief The file the function was parsed from, or nullptr if it is not known.
+  const std::string *getSourceFile() const { return SOURCE; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
@@ -6,21 +6,20 @@
 /*! \brief Class for if-then-else.
  */
 class ASTIfStmt : public ASTStmt {
-  std::unique_ptr<ASTExpr> COND;
-  std::unique_ptr<ASTStmt> THEN, ELSE;
+  ASTExpr *COND;
+  ASTStmt *THEN, *ELSE;
 public:
-  ASTIfStmt(std::unique_ptr<ASTExpr> COND, std::unique_ptr<ASTStmt> THEN,
-            std::unique_ptr<ASTStmt> ELSE)
-      : COND(std::move(COND)), THEN(std::move(THEN)), ELSE(std::move(ELSE)) {}
-  ASTExpr* getCondition() const { return COND.get(); }
-  ASTStmt* getThen() const { return THEN.get(); }
+  ASTIfStmt(ASTExpr *COND, ASTStmt *THEN, ASTStmt *ELSE)
+      : COND(COND), THEN(THEN), ELSE(ELSE) {}
+  ASTExpr* getCondition() const { return COND; }
+  ASTStmt* getThen() const { return THEN; }
 
   /*! \fn getElse
    * \return Else statement if it exists and nullptr otherwise.
    */
-  ASTStmt* getElse() const { return ELSE.get(); }
+  ASTStmt* getElse() const { return ELSE; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
@@ -3,6 +3,7 @@
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Value.h"
+#include "llvm/ADT/ArrayRef.h"
 #include <memory>
 #include <string>
 #include <vector>
@@ -11,17 +12,20 @@
 // Forward declare the visitor to resolve circular dependency
 class ASTVisitor;
 
+// Forward declare the code generation state, which is defined by codegen
+class CodeGenContext;
+
 /*! \brief Abstract base class for all AST nodes.
  *
  * ASTNodes define the elements of the program in a tree structured form.
- * A key concept to undestand is that of "ownership".   Every node in the
- * tree is "owned" by its parent.  The parent maintains a "unique pointer"
- * to each of its children.  This greatly simplifies memory management as
- * the tree can be reclaimed once its root is no longer needed.  It is 
- * important to understand that the "unique pointer" is only used to manage
- * the lifetime of the child nodes.  The values of those pointers can be
- * passed around freely to other parts of the compiler that want to view
- * the ASTNodes.
+ * The nodes of a tree are allocated in the ASTArena of its program, which
+ * owns them and releases them all at once when the program is destroyed.
+ * A parent refers to its children through plain pointers, and lists of
+ * children through array references into the arena, which can be passed
+ * around freely to other parts of the compiler that want to view the
+ * ASTNodes.  As the arena never runs the destructors of nodes, a node may
+ * not own any other memory; names in particular are interned by the
+ * SymbolInterner of the program.
  *
  * Each node has information about the line and column in the source
  * program on which the element begins.  Subtypes define "<<" operator
@@ -35,8 +39,6 @@ class ASTNode {
   int line = 0;
   int column = 0;
 public:
-  virtual ~ASTNode() = default;
-
   /*! \fn accept
    *  \brief Visit the children of this node and apply the visitor.
    *
@@ -58,9 +60,10 @@ public:
    * due to the fact that a high-degree of control on the ordering of the 
    * nodes is required.
    *
+   * \param ctx The state of the code generation this node is part of.
    * \return LLVM value holding an representation of the generated code.
    */
-  virtual llvm::Value* codegen() = 0;
+  virtual llvm::Value* codegen(CodeGenContext &ctx) = 0;
 
   void setLocation(int l, int c) { line = l; column = c; }
   int getLine() { return line; }
@@ -71,5 +74,8 @@ public:
   }
 
 protected:
+  // Nodes are never deleted through a pointer to their base, see ASTArena
+  ~ASTNode() = default;
+
   virtual std::ostream& print(std::ostream &out) const = 0;
 };
@@ -10,7 +10,7 @@ public:
   ASTNumberExpr(int VAL) : VAL(VAL) {}
   int getValue() const { return VAL; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
@@ -1,18 +1,36 @@
 #include "ASTProgram.h"
 #include "ASTVisitor.h"
-#include "ASTinternal.h"
 
-std::vector<ASTFunction*> ASTProgram::getFunctions() const {
-  return rawRefs(FUNCTIONS);
+ASTProgram::ASTProgram(std::unique_ptr<ASTArena> arena, const std::vector<ASTFunction*> &FUNCTIONS)
+    : arena(std::move(arena)) {
+  this->FUNCTIONS = this->arena->copy(FUNCTIONS);
+  for (auto fn : getFunctions()) {
+    // Keep the first definition, duplicates are reported by the symbol table
+    functionsByName.emplace(fn->getName(), fn);
+  }
+}
+
+std::unique_ptr<ASTProgram> ASTProgram::merge(std::vector<std::unique_ptr<ASTProgram>> programs) {
+  auto arena = programs.empty() ? std::make_unique<ASTArena>()
+                                : std::make_unique<ASTArena>(programs.front()->arena->getSymbols());
+  std::vector<ASTFunction*> functions;
+  for (auto &program : programs) {
+    functions.insert(functions.end(), program->FUNCTIONS.begin(), program->FUNCTIONS.end());
+    arena->adopt(std::move(program->arena));
+  }
+  return std::make_unique<ASTProgram>(std::move(arena), functions);
+}
+
+void ASTProgram::setSourceFile(std::string_view file) {
+  auto name = arena->intern(file);
+  for (auto fn : getFunctions()) {
+    fn->setSourceFile(name);
+  }
 }
 
 ASTFunction * ASTProgram::findFunctionByName(std::string name) {
-    for(auto fn : getFunctions()) {
-        if(fn->getName() == name) {
-            return fn;
-        }
-    }
-    return nullptr;
+    auto fn = functionsByName.find(name);
+    return fn == functionsByName.end() ? nullptr : fn->second;
 }
 
 void ASTProgram::accept(ASTVisitor * visitor) {
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "ASTArena.h"
 #include "ASTFunction.h"
 #include <ostream>
+#include <string_view>
+#include <unordered_map>
 
 class SemanticAnalysis;
 
@@ -13,16 +16,60 @@ class SemanticAnalysis;
  */
 class ASTProgram {
   std::string name;
-  std::vector<std::unique_ptr<ASTFunction>> FUNCTIONS;
+  std::unique_ptr<ASTArena> arena;
+  llvm::ArrayRef<ASTFunction*> FUNCTIONS;
+  std::unordered_map<std::string, ASTFunction*> functionsByName;
 public:
-  ASTProgram(std::vector<std::unique_ptr<ASTFunction>> FUNCTIONS)
-      : FUNCTIONS(std::move(FUNCTIONS)) {}
+  /*! \brief A program of functions built in the given arena.
+   *
+   * The program owns the arena, so all of its nodes live as long as it does.
+   */
+  ASTProgram(std::unique_ptr<ASTArena> arena, const std::vector<ASTFunction*> &FUNCTIONS);
+  /*! \brief Join the programs parsed from several files into one program.
+   *
+   * The functions are kept in the order of the programs and the nodes are
+   * not copied: the new program takes over the arenas of the programs, which
+   * must share an interner, see FrontEnd::parse.  Functions defined in more than one of them are not an error here, they
+   * are reported by the symbol table like those defined twice in one file.
+   */
+  static std::unique_ptr<ASTProgram> merge(std::vector<std::unique_ptr<ASTProgram>> programs);
+  //! \brief Record the file all functions of the program were parsed from.
+  void setSourceFile(std::string_view file);
   void setName(std::string n) { name = n; }
   std::string getName() const { return name; }
-  std::vector<ASTFunction*> getFunctions() const;
+  llvm::ArrayRef<ASTFunction*> getFunctions() const { return FUNCTIONS; }
+  //! \brief The arena holding the nodes of the program.
+  const ASTArena &getArena() const { return *arena; }
+  /*! \brief The first function with the given name, or nullptr.
+   *
+   * Functions are indexed by name so this is a constant time lookup.
+   */
   ASTFunction * findFunctionByName(std::string);
   void accept(ASTVisitor * visitor);
-  std::unique_ptr<llvm::Module> codegen(SemanticAnalysis* st, std::string name);
+  /*! \brief Generate the program into a new module in the given LLVM context.
+   *
+   * The context must outlive the module and must not be shared with a
+   * compilation running concurrently on another thread.  With gc the heap
+   * is managed by the garbage collector of the runtime.
+   */
+  std::unique_ptr<llvm::Module> codegen(SemanticAnalysis* st, std::string name,
+                                        llvm::LLVMContext &context, bool gc = false);
+  /*! \brief Generate a subset of the functions into a new module.
+   *
+   * Only the given functions are defined in the module.  Exactly one
+   * partition of a program defines the globals shared by all functions, the
+   * others refer to them, so that the partitions can be linked together into
+   * a complete program.  With declareAll every function of the program is
+   * declared and the partitions referring to the globals see the contents of
+   * the dispatch table, which lets calls through it be folded.  Otherwise
+   * only the functions the partition refers to are declared, which keeps
+   * the partitions of large programs small.
+   */
+  std::unique_ptr<llvm::Module> codegenPartition(SemanticAnalysis* st, std::string name,
+                                                 llvm::LLVMContext &context,
+                                                 const std::vector<ASTFunction*> &functions,
+                                                 bool definesGlobals, bool gc = false,
+                                                 bool declareAll = true);
 
   friend std::ostream& operator<<(std::ostream& os, const ASTProgram& obj) {
     return obj.print(os);
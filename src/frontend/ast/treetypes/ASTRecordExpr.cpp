@@ -1,10 +1,5 @@
 #include "ASTRecordExpr.h"
 #include "ASTVisitor.h"
-#include "ASTinternal.h"
-
-std::vector<ASTFieldExpr*> ASTRecordExpr::getFields() const {
-  return rawRefs(FIELDS);
-}
 
 void ASTRecordExpr::accept(ASTVisitor * visitor) {
   if (visitor->visit(this)) {
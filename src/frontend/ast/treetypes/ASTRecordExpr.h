@@ -6,13 +6,13 @@
 /*! \brief Class for defining a record.
  */
 class ASTRecordExpr : public ASTExpr {
-  std::vector<std::unique_ptr<ASTFieldExpr>> FIELDS;
+  llvm::ArrayRef<ASTFieldExpr*> FIELDS;
 public:
-  ASTRecordExpr(std::vector<std::unique_ptr<ASTFieldExpr>> FIELDS)
-      : FIELDS(std::move(FIELDS)) {}
-  std::vector<ASTFieldExpr*> getFields() const;
+  ASTRecordExpr(llvm::ArrayRef<ASTFieldExpr*> FIELDS)
+      : FIELDS(FIELDS) {}
+  llvm::ArrayRef<ASTFieldExpr*> getFields() const { return FIELDS; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
@@ -5,12 +5,12 @@
 /*! \brief Class for referencing the address of an expression.
  */
 class ASTRefExpr : public ASTExpr {
-  std::unique_ptr<ASTExpr> VAR;
+  ASTExpr *VAR;
 public:
-  ASTRefExpr(std::unique_ptr<ASTExpr> VAR) : VAR(std::move(VAR)) {}
-  ASTExpr* getVar() const { return VAR.get(); }
+  ASTRefExpr(ASTExpr *VAR) : VAR(VAR) {}
+  ASTExpr* getVar() const { return VAR; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
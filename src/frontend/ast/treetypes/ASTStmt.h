@@ -5,7 +5,7 @@
 /*! \brief Base class for all statement nodes.
  */
 class ASTStmt : public ASTNode {
-public:
+protected:
   ~ASTStmt() = default;
   // delegating the obligation to override the accept, codegen and print 
 };
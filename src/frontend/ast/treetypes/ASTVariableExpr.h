@@ -1,16 +1,37 @@
 #pragma once
 
 #include "ASTExpr.h"
+#include "ASTDeclNode.h"
 
 /*! \brief Class for referencing a variable.
+ *
+ * The symbol table binds each reference to the declaration it refers to,
+ * either a local or parameter of the enclosing function or a function, and
+ * to the slot of that declaration: locals and parameters are numbered in the
+ * order they are declared, parameters first, and functions in the order of
+ * the program.  Later phases resolve names through the binding.
  */
 class ASTVariableExpr : public ASTExpr {
-  std::string NAME;
+  const std::string *NAME;
+  ASTDeclNode *DECL = nullptr;
+  int SLOT = -1;
+  bool FUNCTION = false;
 public:
-  ASTVariableExpr(std::string NAME) : NAME(NAME) {}
-  std::string getName() const { return NAME; }
+  //! \param NAME a name interned by the SymbolInterner
+  ASTVariableExpr(const std::string *NAME) : NAME(NAME) {}
+  const std::string &getName() const { return *NAME; }
+  //! \brief The interned name, equal for equal names.
+  const std::string *getSymbol() const { return NAME; }
+  //! \brief Bind the reference to the declaration it refers to.
+  void bind(ASTDeclNode *decl, int slot, bool function) { DECL = decl; SLOT = slot; FUNCTION = function; }
+  //! \brief The declaration referred to, or nullptr before the symbol table is built.
+  ASTDeclNode *getDecl() const { return DECL; }
+  //! \brief The slot of the declaration among the locals of its function or the functions.
+  int getSlot() const { return SLOT; }
+  //! \brief Whether the reference is to a function rather than a local.
+  bool isFunction() const { return FUNCTION; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
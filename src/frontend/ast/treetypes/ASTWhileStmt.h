@@ -6,15 +6,15 @@
 /*! \brief Class for a while loop.
  */
 class ASTWhileStmt : public ASTStmt {
-  std::unique_ptr<ASTExpr> COND;
-  std::unique_ptr<ASTStmt> BODY;
+  ASTExpr *COND;
+  ASTStmt *BODY;
 public:
-  ASTWhileStmt(std::unique_ptr<ASTExpr> COND, std::unique_ptr<ASTStmt> BODY)
-      : COND(std::move(COND)), BODY(std::move(BODY)) {}
-  ASTExpr* getCondition() const { return COND.get(); }
-  ASTStmt* getBody() const { return BODY.get(); }
+  ASTWhileStmt(ASTExpr *COND, ASTStmt *BODY)
+      : COND(COND), BODY(BODY) {}
+  ASTExpr* getCondition() const { return COND; }
+  ASTStmt* getBody() const { return BODY; }
   void accept(ASTVisitor * visitor) override;
-  llvm::Value* codegen() override;
+  llvm::Value* codegen(CodeGenContext &ctx) override;
 
 protected:
   std::ostream& print(std::ostream &out) const override;
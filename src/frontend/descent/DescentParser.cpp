@@ -0,0 +1,347 @@
+#include "DescentParser.h"
+#include "ParseError.h"
+
+namespace { // Anonymous namespace for local helpers
+
+/*
+ * ANTLR gives the alternatives of a left recursive rule precedences that
+ * decrease in the order they are written, from 16 for the first of the 16
+ * alternatives of expr down to 1.  A binary operator applies when its
+ * precedence is at least that of the expression being parsed, and its
+ * right operand is parsed at the next higher precedence so that operators
+ * associate to the left.  The operand of a prefix operator is parsed at the
+ * precedence of the operator.
+ */
+const int FUNAPP_PRECEDENCE = 16;
+const int ACCESS_PRECEDENCE = 15;
+const int DEREF_PRECEDENCE = 14;
+const int REF_PRECEDENCE = 12;
+const int ALLOC_PRECEDENCE = 4;
+
+// The precedence of a binary operator, or 0 for other tokens
+int binaryPrecedence(Scanner::Kind kind) {
+  switch (kind) {
+  case Scanner::MUL:
+  case Scanner::DIV:
+    return 11;
+  case Scanner::ADD:
+  case Scanner::SUB:
+    return 10;
+  case Scanner::GT:
+    return 9;
+  case Scanner::EQ:
+  case Scanner::NE:
+    return 8;
+  default:
+    return 0;
+  }
+}
+
+// The operator of a binary operator token
+ASTBinaryExpr::Op binaryOp(Scanner::Kind kind) {
+  switch (kind) {
+  case Scanner::MUL:
+    return ASTBinaryExpr::MUL;
+  case Scanner::DIV:
+    return ASTBinaryExpr::DIV;
+  case Scanner::ADD:
+    return ASTBinaryExpr::ADD;
+  case Scanner::SUB:
+    return ASTBinaryExpr::SUB;
+  case Scanner::GT:
+    return ASTBinaryExpr::GT;
+  case Scanner::EQ:
+    return ASTBinaryExpr::EQ;
+  default:
+    return ASTBinaryExpr::NE;
+  }
+}
+
+template <typename T> T *located(T *node, const Scanner::Token &start) {
+  node->setLocation(start.line, start.column);
+  return node;
+}
+
+}
+
+DescentParser::DescentParser(std::string_view source, std::shared_ptr<SymbolInterner> symbols)
+    : scanner(source), arena(std::make_unique<ASTArena>(std::move(symbols))) {}
+
+std::unique_ptr<ASTProgram> DescentParser::parse(std::string_view source,
+                                                 std::shared_ptr<SymbolInterner> symbols) {
+  DescentParser parser(source, std::move(symbols));
+  return parser.parseProgram();
+}
+
+/*
+ * Tokens are scanned as the parser looks at them, so a lexical error after
+ * a syntax error is not reported, as in the ANTLR front end.
+ */
+const Scanner::Token &DescentParser::peek(size_t k) {
+  while (lookahead.size() <= k) {
+    lookahead.push_back(scanner.next());
+  }
+  return lookahead[k];
+}
+
+Scanner::Token DescentParser::take() {
+  auto token = peek();
+  lookahead.pop_front();
+  return token;
+}
+
+Scanner::Token DescentParser::expect(Scanner::Kind kind, const char *expected) {
+  if (peek().kind != kind) {
+    fail(peek(), "mismatched input " + Scanner::display(peek()) + " expecting " + expected);
+  }
+  return take();
+}
+
+void DescentParser::fail(const Scanner::Token &token, const std::string &message) {
+  throw ParseError(message + "@" + std::to_string(token.line) + ":" + std::to_string(token.column));
+}
+
+/*
+ * As with the program rule of the grammar, parsing stops at the first token
+ * after a function that cannot start another function.
+ */
+std::unique_ptr<ASTProgram> DescentParser::parseProgram() {
+  std::vector<ASTFunction*> functions;
+  do {
+    functions.push_back(parseFunction());
+  } while (peek().kind == Scanner::IDENTIFIER);
+  return std::make_unique<ASTProgram>(std::move(arena), functions);
+}
+
+ASTFunction *DescentParser::parseFunction() {
+  auto start = peek();
+  auto name = parseNameDeclaration();
+
+  std::vector<ASTDeclNode*> params;
+  expect(Scanner::LPAREN, "'('");
+  if (peek().kind != Scanner::RPAREN) {
+    params.push_back(parseNameDeclaration());
+    while (peek().kind == Scanner::COMMA) {
+      take();
+      params.push_back(parseNameDeclaration());
+    }
+  }
+  expect(Scanner::RPAREN, "{',', ')'}");
+  expect(Scanner::LBRACE, "'{'");
+
+  std::vector<ASTDeclStmt*> decls;
+  while (peek().kind == Scanner::KVAR) {
+    decls.push_back(parseDeclaration());
+  }
+
+  // return statement is always the last statement in a TIP function body
+  std::vector<ASTStmt*> body;
+  while (peek().kind != Scanner::KRETURN) {
+    body.push_back(parseStatement());
+  }
+  body.push_back(parseReturnStmt());
+  expect(Scanner::RBRACE, "'}'");
+
+  return located(arena->make<ASTFunction>(name, arena->copy(params), arena->copy(decls), arena->copy(body)),
+                 start);
+}
+
+ASTDeclNode *DescentParser::parseNameDeclaration() {
+  auto name = expect(Scanner::IDENTIFIER, "IDENTIFIER");
+  return located(arena->make<ASTDeclNode>(arena->intern(name.text)), name);
+}
+
+ASTDeclStmt *DescentParser::parseDeclaration() {
+  auto start = take();
+  std::vector<ASTDeclNode*> vars;
+  vars.push_back(parseNameDeclaration());
+  while (peek().kind == Scanner::COMMA) {
+    take();
+    vars.push_back(parseNameDeclaration());
+  }
+  expect(Scanner::SEMI, "{',', ';'}");
+  return located(arena->make<ASTDeclStmt>(arena->copy(vars)), start);
+}
+
+/*
+ * A statement starting with '{' may be a block or an assignment to a record
+ * expression.  ANTLR chooses the block unless only the assignment can parse,
+ * which the two tokens after the brace decide for any valid program.
+ */
+bool DescentParser::startsRecordStatement() {
+  if (peek(1).kind == Scanner::IDENTIFIER) {
+    return peek(2).kind == Scanner::COLON;
+  }
+  if (peek(1).kind == Scanner::RBRACE) {
+    auto kind = peek(2).kind;
+    return kind == Scanner::DOT || kind == Scanner::ASSIGN ||
+           (binaryPrecedence(kind) > 0 && kind != Scanner::MUL && kind != Scanner::SUB);
+  }
+  return false;
+}
+
+ASTStmt *DescentParser::parseStatement() {
+  auto start = peek();
+  switch (start.kind) {
+  case Scanner::LBRACE: {
+    if (startsRecordStatement()) {
+      break;
+    }
+    take();
+    std::vector<ASTStmt*> stmts;
+    while (peek().kind != Scanner::RBRACE) {
+      stmts.push_back(parseStatement());
+    }
+    take();
+    return located(arena->make<ASTBlockStmt>(arena->copy(stmts)), start);
+  }
+  case Scanner::KWHILE: {
+    take();
+    expect(Scanner::LPAREN, "'('");
+    auto cond = parseExpr();
+    expect(Scanner::RPAREN, "')'");
+    auto body = parseStatement();
+    return located(arena->make<ASTWhileStmt>(cond, body), start);
+  }
+  case Scanner::KIF: {
+    take();
+    expect(Scanner::LPAREN, "'('");
+    auto cond = parseExpr();
+    expect(Scanner::RPAREN, "')'");
+    auto thenBody = parseStatement();
+
+    // else is optional and belongs to the closest if
+    ASTStmt *elseBody = nullptr;
+    if (peek().kind == Scanner::KELSE) {
+      take();
+      elseBody = parseStatement();
+    }
+    return located(arena->make<ASTIfStmt>(cond, thenBody, elseBody), start);
+  }
+  case Scanner::KOUTPUT: {
+    take();
+    auto arg = parseExpr();
+    expect(Scanner::SEMI, "';'");
+    return located(arena->make<ASTOutputStmt>(arg), start);
+  }
+  case Scanner::KERROR: {
+    take();
+    auto arg = parseExpr();
+    expect(Scanner::SEMI, "';'");
+    return located(arena->make<ASTErrorStmt>(arg), start);
+  }
+  default:
+    break;
+  }
+
+  auto lhs = parseExpr();
+  expect(Scanner::ASSIGN, "'='");
+  auto rhs = parseExpr();
+  expect(Scanner::SEMI, "';'");
+  return located(arena->make<ASTAssignStmt>(lhs, rhs), start);
+}
+
+ASTStmt *DescentParser::parseReturnStmt() {
+  auto start = expect(Scanner::KRETURN, "'return'");
+  auto arg = parseExpr();
+  expect(Scanner::SEMI, "';'");
+  return located(arena->make<ASTReturnStmt>(arg), start);
+}
+
+/*
+ * Nodes for operators applied to an expression are located where the text
+ * of that expression starts, which for a parenthesized expression is the
+ * parenthesis rather than the start of the expression inside it.
+ */
+ASTExpr *DescentParser::parseExpr(int precedence) {
+  auto start = peek();
+  auto expr = parsePrimary();
+
+  while (true) {
+    auto kind = peek().kind;
+    if (kind == Scanner::LPAREN && FUNAPP_PRECEDENCE >= precedence) {
+      take();
+      std::vector<ASTExpr*> args;
+      if (peek().kind != Scanner::RPAREN) {
+        args.push_back(parseExpr());
+        while (peek().kind == Scanner::COMMA) {
+          take();
+          args.push_back(parseExpr());
+        }
+      }
+      expect(Scanner::RPAREN, "{',', ')'}");
+      expr = located(arena->make<ASTFunAppExpr>(expr, arena->copy(args)), start);
+    } else if (kind == Scanner::DOT && ACCESS_PRECEDENCE >= precedence) {
+      take();
+      auto field = expect(Scanner::IDENTIFIER, "IDENTIFIER");
+      expr = located(arena->make<ASTAccessExpr>(expr, arena->intern(field.text)), start);
+    } else if (binaryPrecedence(kind) > 0 && binaryPrecedence(kind) >= precedence) {
+      take();
+      auto rhs = parseExpr(binaryPrecedence(kind) + 1);
+      expr = located(arena->make<ASTBinaryExpr>(binaryOp(kind), expr, rhs), start);
+    } else {
+      return expr;
+    }
+  }
+}
+
+ASTExpr *DescentParser::parsePrimary() {
+  auto start = peek();
+  switch (start.kind) {
+  case Scanner::IDENTIFIER:
+    take();
+    return located(arena->make<ASTVariableExpr>(arena->intern(start.text)), start);
+  case Scanner::NUMBER:
+    take();
+    return located(arena->make<ASTNumberExpr>(std::stoi(std::string(start.text))), start);
+  case Scanner::SUB: {
+    take();
+    auto number = expect(Scanner::NUMBER, "NUMBER");
+    return located(arena->make<ASTNumberExpr>(-std::stoi(std::string(number.text))), start);
+  }
+  case Scanner::MUL:
+    take();
+    return located(arena->make<ASTDeRefExpr>(parseExpr(DEREF_PRECEDENCE)), start);
+  case Scanner::AMP:
+    take();
+    return located(arena->make<ASTRefExpr>(parseExpr(REF_PRECEDENCE)), start);
+  case Scanner::KALLOC:
+    take();
+    return located(arena->make<ASTAllocExpr>(parseExpr(ALLOC_PRECEDENCE)), start);
+  case Scanner::KINPUT:
+    take();
+    return located(arena->make<ASTInputExpr>(), start);
+  case Scanner::KNULL:
+    take();
+    return located(arena->make<ASTNullExpr>(), start);
+  case Scanner::LBRACE:
+    return parseRecordExpr();
+  case Scanner::LPAREN: {
+    // The node of the inner expression keeps its own location
+    take();
+    auto expr = parseExpr();
+    expect(Scanner::RPAREN, "')'");
+    return expr;
+  }
+  default:
+    fail(start, "no viable alternative at input " + Scanner::display(start));
+  }
+}
+
+ASTExpr *DescentParser::parseRecordExpr() {
+  auto start = take();
+  std::vector<ASTFieldExpr*> fields;
+  if (peek().kind != Scanner::RBRACE) {
+    while (true) {
+      auto name = expect(Scanner::IDENTIFIER, "IDENTIFIER");
+      expect(Scanner::COLON, "':'");
+      fields.push_back(located(arena->make<ASTFieldExpr>(arena->intern(name.text), parseExpr()), name));
+      if (peek().kind != Scanner::COMMA) {
+        break;
+      }
+      take();
+    }
+  }
+  expect(Scanner::RBRACE, "{',', '}'}");
+  return located(arena->make<ASTRecordExpr>(arena->copy(fields)), start);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "AST.h"
+#include "Scanner.h"
+#include <deque>
+#include <memory>
+#include <string_view>
+
+/*! \class DescentParser
+ *  \brief A hand written recursive descent parser for TIP.
+ *
+ * The ANTLR generated parser builds a parse tree that ASTBuilder then walks
+ * to build the AST.  This parser builds the AST directly as it recognizes
+ * the grammar of TIP.g4, with expressions parsed by precedence climbing
+ * over the precedences ANTLR derives from the order of the alternatives of
+ * the expr rule.  It builds the same AST, with the same source locations,
+ * as the ANTLR front end for every program that front end accepts.
+ *
+ * Syntax errors are reported with a ParseError at the same location as
+ * the ANTLR front end reports them, with a message in the same form,
+ * though the expected tokens listed may differ.
+ */
+class DescentParser {
+public:
+  /*! \brief Parse program text and return an AST.
+   *
+   * \param source the program text, which is not copied
+   * \param symbols the interner of the names of the program
+   * \throws ParseError for lexical and syntax errors
+   */
+  static std::unique_ptr<ASTProgram>
+  parse(std::string_view source, std::shared_ptr<SymbolInterner> symbols = std::make_shared<SymbolInterner>());
+
+private:
+  Scanner scanner;
+  std::deque<Scanner::Token> lookahead;
+  std::unique_ptr<ASTArena> arena;
+
+  DescentParser(std::string_view source, std::shared_ptr<SymbolInterner> symbols);
+
+  const Scanner::Token &peek(size_t k = 0);
+  Scanner::Token take();
+  Scanner::Token expect(Scanner::Kind kind, const char *expected);
+  [[noreturn]] void fail(const Scanner::Token &token, const std::string &message);
+
+  std::unique_ptr<ASTProgram> parseProgram();
+  ASTFunction *parseFunction();
+  ASTDeclNode *parseNameDeclaration();
+  ASTDeclStmt *parseDeclaration();
+  ASTStmt *parseStatement();
+  ASTStmt *parseReturnStmt();
+  ASTExpr *parseExpr(int precedence = 0);
+  ASTExpr *parsePrimary();
+  ASTExpr *parseRecordExpr();
+  bool startsRecordStatement();
+};
@@ -0,0 +1,151 @@
+#include "Scanner.h"
+#include "ParseError.h"
+
+namespace { // Anonymous namespace for local helpers
+
+// Keywords take priority over identifiers of the same length
+const std::pair<std::string_view, Scanner::Kind> keywords[] = {
+    {"alloc", Scanner::KALLOC},   {"input", Scanner::KINPUT}, {"while", Scanner::KWHILE},
+    {"if", Scanner::KIF},         {"else", Scanner::KELSE},   {"var", Scanner::KVAR},
+    {"return", Scanner::KRETURN}, {"null", Scanner::KNULL},   {"output", Scanner::KOUTPUT},
+    {"error", Scanner::KERROR},
+};
+
+bool isLetter(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+// Text in error messages with control characters escaped as ANTLR does
+std::string escape(std::string_view text) {
+  std::string escaped;
+  for (char c : text) {
+    switch (c) {
+    case '\n':
+      escaped += "\\n";
+      break;
+    case '\r':
+      escaped += "\\r";
+      break;
+    case '\t':
+      escaped += "\\t";
+      break;
+    default:
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+}
+
+Scanner::Scanner(std::string_view source) : source(source) {}
+
+void Scanner::advance(size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    if (source[position] == '\n') {
+      line++;
+      column = 0;
+    } else {
+      column++;
+    }
+    position++;
+  }
+}
+
+void Scanner::skipSpaceAndComments() {
+  while (position < source.size()) {
+    char c = source[position];
+    if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+      advance(1);
+    } else if (source.compare(position, 2, "//") == 0) {
+      size_t end = position + 2;
+      while (end < source.size() && source[end] != '\n' && source[end] != '\r') {
+        end++;
+      }
+      advance(end - position);
+    } else if (source.compare(position, 2, "/*") == 0) {
+      // An unterminated comment is not a comment, so its '/' is a division
+      auto end = source.find("*/", position + 2);
+      if (end == std::string_view::npos) {
+        return;
+      }
+      advance(end + 2 - position);
+    } else {
+      return;
+    }
+  }
+}
+
+Scanner::Token Scanner::next() {
+  skipSpaceAndComments();
+  Token token{END, source.substr(position, 0), line, column};
+  if (position >= source.size()) {
+    return token;
+  }
+
+  size_t length = 1;
+  char c = source[position];
+  char following = position + 1 < source.size() ? source[position + 1] : '\0';
+  if (isLetter(c)) {
+    while (position + length < source.size() &&
+           (isLetter(source[position + length]) || isDigit(source[position + length]))) {
+      length++;
+    }
+    token.kind = IDENTIFIER;
+    for (auto &keyword : keywords) {
+      if (keyword.first == source.substr(position, length)) {
+        token.kind = keyword.second;
+      }
+    }
+  } else if (isDigit(c)) {
+    while (position + length < source.size() && isDigit(source[position + length])) {
+      length++;
+    }
+    token.kind = NUMBER;
+  } else {
+    switch (c) {
+    case '*': token.kind = MUL; break;
+    case '/': token.kind = DIV; break;
+    case '+': token.kind = ADD; break;
+    case '-': token.kind = SUB; break;
+    case '>': token.kind = GT; break;
+    case '(': token.kind = LPAREN; break;
+    case ')': token.kind = RPAREN; break;
+    case '{': token.kind = LBRACE; break;
+    case '}': token.kind = RBRACE; break;
+    case ',': token.kind = COMMA; break;
+    case ';': token.kind = SEMI; break;
+    case '.': token.kind = DOT; break;
+    case '&': token.kind = AMP; break;
+    case ':': token.kind = COLON; break;
+    case '=':
+      token.kind = following == '=' ? EQ : ASSIGN;
+      length = following == '=' ? 2 : 1;
+      break;
+    case '!':
+      if (following == '=') {
+        token.kind = NE;
+        length = 2;
+        break;
+      }
+      // ANTLR reports the text up to and including the first character it could not match
+      throw ParseError("token recognition error at: '" + escape(source.substr(position, 2)) + "'@" +
+                       std::to_string(line) + ":" + std::to_string(column));
+    default:
+      throw ParseError("token recognition error at: '" + escape(source.substr(position, 1)) + "'@" +
+                       std::to_string(line) + ":" + std::to_string(column));
+    }
+  }
+
+  token.text = source.substr(position, length);
+  advance(length);
+  return token;
+}
+
+std::string Scanner::display(const Token &token) {
+  return "'" + (token.kind == END ? std::string("<EOF>") : escape(token.text)) + "'";
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+/*! \class Scanner
+ *  \brief A hand written lexer for TIP.
+ *
+ * The scanner recognizes the tokens of the lexer rules in TIP.g4 with the
+ * same longest match rules as the ANTLR generated TIPLexer, and skips the
+ * same whitespace and comments.  Tokens refer to the text of the source,
+ * which must outlive them.  Lines are numbered from 1 and columns from 0,
+ * as in ANTLR.
+ */
+class Scanner {
+public:
+  //! \brief The kinds of tokens.
+  enum Kind {
+    END, IDENTIFIER, NUMBER,
+    KALLOC, KINPUT, KWHILE, KIF, KELSE, KVAR, KRETURN, KNULL, KOUTPUT, KERROR,
+    MUL, DIV, ADD, SUB, GT, EQ, NE,
+    LPAREN, RPAREN, LBRACE, RBRACE, COMMA, SEMI, ASSIGN, DOT, AMP, COLON
+  };
+
+  //! \brief A token and where it starts in the source.
+  struct Token {
+    Kind kind;
+    std::string_view text;
+    int line;
+    int column;
+  };
+
+  explicit Scanner(std::string_view source);
+
+  /*! \brief The next token of the source, END once it is exhausted.
+   *
+   * \throws ParseError with ANTLR's message for an unrecognized character
+   */
+  Token next();
+
+  /*! \brief How a token is shown in error messages, as ANTLR shows it.
+   *
+   * \return the quoted text of the token, or '<EOF>' for END
+   */
+  static std::string display(const Token &token);
+
+private:
+  std::string_view source;
+  size_t position = 0;
+  int line = 1;
+  int column = 0;
+
+  void advance(size_t count);
+  void skipSpaceAndComments();
+};
@@ -95,7 +95,7 @@ void PrettyPrinter::endVisit(ASTBinaryExpr * element) {
   std::string leftString = visitResults.back();
   visitResults.pop_back();
 
-  visitResults.push_back("(" + leftString + " " + element->getOp() + " " + rightString + ")");
+  visitResults.push_back("(" + leftString + " " + element->getOpText() + " " + rightString + ")");
 }
 
 void PrettyPrinter::endVisit(ASTInputExpr * element) {
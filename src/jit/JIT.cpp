@@ -0,0 +1,120 @@
+#include "JIT.h"
+#include "InternalError.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/Support/TargetSelect.h"
+#include "loguru.hpp"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+/*
+ * The parts of the runtime library, rtlib/tip_rtlib.c, referenced by the
+ * compiled code along with the entry point that runs a program.
+ */
+extern "C" {
+int64_t _tip_input();
+void _tip_output(int64_t x);
+void _tip_error(int64_t x);
+void _tip_main_undefined();
+char *_tip_heap_refill(int64_t size);
+extern char *_tip_heap_next;
+extern char *_tip_heap_end;
+char *_tip_gc_alloc(int64_t size, int64_t references);
+extern struct GCFrame *_tip_gc_top;
+int _tip_run(int64_t (*tipMain)(), int64_t numInputs, int64_t *inputArray, int argc, char *argv[]);
+}
+
+namespace {
+
+void initializeTarget() {
+  static bool initialized = [] {
+    InitializeNativeTarget();
+    InitializeNativeTargetAsmPrinter();
+    return true;
+  }();
+  (void)initialized;
+}
+
+std::unique_ptr<LLJIT> check(Expected<std::unique_ptr<LLJIT>> jit) {
+  if (!jit) {
+    throw InternalError("cannot create JIT: " + toString(jit.takeError()));
+  }
+  return std::move(*jit);
+}
+
+void check(llvm::Error err, const std::string &what) {
+  if (err) {
+    throw InternalError(what + ": " + toString(std::move(err)));
+  }
+}
+
+}
+
+JIT::JIT(std::unique_ptr<Module> module, std::unique_ptr<LLVMContext> context, bool runtimeLinked)
+    : runtimeLinked(runtimeLinked) {
+  initializeTarget();
+  jit = check(LLJITBuilder().create());
+
+  auto &dylib = jit->getMainJITDylib();
+  MangleAndInterner mangle(jit->getExecutionSession(), jit->getDataLayout());
+  auto symbol = [](void *address) {
+    return JITEvaluatedSymbol(pointerToJITTargetAddress(address), JITSymbolFlags::Exported);
+  };
+  SymbolMap runtime;
+  runtime[mangle("_tip_input")] = symbol((void *)&_tip_input);
+  runtime[mangle("_tip_output")] = symbol((void *)&_tip_output);
+  runtime[mangle("_tip_error")] = symbol((void *)&_tip_error);
+  runtime[mangle("_tip_main_undefined")] = symbol((void *)&_tip_main_undefined);
+  runtime[mangle("_tip_heap_refill")] = symbol((void *)&_tip_heap_refill);
+  runtime[mangle("_tip_heap_next")] = symbol((void *)&_tip_heap_next);
+  runtime[mangle("_tip_heap_end")] = symbol((void *)&_tip_heap_end);
+  runtime[mangle("_tip_gc_alloc")] = symbol((void *)&_tip_gc_alloc);
+  runtime[mangle("_tip_gc_top")] = symbol((void *)&_tip_gc_top);
+  check(dylib.define(absoluteSymbols(std::move(runtime))), "cannot define runtime symbols");
+
+  // Optimized code may call the C library, e.g., memset
+  auto process = DynamicLibrarySearchGenerator::GetForCurrentProcess(jit->getDataLayout().getGlobalPrefix());
+  if (!process) {
+    throw InternalError("cannot search process symbols: " + toString(process.takeError()));
+  }
+  dylib.addGenerator(std::move(*process));
+
+  LOG_S(1) << "Adding module " << module->getModuleIdentifier() << " to the JIT";
+  check(jit->addIRModule(ThreadSafeModule(std::move(module), std::move(context))),
+        "cannot add module to JIT");
+}
+
+void *JIT::lookup(const std::string &name) {
+  auto symbol = jit->lookup(name);
+  if (!symbol) {
+    throw InternalError("cannot find " + name + ": " + toString(symbol.takeError()));
+  }
+  return jitTargetAddressToPointer<void *>(symbol->getAddress());
+}
+
+/*
+ * Materializing the symbols compiles the whole program, so all of the
+ * lookups happen before the program starts.  Only a program with the
+ * runtime linked in, see CodeGenerator::linkRuntime, is entered through
+ * main.  Otherwise main is never looked up, since the process symbols
+ * could resolve it to the main of tipc itself.
+ */
+int JIT::run(const std::string &programName, const std::vector<std::string> &args) {
+  std::vector<char *> argv;
+  argv.push_back(const_cast<char *>(programName.c_str()));
+  for (auto &arg : args) {
+    argv.push_back(const_cast<char *>(arg.c_str()));
+  }
+  argv.push_back(nullptr);
+  auto argc = (int) args.size() + 1;
+
+  if (runtimeLinked) {
+    auto entry = (int (*)(int, char *[])) lookup("main");
+    return entry(argc, argv.data());
+  }
+
+  auto tipMain = (int64_t (*)()) lookup("_tip_main");
+  auto numInputs = (int64_t *) lookup("_tip_num_inputs");
+  auto inputArray = (int64_t *) lookup("_tip_input_array");
+  return _tip_run(tipMain, *numInputs, inputArray, argc, argv.data());
+}
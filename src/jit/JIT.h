@@ -0,0 +1,56 @@
+#pragma once
+
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/*! \class JIT
+ *  \brief Run compiled programs in process.
+ *
+ * The module produced by the code generator is compiled to memory with an
+ * ORC LLJIT instance instead of being emitted as bitcode.  The runtime
+ * library is linked into tipc itself, so the references of the program to
+ * it are resolved to the functions and variables of the running compiler,
+ * and calls to the C library are resolved against the process.  This skips
+ * writing the bitcode, running clang and starting a new process, which
+ * dominate the time to run short programs.
+ */
+class JIT {
+public:
+  /*! \brief Compile the program to memory.
+   *
+   * \param module the program, which must have been created in context
+   * \param context the context owning the module
+   * \param runtimeLinked whether the runtime library was linked into the
+   *        program, which then has its own main
+   * \throws InternalError if the module cannot be compiled
+   */
+  JIT(std::unique_ptr<llvm::Module> module, std::unique_ptr<llvm::LLVMContext> context,
+      bool runtimeLinked = false);
+
+  /*! \brief The address of a function or global defined by the program.
+   *
+   * \throws InternalError if the program does not define the symbol
+   */
+  void *lookup(const std::string &name);
+
+  /*! \brief Run the program as its executable would.
+   *
+   * The arguments are passed to the TIP main function and its result is
+   * written to stdout.  The runtime exits the process if the program fails.
+   * If the runtime library was linked into the program its exit handlers
+   * refer to the compiled code, so the process must exit before the JIT is
+   * destroyed.
+   * \param programName the name reported for the program
+   * \param args the arguments to the TIP main function
+   * \return the exit status of the program
+   */
+  int run(const std::string &programName, const std::vector<std::string> &args);
+
+private:
+  std::unique_ptr<llvm::orc::LLJIT> jit;
+  bool runtimeLinked;
+};
@@ -1,35 +1,79 @@
 #include "Optimizer.h"
+#include "InternalError.h"
 
-#include "llvm/IR/LegacyPassManager.h"
-#include "llvm/Transforms/Utils.h"
-#include "llvm/Transforms/InstCombine/InstCombine.h"
-#include "llvm/Transforms/Scalar.h"
-#include "llvm/Transforms/Scalar/GVN.h"
+#include "llvm/IR/PassManager.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/Error.h"
 
 using namespace llvm;
 
-void Optimizer::optimize(Module* theModule) {
-  // Create a pass manager to simplify generated module
-  auto TheFPM = std::make_unique<legacy::FunctionPassManager>(theModule);
+namespace { // Anonymous namespace for local helpers
 
-  // Promote allocas to registers.
-  TheFPM->add(createPromoteMemoryToRegisterPass());
+/*
+ * The analysis managers the passes of a pipeline query.  They must outlive
+ * the pipeline and be registered with the pass builder that creates it.
+ */
+struct Analyses {
+  LoopAnalysisManager LAM;
+  FunctionAnalysisManager FAM;
+  CGSCCAnalysisManager CGAM;
+  ModuleAnalysisManager MAM;
 
-  // Do simple "peephole" optimizations
-  TheFPM->add(createInstructionCombiningPass());
+  explicit Analyses(PassBuilder &PB) {
+    PB.registerModuleAnalyses(MAM);
+    PB.registerCGSCCAnalyses(CGAM);
+    PB.registerFunctionAnalyses(FAM);
+    PB.registerLoopAnalyses(LAM);
+    PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+  }
+};
+
+PassBuilder::OptimizationLevel toPassBuilderLevel(Optimizer::OptLevel level) {
+  switch (level) {
+  case Optimizer::O1:
+    return PassBuilder::OptimizationLevel::O1;
+  case Optimizer::O2:
+    return PassBuilder::OptimizationLevel::O2;
+  case Optimizer::O3:
+    return PassBuilder::OptimizationLevel::O3;
+  case Optimizer::Os:
+    return PassBuilder::OptimizationLevel::Os;
+  default:
+    throw InternalError("no pass builder pipeline for optimization level " + std::to_string(level));
+  }
+}
+
+}
 
-  // Reassociate expressions.
-  TheFPM->add(createReassociatePass());
+void Optimizer::optimize(Module* theModule, OptLevel level) {
+  if (level == O0) {
+    return;
+  }
+
+  PassBuilder PB;
+  Analyses analyses(PB);
+
+  // The default pipelines include the inliner, IPSCCP, GlobalOpt and the loop passes
+  ModulePassManager MPM = PB.buildPerModuleDefaultPipeline(toPassBuilderLevel(level));
+  MPM.run(*theModule, analyses.MAM);
+}
 
-  // Eliminate Common SubExpressions.
-  TheFPM->add(createGVNPass());
+void Optimizer::optimize(Module* theModule, const std::string &pipeline) {
+  PassBuilder PB;
+  Analyses analyses(PB);
 
-  // Simplify the control flow graph (deleting unreachable blocks, etc).
-  TheFPM->add(createCFGSimplificationPass());
+  ModulePassManager MPM;
+  if (auto err = PB.parsePassPipeline(MPM, pipeline)) {
+    throw InternalError("invalid pass pipeline: " + toString(std::move(err)));
+  }
+  MPM.run(*theModule, analyses.MAM);
+}
 
-  // initialize and run simplification pass on each function
-  TheFPM->doInitialization();
-  for (auto &fun : theModule->getFunctionList()) {
-    TheFPM->run(fun);
+std::string Optimizer::checkPipeline(const std::string &pipeline) {
+  PassBuilder PB;
+  ModulePassManager MPM;
+  if (auto err = PB.parsePassPipeline(MPM, pipeline)) {
+    return toString(std::move(err));
   }
+  return "";
 }
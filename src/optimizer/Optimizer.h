@@ -1,17 +1,42 @@
 #pragma once
 
 #include "llvm/IR/Module.h"
+#include <string>
 
 /*! \class Optimizer
  *  \brief routines to optimize generated code.
+ *
+ * Optimization is performed with the pipelines of LLVM's new pass manager.
+ * Either one of the standard pipelines, selected by an optimization level,
+ * or a custom pipeline given in the textual form accepted by opt's
+ * -passes option, e.g., "function(sroa,instcombine),globalopt", is run.
  */
 class Optimizer {
 public:
 
-  /*! \brief optimize LLVM module. 
+  //! \brief The optimization levels, they mirror those of clang.
+  enum OptLevel { O0, O1, O2, O3, Os };
+
+  /*! \brief optimize LLVM module.
+   *
+   * Apply the standard optimization pipeline for the level to the given LLVM
+   * module.  At O0 the module is left unchanged.
+   * \param theModule an LLVM module to be optimized
+   * \param level the optimization level
+   */
+  static void optimize(llvm::Module* theModule, OptLevel level);
+
+  /*! \brief optimize LLVM module with a custom pipeline.
    *
-   * Apply a series of basic optimization passes to the given LLVM module.
    * \param theModule an LLVM module to be optimized
+   * \param pipeline a textual pass pipeline description
+   * \throws InternalError if the pipeline is not valid
+   */
+  static void optimize(llvm::Module* theModule, const std::string &pipeline);
+
+  /*! \brief Check a textual pass pipeline description.
+   *
+   * \return a description of the problem or the empty string if it is valid
    */
-  static void optimize(llvm::Module* theModule);
+  static std::string checkPipeline(const std::string &pipeline);
 };
@@ -3,14 +3,17 @@
 #include "CheckAssignable.h"
 #include "TypeInference.h"
 
-std::unique_ptr<SemanticAnalysis> SemanticAnalysis::analyze(ASTProgram* ast) {
+std::unique_ptr<SemanticAnalysis> SemanticAnalysis::analyze(ASTProgram* ast, unsigned jobs) {
   auto symTable = SymbolTable::build(ast);
 
   CheckAssignable::check(ast);
 
-  auto typeResults = TypeInference::check(ast, symTable.get());
+  auto typeResults = TypeInference::check(ast, symTable.get(), jobs);
 
-  return std::make_unique<SemanticAnalysis>(std::move(symTable), std::move(typeResults));
+  auto recordLayouts = RecordLayouts::compute(ast, symTable.get());
+
+  return std::make_unique<SemanticAnalysis>(std::move(symTable), std::move(typeResults),
+                                            std::move(recordLayouts));
 }
 
 SymbolTable* SemanticAnalysis::getSymbolTable() {
@@ -21,3 +24,6 @@ TypeInference* SemanticAnalysis::getTypeResults() {
   return typeResults.get();
 }; 
 
+RecordLayouts* SemanticAnalysis::getRecordLayouts() {
+  return recordLayouts.get();
+};
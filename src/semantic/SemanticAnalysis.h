@@ -4,23 +4,27 @@
 #include "ASTNode.h"
 #include "SymbolTable.h"
 #include "TypeInference.h"
+#include "RecordLayouts.h"
 #include <memory>
 
 /*! \class SemanticAnalysis
  *  \brief Stores the results of semantic analysis passes.
  *
  * This class provides the analyze method to run a set of semantic analyses, including
- * l-value checking for assignment statements, proper use of symbols, and type checking.   
+ * l-value checking for assignment statements, proper use of symbols, and type checking.
+ * The record layouts used by code generation are derived from the types.
  * \sa SymbolTable
  * \sa TypeInference
  */
 class SemanticAnalysis {
   std::unique_ptr<SymbolTable> symTable;
   std::unique_ptr<TypeInference> typeResults;
+  std::unique_ptr<RecordLayouts> recordLayouts;
 
 public:
-  SemanticAnalysis(std::unique_ptr<SymbolTable> s, std::unique_ptr<TypeInference> t) 
-          : symTable(std::move(s)), typeResults(std::move(t)) {}
+  SemanticAnalysis(std::unique_ptr<SymbolTable> s, std::unique_ptr<TypeInference> t,
+                   std::unique_ptr<RecordLayouts> r)
+          : symTable(std::move(s)), typeResults(std::move(t)), recordLayouts(std::move(r)) {}
 
   /*! \fn analyze
    *  \brief Perform semantic analysis on program AST.
@@ -30,9 +34,10 @@ public:
    * results are transfered to caller.
    * \sa SemanticError
    * \param ast The program AST
+   * \param jobs The number of threads used for type inference
    * \return The unique pointer to the semantic analysis structure.
    */
-  static std::unique_ptr<SemanticAnalysis> analyze(ASTProgram* ast); 
+  static std::unique_ptr<SemanticAnalysis> analyze(ASTProgram* ast, unsigned jobs = 1);
 
   /*! \fn getSymbolTable
    *  \brief Returns the symbol table computed for the program.
@@ -45,4 +50,10 @@ public:
    * \sa TypeInference
    */
   TypeInference* getTypeResults();
+
+  /*! \fn getRecordLayouts
+   *  \brief Returns the memory layouts of the records of the program.
+   * \sa RecordLayouts
+   */
+  RecordLayouts* getRecordLayouts();
 };
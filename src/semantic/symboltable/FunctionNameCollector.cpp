@@ -1,10 +1,10 @@
 #include "FunctionNameCollector.h"
 #include "SemanticError.h"
 
-std::map<std::string, ASTDeclNode*> FunctionNameCollector::build(ASTProgram* p) {
+std::vector<ASTDeclNode*> FunctionNameCollector::build(ASTProgram* p) {
   FunctionNameCollector visitor;
   p->accept(&visitor);
-  return visitor.fMap;
+  return visitor.functions;
 }
 
 /*
@@ -14,10 +14,17 @@ std::map<std::string, ASTDeclNode*> FunctionNameCollector::build(ASTProgram* p)
 bool FunctionNameCollector::visit(ASTFunction * element) {
   auto decl = element->getDecl();
   // check to see if the name has been declared
-  if (fMap.count(decl->getName()) == 0) {
-    fMap.insert(std::pair<std::string, ASTDeclNode*>(decl->getName(), decl));
-  } else {
+  auto first = fMap.emplace(decl->getSymbol(), element);
+  if (first.second) {
+    functions.push_back(decl);
+  } else if (element->getSourceFile() == nullptr) {
     throw SemanticError("Symbol error on line " + std::to_string(decl->getLine()) + ": function name " + decl->getName() + " already declared\n");
+  } else {
+    // In a program of several files name both definitions by their file
+    auto firstFn = first.first->second;
+    throw SemanticError("Symbol error on line " + std::to_string(decl->getLine()) + " of " + *element->getSourceFile() +
+                        ": function name " + decl->getName() + " already declared on line " +
+                        std::to_string(firstFn->getDecl()->getLine()) + " of " + *firstFn->getSourceFile() + "\n");
   }
   return false;
 }
@@ -1,21 +1,25 @@
 #pragma once
 
 #include "ASTVisitor.h"
+#include <unordered_map>
+#include <vector>
 
 /*! \class FunctionNameCollector
  *  \brief Collects the names of functions declared in the program.
  *
  * The function name builder visits a restricted set of nodes, just functions,
  * It records the name in the function map and checks that a name is declared at most once.
+ * In a program joined from several files the error names the files of both declarations.
  * Errors are reported by throwing SemanticError exceptions.
  * \sa SemanticError
  */
 class FunctionNameCollector : public ASTVisitor {
 public:
   FunctionNameCollector() = default;
-  // this map is public so that the static method can access it
-  std::map<std::string, ASTDeclNode*> fMap;
-  static std::map<std::string, ASTDeclNode*> build(ASTProgram* p);
+  // these are public so that the static method can access them
+  std::unordered_map<const std::string*, ASTFunction*> fMap;
+  std::vector<ASTDeclNode*> functions;
+  //! \return the declarations of the functions in the order of the program
+  static std::vector<ASTDeclNode*> build(ASTProgram* p);
   virtual bool visit(ASTFunction * element) override;
 };
-
@@ -1,25 +1,30 @@
 #include "LocalNameCollector.h"
 #include "SemanticError.h"
 
-std::map<ASTDeclNode*, std::map<std::string, ASTDeclNode*>> 
+LocalNameCollector::LocalNameCollector(const std::vector<ASTDeclNode*> &functions) : functions(functions) {
+  for (int slot = 0; slot < functions.size(); slot++) {
+    fMap.emplace(functions[slot]->getSymbol(), slot);
+  }
+}
+
+std::unordered_map<ASTDeclNode*, std::vector<ASTDeclNode*>>
 LocalNameCollector::build(ASTProgram* p, 
-                          std::map<std::string, ASTDeclNode*> fMap) {
-  LocalNameCollector visitor(fMap);
+                          const std::vector<ASTDeclNode*> &functions) {
+  LocalNameCollector visitor(functions);
   p->accept(&visitor);
   return visitor.lMap;
 }
 
 bool LocalNameCollector::visit(ASTFunction * element) {
   curMap.clear();
-  funName = element->getName();
+  curLocals.clear();
+  funName = element->getDecl()->getSymbol();
   first = true;
   return true;
 }
 
 void LocalNameCollector::endVisit(ASTFunction * element) {
-  auto decl = element->getDecl();
-  lMap.insert(std::pair<ASTDeclNode*,
-                        std::map<std::string, ASTDeclNode*>>(decl, curMap));
+  lMap.emplace(element->getDecl(), std::move(curLocals));
 }
 
 void LocalNameCollector::endVisit(ASTDeclNode * element) {
@@ -27,11 +32,11 @@ void LocalNameCollector::endVisit(ASTDeclNode * element) {
     // first declaration found in visiting a function is the function name which is in the function map so we skip it
     first = false;
   } else {
-    if (fMap.count(element->getName()) == 0) {
-      if (curMap.count(element->getName()) == 0) {
-        curMap.insert(std::pair<std::string, ASTDeclNode*>(element->getName(), element));
+    if (fMap.count(element->getSymbol()) == 0) {
+      if (curMap.emplace(element->getSymbol(), curLocals.size()).second) {
+        curLocals.push_back(element);
       } else {
-        throw SemanticError("Symbol error line " + std::to_string(element->getLine()) + " in column " + std::to_string(element->getColumn()) +": " + element->getName() + " redeclared in function " + funName + "\n");
+        throw SemanticError("Symbol error line " + std::to_string(element->getLine()) + " in column " + std::to_string(element->getColumn()) +": " + element->getName() + " redeclared in function " + *funName + "\n");
       }
     } else {
       throw SemanticError("Symbol error line " + std::to_string(element->getLine()) + " in column " + std::to_string(element->getColumn()) +": " + element->getName() + " already declared as function\n");
@@ -40,10 +45,15 @@ void LocalNameCollector::endVisit(ASTDeclNode * element) {
 }
 
 void LocalNameCollector::endVisit(ASTVariableExpr * element) {
-  if (fMap.count(element->getName()) == 0) {
-    if (curMap.count(element->getName()) == 0) {
-      throw SemanticError("Symbol error line " + std::to_string(element->getLine()) + " in column " + std::to_string(element->getColumn()) +": " + element->getName() + " undeclared in function " + funName + "\n");
-    }
+  auto local = curMap.find(element->getSymbol());
+  if (local != curMap.end()) {
+    element->bind(curLocals[local->second], local->second, false);
+    return;
+  }
+  auto function = fMap.find(element->getSymbol());
+  if (function != fMap.end()) {
+    element->bind(functions[function->second], function->second, true);
+    return;
   }
+  throw SemanticError("Symbol error line " + std::to_string(element->getLine()) + " in column " + std::to_string(element->getColumn()) +": " + element->getName() + " undeclared in function " + *funName + "\n");
 }
-
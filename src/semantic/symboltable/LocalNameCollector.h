@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ASTVisitor.h"
+#include <unordered_map>
+#include <vector>
 
 /*! \class LocalNameCollector
  *  \brief Records local names declared in each function and checks for errors.
@@ -9,27 +11,33 @@
  * \sa Function to create the instance of the local map and make it current.
  * \sa DeclNode to install declared names in the current local map and
  * to check that a name is declared at most once.
- * \sa VariableExpr to ensure that the referenced name is in the map.
+ * \sa VariableExpr to ensure that the referenced name is in the map and to
+ * bind the reference to its declaration and slot.
+ * Names are looked up by their interned symbol.  The slot of a local is its
+ * position in the list of locals of its function, parameters first, and the
+ * slot of a function is its position in the program.
  * Errors are reported by throwing SemanticError exceptions.
  * \sa SemanticError
  */
 class LocalNameCollector : public ASTVisitor {
-  std::map<std::string, ASTDeclNode*> curMap;
-  std::map<std::string, ASTDeclNode*> fMap;
-  std::string funName;
+  std::unordered_map<const std::string*, int> curMap;
+  std::vector<ASTDeclNode*> curLocals;
+  std::unordered_map<const std::string*, int> fMap;
+  std::vector<ASTDeclNode*> functions;
+  const std::string *funName = nullptr;
   bool first = true;
 public:
-  LocalNameCollector(std::map<std::string, ASTDeclNode*> fMap) : fMap(fMap) {}
+  LocalNameCollector(const std::vector<ASTDeclNode*> &functions);
 
   // this map is public so that the static method can access it
-  std::map<ASTDeclNode*, std::map<std::string, ASTDeclNode*>> lMap;
+  std::unordered_map<ASTDeclNode*, std::vector<ASTDeclNode*>> lMap;
 
-  static std::map<ASTDeclNode*, std::map<std::string, ASTDeclNode*>> build(
-      ASTProgram* p, std::map<std::string, ASTDeclNode*> fMap);
+  //! \return the locals of each function, indexed by their slot
+  static std::unordered_map<ASTDeclNode*, std::vector<ASTDeclNode*>> build(
+      ASTProgram* p, const std::vector<ASTDeclNode*> &functions);
 
   virtual bool visit(ASTFunction * element) override;
   virtual void endVisit(ASTFunction * element) override;
   virtual void endVisit(ASTDeclNode * element) override;
   virtual void endVisit(ASTVariableExpr * element) override;
 };
-
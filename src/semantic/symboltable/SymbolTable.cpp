@@ -3,47 +3,74 @@
 #include "LocalNameCollector.h"
 #include "FieldNameCollector.h"
 
+#include <algorithm>
 #include <sstream>
 
-std::unique_ptr<SymbolTable> SymbolTable::build(ASTProgram* p) {
-  auto fMap = FunctionNameCollector::build(p);
-  auto lMap = LocalNameCollector::build(p, fMap);
-  auto fSet = FieldNameCollector::build(p); 
-  return std::make_unique<SymbolTable>(fMap, lMap, fSet);
+namespace {
+
+// Orders declarations by name, the order in which they are listed.
+bool nameLess(ASTDeclNode *a, ASTDeclNode *b) {
+  return a->getName() < b->getName();
 }
 
-ASTDeclNode* SymbolTable::getFunction(std::string s) {
-  auto func = functionNames.find(s);
-  if(func == functionNames.end()) {
-    return nullptr;
-  }
-  return func->second;
+void sortByName(std::vector<ASTDeclNode*> &decls) {
+  std::sort(decls.begin(), decls.end(), nameLess);
 }
 
-std::vector<ASTDeclNode*> SymbolTable::getFunctions() {
-  std::vector<ASTDeclNode*> funDecls;
-  for (auto &pair : functionNames) {
-    funDecls.push_back(pair.second); 
+std::unordered_map<const std::string*, ASTDeclNode*> bySymbol(const std::vector<ASTDeclNode*> &decls) {
+  std::unordered_map<const std::string*, ASTDeclNode*> index;
+  for (auto d : decls) {
+    index.emplace(d->getSymbol(), d);
   }
-  return funDecls;
+  return index;
 }
 
-ASTDeclNode* SymbolTable::getLocal(std::string s, ASTDeclNode* f) {
-  auto lMap = localNames.find(f)->second;
-  auto local = lMap.find(s);
-  if(local == lMap.end()) {
-    return nullptr;
-  }
-  return local->second;
+// The declaration of the given symbol in an index, or nullptr.
+ASTDeclNode* findBySymbol(const std::unordered_map<const std::string*, ASTDeclNode*> &index,
+                          const std::string *symbol) {
+  auto found = index.find(symbol);
+  return found == index.end() ? nullptr : found->second;
 }
 
-std::vector<ASTDeclNode*> SymbolTable::getLocals(ASTDeclNode* f) {
-  auto lMap = localNames.find(f)->second;
-  std::vector<ASTDeclNode*> localDecls;
-  for (auto &pair : lMap) {
-    localDecls.push_back(pair.second); 
+}
+
+SymbolTable::SymbolTable(std::shared_ptr<SymbolInterner> symbols,
+                         std::vector<ASTDeclNode*> functions,
+                         std::unordered_map<ASTDeclNode*, std::vector<ASTDeclNode*>> lMap,
+                         std::vector<std::string> fSet)
+    : symbols(std::move(symbols)), functionNames(std::move(functions)), localNames(std::move(lMap)),
+      fieldNames(std::move(fSet)) {
+  sortByName(functionNames);
+  functionSymbols = bySymbol(functionNames);
+  for (auto &locals : localNames) {
+    sortByName(locals.second);
+    localSymbols.emplace(locals.first, bySymbol(locals.second));
   }
-  return localDecls;
+}
+
+std::unique_ptr<SymbolTable> SymbolTable::build(ASTProgram* p) {
+  auto functions = FunctionNameCollector::build(p);
+  auto lMap = LocalNameCollector::build(p, functions);
+  auto fSet = FieldNameCollector::build(p); 
+  return std::make_unique<SymbolTable>(p->getArena().getSymbols(), std::move(functions), std::move(lMap),
+                                       std::move(fSet));
+}
+
+// A name that was never interned is not the name of any declaration
+ASTDeclNode* SymbolTable::getFunction(const std::string &s) {
+  return findBySymbol(functionSymbols, symbols->find(s));
+}
+
+const std::vector<ASTDeclNode*> &SymbolTable::getFunctions() {
+  return functionNames;
+}
+
+ASTDeclNode* SymbolTable::getLocal(const std::string &s, ASTDeclNode* f) {
+  return findBySymbol(localSymbols.find(f)->second, symbols->find(s));
+}
+
+const std::vector<ASTDeclNode*> &SymbolTable::getLocals(ASTDeclNode* f) {
+  return localNames.find(f)->second;
 }
 
 
@@ -54,13 +81,13 @@ std::vector<std::string> SymbolTable::getFields() {
 void SymbolTable::print(std::ostream &s) {
   s << "Functions : {"; 
   auto skip = true;
-  for (auto e : functionNames) {
+  for (auto f : functionNames) {
     if (skip) {
       skip = false;
-      s << e.first;
+      s << f->getName();
       continue;
     }
-    s << ", " + e.first; 
+    s << ", " + f->getName(); 
   }
   s << "}\n";
 
@@ -76,16 +103,17 @@ void SymbolTable::print(std::ostream &s) {
   }
   s << "}\n";
 
-  for (auto f : localNames) {
-    s << "Locals for function " + f.first->getName() + " : {";
+  // Functions are listed by name since the order of their nodes varies between runs
+  for (auto f : functionNames) {
+    s << "Locals for function " + f->getName() + " : {";
     skip = true;
-    for (auto l : f.second) {
+    for (auto l : localNames.find(f)->second) {
       if (skip) {
         skip = false;
-        s << l.first;
+        s << l->getName();
         continue;
       }
-      s << ", " + l.first; 
+      s << ", " + l->getName(); 
     }
     s << "}\n";
   }
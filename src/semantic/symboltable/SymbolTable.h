@@ -1,50 +1,69 @@
 #pragma once
 
 #include "ASTVisitor.h"
+#include "SymbolInterner.h"
 
-#include <map>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 /*! \class SymbolTable
  *  \brief Performs symbol analysis and records results for subsequent phases.
  *
  * The symbol table maps names of identifiers to declaration nodes.
- * There is a global map of for function names and a local map for
+ * There is a global map of for function names and a list of locals for
  * each function.  In addition it records the set of field names used
  * in the program.  Errors are reported by raising a SemanticError exception.
+ *
+ * Building the table also binds every variable reference of the program to
+ * its declaration and slot, see ASTVariableExpr, so that later phases do not
+ * look names up again.  Declarations are indexed by their interned names,
+ * so a lookup finds the interned copy of the name it is given once and
+ * then compares pointers.  The declarations are listed ordered by name,
+ * which is sorted once, when the table is built.
  * \sa SemanticError
  */ 
 class SymbolTable {
-  std::map<std::string, ASTDeclNode*> functionNames;
-  std::map<ASTDeclNode*, std::map<std::string, ASTDeclNode*>> localNames;
+  // The interner of the names of the program, see SymbolInterner
+  std::shared_ptr<SymbolInterner> symbols;
+  // Functions and the locals of each function, ordered by name when built
+  std::vector<ASTDeclNode*> functionNames;
+  std::unordered_map<ASTDeclNode*, std::vector<ASTDeclNode*>> localNames;
+  // The same declarations indexed by their interned names
+  std::unordered_map<const std::string*, ASTDeclNode*> functionSymbols;
+  std::unordered_map<ASTDeclNode*, std::unordered_map<const std::string*, ASTDeclNode*>> localSymbols;
   std::vector<std::string> fieldNames;
 public:
-  SymbolTable(std::map<std::string, ASTDeclNode*> fMap,
-              std::map<ASTDeclNode*, std::map<std::string, ASTDeclNode*>> lMap,
-              std::vector<std::string> fSet)
-      : functionNames(fMap), localNames(lMap), fieldNames(fSet) {}
+  SymbolTable(std::shared_ptr<SymbolInterner> symbols,
+              std::vector<ASTDeclNode*> functions,
+              std::unordered_map<ASTDeclNode*, std::vector<ASTDeclNode*>> lMap,
+              std::vector<std::string> fSet);
 
   /*! \brief Return the declaration node for a given function name.
    * \param s The Function name
    * \return The declaration node of the function
    */
-  ASTDeclNode* getFunction(std::string s);
+  ASTDeclNode* getFunction(const std::string &s);
 
   /*! \brief Return the declaration nodes for functions in the program.
+   *
+   * They are ordered by name.
    */
-  std::vector<ASTDeclNode*> getFunctions();
+  const std::vector<ASTDeclNode*> &getFunctions();
 
   /*! \brief Return the declaration node for local or a parameter in a function.
    * \param s The local or parameter name
    * \param f The declaration node of the function
    * \return The declaration node of the local or parameter
    */
-  ASTDeclNode* getLocal(std::string s, ASTDeclNode* f);
+  ASTDeclNode* getLocal(const std::string &s, ASTDeclNode* f);
 
   /*! \brief Return the declaration nodes for locals and parameters in a function.
+   *
+   * They are ordered by name.
    * \param f The declaration node of the function.
    */
-  std::vector<ASTDeclNode*> getLocals(ASTDeclNode* f);
+  const std::vector<ASTDeclNode*> &getLocals(ASTDeclNode* f);
 
   /*! \brief Returns the record field names referenced in the program.
    */
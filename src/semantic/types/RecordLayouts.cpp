@@ -0,0 +1,133 @@
+#include "RecordLayouts.h"
+#include "ASTAccessExpr.h"
+#include "ASTRecordExpr.h"
+#include "InternalError.h"
+#include "SemanticError.h"
+#include "TipFunction.h"
+#include "TipInt.h"
+#include "TipRecord.h"
+#include "TypeConstraintCollectVisitor.h"
+#include "Unifier.h"
+#include "loguru.hpp"
+#include <map>
+#include <set>
+
+namespace { // Anonymous namespace for local helpers
+
+/*
+ * Collects the type constraints of the program along with the type variable
+ * of the record at each record and access expression and the fields used.
+ */
+class RecordCollectVisitor: public TypeConstraintCollectVisitor {
+public:
+  struct Site {
+    ASTExpr* expr;
+    std::shared_ptr<TipType> record;
+    std::vector<std::string> fields;
+  };
+  std::vector<Site> sites;
+
+  explicit RecordCollectVisitor(SymbolTable *symbols) : TypeConstraintCollectVisitor(symbols) {}
+
+  void endVisit(ASTRecordExpr * element) override {
+    TypeConstraintCollectVisitor::endVisit(element);
+    std::vector<std::string> fields;
+    for (auto &f : element->getFields()) {
+      fields.push_back(f->getField());
+    }
+    sites.push_back(Site{element, astToVar(element), fields});
+  }
+
+  void endVisit(ASTAccessExpr * element) override {
+    TypeConstraintCollectVisitor::endVisit(element);
+    sites.push_back(Site{element, astToVar(element->getRecord()), {element->getField()}});
+  }
+};
+
+struct TermHash {
+  std::size_t operator()(const std::shared_ptr<TipType> &t) const { return t->hash(); }
+};
+struct TermEqual {
+  bool operator()(const std::shared_ptr<TipType> &t1, const std::shared_ptr<TipType> &t2) const {
+    return *t1 == *t2;
+  }
+};
+
+}
+
+std::unique_ptr<RecordLayouts> RecordLayouts::compute(ASTProgram* ast, SymbolTable* symbols) {
+  auto allFields = symbols->getFields();
+
+  RecordCollectVisitor visitor(symbols);
+  ast->accept(&visitor);
+
+  // Without records there is nothing to lay out
+  if (visitor.sites.empty()) {
+    return std::make_unique<RecordLayouts>(std::vector<Layout>(), std::vector<std::vector<bool>>(),
+                                           std::unordered_map<ASTExpr*, int>(), false);
+  }
+
+  std::vector<std::set<std::string>> used;
+  std::vector<std::map<std::string, bool>> fieldReferences;
+  std::unordered_map<ASTExpr*, int> layoutOf;
+  try {
+    Unifier unifier(visitor.getCollectedConstraints());
+    unifier.solve();
+
+    // Each class of record types has a distinct representative
+    std::unordered_map<std::shared_ptr<TipType>, int, TermHash, TermEqual> classes;
+    for (auto &site : visitor.sites) {
+      auto rep = unifier.representative(site.record);
+      auto cls = classes.emplace(rep, used.size());
+      if (cls.second) {
+        used.emplace_back();
+
+        // The fields of a class share their types, so the first site decides
+        fieldReferences.emplace_back();
+        auto record = std::dynamic_pointer_cast<TipRecord>(rep);
+        for (int i = 0; record != nullptr && i < record->getNames().size(); i++) {
+          fieldReferences.back()[record->getNames()[i]] =
+              mayHoldReference(unifier.representative(record->getInits()[i]));
+        }
+      }
+      used[cls.first->second].insert(site.fields.begin(), site.fields.end());
+      layoutOf[site.expr] = cls.first->second;
+    }
+  } catch (SemanticError &e) {
+    LOG_S(1) << "Using the wide record layout: " << e.what();
+
+    std::unordered_map<ASTExpr*, int> wideLayoutOf;
+    for (auto &site : visitor.sites) {
+      wideLayoutOf[site.expr] = 0;
+    }
+    return std::make_unique<RecordLayouts>(std::vector<Layout>{allFields},
+                                           std::vector<std::vector<bool>>{std::vector<bool>(allFields.size(), true)},
+                                           std::move(wideLayoutOf), true);
+  }
+
+  std::vector<Layout> layouts(used.size());
+  std::vector<std::vector<bool>> references(used.size());
+  for (int i = 0; i < used.size(); i++) {
+    for (auto &f : allFields) {
+      if (used[i].count(f) != 0) {
+        layouts[i].push_back(f);
+        auto known = fieldReferences[i].find(f);
+        references[i].push_back(known == fieldReferences[i].end() || known->second);
+      }
+    }
+  }
+  return std::make_unique<RecordLayouts>(std::move(layouts), std::move(references), std::move(layoutOf), false);
+}
+
+bool RecordLayouts::mayHoldReference(std::shared_ptr<TipType> t) {
+  return std::dynamic_pointer_cast<TipInt>(t) == nullptr &&
+         std::dynamic_pointer_cast<TipFunction>(t) == nullptr;
+}
+
+int RecordLayouts::getLayout(ASTExpr* e) const {
+  auto layout = layoutOf.find(e);
+  if (layout == layoutOf.end()) {
+    throw InternalError("no record layout for the expression");
+  }
+  return layout->second;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "ASTProgram.h"
+#include "ASTExpr.h"
+#include "SymbolTable.h"
+#include "TipType.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*! \class RecordLayouts
+ *  \brief Compact memory layouts for the records of a program.
+ *
+ * Every record value that may reach an access expression must store the
+ * accessed field at the same offset.  Solving the type constraints of the
+ * whole program monomorphically, i.e., without instantiating the types of
+ * polymorphic functions, puts the record types of all such values into one
+ * class.  Each class gets a layout with a slot for just the fields that are
+ * defined or accessed on records of that class, in program field order.
+ *
+ * If the program cannot be typed monomorphically, e.g., a polymorphic
+ * function is applied to records of different types, then no class is
+ * known to be closed and every record uses the wide layout, which has a slot
+ * for every field of the program.
+ *
+ * The solution also tells which slots of a layout may hold references, which
+ * the garbage collector uses to avoid scanning integer fields.
+ */
+class RecordLayouts {
+public:
+  //! \brief The fields of a layout in slot order.
+  using Layout = std::vector<std::string>;
+
+  RecordLayouts(std::vector<Layout> layouts, std::vector<std::vector<bool>> references,
+                std::unordered_map<ASTExpr*, int> layoutOf, bool wide)
+      : layouts(std::move(layouts)), references(std::move(references)),
+        layoutOf(std::move(layoutOf)), wide(wide) {}
+
+  /*! \fn compute
+   *  \brief Compute the layouts of the records of a type correct program.
+   *
+   * \param ast The program AST
+   * \param symbols The symbol table
+   */
+  static std::unique_ptr<RecordLayouts> compute(ASTProgram* ast, SymbolTable* symbols);
+
+  //! \brief All layouts of the program, indexed by layout number.
+  const std::vector<Layout>& getLayouts() const { return layouts; }
+
+  /*! \brief The layout number of the records created or accessed by an expression.
+   *
+   * \param e A record or access expression
+   * \throws InternalError for any other expression
+   */
+  int getLayout(ASTExpr* e) const;
+
+  //! \brief True if every record uses the wide layout.
+  bool isWide() const { return wide; }
+
+  /*! \brief Which slots of a layout may hold references, in slot order.
+   *
+   * A slot whose type is known to be an integer or a function never holds a
+   * reference.  Every slot of the wide layout may hold one.
+   */
+  const std::vector<bool>& getReferences(int layout) const { return references.at(layout); }
+
+  /*! \fn mayHoldReference
+   *  \brief True unless values of the type are known not to be references.
+   *
+   * Integers and functions, which are represented by their index in the
+   * dispatch table, are not references.  Unconstrained types may be.
+   */
+  static bool mayHoldReference(std::shared_ptr<TipType> t);
+
+private:
+  std::vector<Layout> layouts;
+  std::vector<std::vector<bool>> references;
+  std::unordered_map<ASTExpr*, int> layoutOf;
+  bool wide;
+};
@@ -3,34 +3,190 @@
 #include "TypeConstraintCollectVisitor.h"
 #include "Unifier.h"
 #include "FunctionGraph.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <queue>
 #include <sstream> 
 #include <memory>
-#include "FunctionGraph.h"
+
+namespace { // Anonymous namespace for local helpers
 
 /*
- * This implementation collects the constraints and then solves them with a
- * unifier instance.  The unifier then records the inferred type results that
- * can be subsequently queried.
+ * Orders the groups so that every group follows the groups it calls.  Among
+ * the groups that are ready the one declared first in the program goes
+ * first, by file and then within the file, which makes the order
+ * independent of pointer values and thread counts.
  */
-std::unique_ptr<TypeInference> TypeInference::check(ASTProgram* ast, SymbolTable* symbols) {
+std::vector<FunctionGroup*> scheduleOrder(std::queue<FunctionGroup*> queue) {
+  std::vector<FunctionGroup*> groups;
+  while(!queue.empty()) {
+    groups.push_back(queue.front());
+    queue.pop();
+  }
+
+  std::map<FunctionGroup*, int> position;
+  std::map<FunctionGroup*, int> remaining;
+  std::map<FunctionGroup*, std::vector<FunctionGroup*>> callers;
+  for (auto group : groups) {
+    position[group] = group->GetSourceIndex();
+    remaining[group] = group->GetCalls().size();
+    for (auto callee : group->GetCalls()) {
+      callers[callee].push_back(group);
+    }
+  }
+
+  auto later = [&position](FunctionGroup* a, FunctionGroup* b) { return position[a] > position[b]; };
+  std::priority_queue<FunctionGroup*, std::vector<FunctionGroup*>, decltype(later)> ready(later);
+  for (auto group : groups) {
+    if (remaining[group] == 0) {
+      ready.push(group);
+    }
+  }
+
+  std::vector<FunctionGroup*> order;
+  while(!ready.empty()) {
+    auto group{ ready.top() };
+    ready.pop();
+    order.push_back(group);
+    for (auto caller : callers[group]) {
+      if (--remaining[caller] == 0) {
+        ready.push(caller);
+      }
+    }
+  }
+  return order;
+}
+
+}
+
+/*
+ * This implementation collects the constraints of each function group and
+ * solves them with a unifier for that group.  The signatures of the called
+ * groups are imported first, so a group can be solved as soon as all of its
+ * callees are.  The unifiers then record the inferred type results that can
+ * be subsequently queried.
+ */
+std::unique_ptr<TypeInference> TypeInference::check(ASTProgram* ast, SymbolTable* symbols, unsigned jobs) {
 
   FunctionGraphCreator analyzer{ ast };
-  auto unifier{ std::make_unique<Unifier>() };
-  auto queue{ analyzer.InverseTopoSort() };
+  auto order{ scheduleOrder(analyzer.InverseTopoSort()) };
 
-  while(!queue.empty()) {
-    auto func{ queue.front() };
-    unifier->solve(func, symbols);
-    queue.pop();
+  std::map<FunctionGroup*, int> index;
+  for (int i = 0; i < order.size(); i++) {
+    index[order[i]] = i;
+  }
+
+  // Callees and callers by order index, callees sorted so imports are stable
+  std::vector<std::vector<int>> callees(order.size());
+  std::vector<std::vector<int>> callers(order.size());
+  for (int i = 0; i < order.size(); i++) {
+    for (auto callee : order[i]->GetCalls()) {
+      callees[i].push_back(index.at(callee));
+      callers[index.at(callee)].push_back(i);
+    }
+    std::sort(callees[i].begin(), callees[i].end());
   }
 
-  auto r = std::make_unique<TypeInference>(symbols, std::move(unifier));
-  return std::move(r);
+  std::vector<std::unique_ptr<Unifier>> unifiers(order.size());
+  auto solve = [&](int i) {
+    auto unifier{ std::make_unique<Unifier>() };
+    for (auto callee : callees[i]) {
+      auto signatures{ unifiers[callee]->getTypeSignatures() };
+      for (auto func : order[callee]->GetFuncsInSourceOrder()) {
+        unifier->importSignature(func->getDecl(), signatures.at(func->getName()));
+      }
+    }
+    unifier->solve(order[i], symbols);
+    unifiers[i] = std::move(unifier);
+  };
+
+  if (jobs <= 1) {
+    for (int i = 0; i < order.size(); i++) {
+      solve(i);
+    }
+  } else {
+    std::vector<std::atomic<int>> waiting(order.size());
+    for (int i = 0; i < order.size(); i++) {
+      waiting[i] = callees[i].size();
+    }
+
+    // Groups that depend on a failed group are never released.  Of the
+    // failures the one that comes first in the order is reported, which is
+    // the error the serial schedule would stop at.
+    std::mutex lock;
+    int failed = order.size();
+    std::exception_ptr failure;
+
+    WorkStealingPool pool{ jobs };
+    std::function<void(int)> run = [&](int i) {
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        if (i > failed) {
+          return;
+        }
+      }
+      try {
+        solve(i);
+      } catch(...) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (i < failed) {
+          failed = i;
+          failure = std::current_exception();
+        }
+        return;
+      }
+      for (auto caller : callers[i]) {
+        if (--waiting[caller] == 0) {
+          pool.submit([&run, caller] { run(caller); });
+        }
+      }
+    };
+
+    for (int i = 0; i < order.size(); i++) {
+      if (callees[i].empty()) {
+        pool.submit([&run, i] { run(i); });
+      }
+    }
+    pool.wait();
+
+    if (failure) {
+      std::rethrow_exception(failure);
+    }
+  }
+
+  std::unordered_map<ASTDeclNode*, Unifier*> scopes;
+  for (int i = 0; i < order.size(); i++) {
+    for (auto func : order[i]->GetFuncs()) {
+      scopes[func->getDecl()] = unifiers[i].get();
+      for (auto local : symbols->getLocals(func->getDecl())) {
+        scopes[local] = unifiers[i].get();
+      }
+    }
+  }
+
+  return std::make_unique<TypeInference>(symbols, std::move(unifiers), std::move(scopes));
 }
 
 std::shared_ptr<TipType> TypeInference::getInferredType(ASTDeclNode *node) {
+  auto cached = inferredTypes.find(node);
+  if (cached != inferredTypes.end()) {
+    return cached->second;
+  }
+
+  // Names outside of any function group are unconstrained
   auto var = std::make_shared<TipVar>(node);
-  return unifier->inferred(var);
+  std::shared_ptr<TipType> type;
+  auto scope = scopes.find(node);
+  if (scope != scopes.end()) {
+    type = scope->second->inferred(var);
+  } else {
+    type = Unifier().inferred(var);
+  }
+  inferredTypes.emplace(node, type);
+  return type;
 };
 
 void TypeInference::print(std::ostream &s) {
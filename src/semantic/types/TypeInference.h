@@ -5,17 +5,25 @@
 #include "SymbolTable.h"
 #include "Unifier.h"
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 /*! \class TypeInference
  *  \brief Perform type inference and checking.
  *
  * This class provides the check method to run type inference/checking on a 
  * given program.  The inferred types for names declared in the program can then be accessed.
+ *
+ * Each group of mutually recursive functions is solved by its own unifier.  A
+ * group only depends on the signatures of the groups it uses, so groups with
+ * no path between them in the function graph are solved in parallel.
  */
 class TypeInference {
 
 public:
-  TypeInference(SymbolTable* s, std::unique_ptr<Unifier> u) : symbols(s), unifier(std::move(u)) {}
+  TypeInference(SymbolTable* s, std::vector<std::unique_ptr<Unifier>> u,
+                std::unordered_map<ASTDeclNode*, Unifier*> scopes)
+      : symbols(s), unifiers(std::move(u)), scopes(std::move(scopes)) {}
 
   /*! \fn check
    *  \brief Generate type constraints, unify them, and report any errors.
@@ -23,12 +31,16 @@ public:
    * Visits the AST generating type constraints for each expression and solves
    * the resulting constraints.   If a term unification error is detected a
    * UnificationError, a subtype fo SemanticError, is raised.
+   *
+   * The results, including which error is reported when several groups
+   * fail, do not depend on the number of jobs.
    * \sa UnificationError
    * \sa SemanticError
    * \param ast The program AST
    * \param symbols The symbol table
+   * \param jobs The number of threads solving function groups
    */
-  static std::unique_ptr<TypeInference> check(ASTProgram* ast, SymbolTable* symbols); 
+  static std::unique_ptr<TypeInference> check(ASTProgram* ast, SymbolTable* symbols, unsigned jobs = 1);
 
   /*! \fn getInferredType
    *  \brief Returns the type expression inferred for the given ASTDeclNode.
@@ -38,6 +50,7 @@ public:
    * inferred type will be a free type variable.  A managed pointer is returned for exactly
    * this case -- when a fresh variable is generated and returned.  In other cases, the
    * resulting type will be shared with those computed during inference -- hence a shared pointer.
+   * The solution is fixed once check completes, so results are cached per declaration.
    *
    * \sa TipType
    * \sa ASTDeclNode
@@ -47,8 +60,14 @@ public:
   std::shared_ptr<TipType> getInferredType(ASTDeclNode *node);
 
   SymbolTable* symbols;
-  std::unique_ptr<Unifier> unifier;
+
+  //! The unifiers of the function groups in the order they were scheduled
+  std::vector<std::unique_ptr<Unifier>> unifiers;
 
   //! Print type inference results to output stream
   void print(std::ostream &os);
+
+private:
+  std::unordered_map<ASTDeclNode*, Unifier*> scopes;
+  std::unordered_map<ASTDeclNode*, std::shared_ptr<TipType>> inferredTypes;
 };
@@ -1,5 +1,6 @@
 #include "TipAlpha.h"
 #include "TipTypeVisitor.h"
+#include <functional>
 #include <sstream>
 
 TipAlpha::TipAlpha(ASTNode* node): TipVar(node), name("") {};
@@ -16,6 +17,10 @@ std::ostream &TipAlpha::print(std::ostream &out) const {
 }
 
 bool TipAlpha::operator==(const TipType& other) const{
+    if(internedWith(other)) {
+        return this == &other;
+    }
+
     auto otherTipAlpha = dynamic_cast<const TipAlpha*>(&other);
     if(!otherTipAlpha){
         return false;
@@ -32,6 +37,11 @@ bool TipAlpha::operator!=(const TipType &other) const {
     return !(*this == other);
 }
 
+std::size_t TipAlpha::computeHash() const {
+    // Distinguish from a TipVar over the same node, which is never equal
+    return hashCombine(hashCombine(0xa1, std::hash<ASTNode*>()(node)), std::hash<std::string>()(name));
+}
+
 std::string const& TipAlpha::getName() const{
     return name;
 }
@@ -1,5 +1,6 @@
 #include "TipCons.h"
 #include "TipTypeVisitor.h"
+#include "InternalError.h"
 
 int TipCons::arity() const {
     return arguments.size();
@@ -31,9 +32,19 @@ bool TipCons::doMatch(TipType const * t) const {
     return false;
 }
 
+std::size_t TipCons::hashArguments(std::size_t seed) const {
+    for(auto &a : arguments) {
+        seed = hashCombine(seed, a->hash());
+    }
+    return seed;
+}
+
 TipCons::TipCons(std::vector<std::shared_ptr<TipType>> arguments) : arguments(std::move(arguments)) { }
 
 void TipCons::setArguments(std::vector<std::shared_ptr<TipType>> &a) {
+    if(getContext() != nullptr) {
+        throw InternalError("attempt to update the arguments of an interned type");
+    }
     arguments = a;
 }
 
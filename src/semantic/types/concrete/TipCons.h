@@ -16,6 +16,7 @@ public:
     TipCons() = default;
 
     const std::vector<std::shared_ptr<TipType>> &getArguments() const;
+    //! \brief Update the arguments.  Interned types are immutable and throw an InternalError.
     void setArguments(std::vector<std::shared_ptr<TipType>> &args);
     virtual int arity() const;
     bool doMatch(TipType const * t) const;
@@ -24,6 +25,10 @@ public:
 
 protected:
     TipCons(std::vector<std::shared_ptr<TipType>> arguments);
+
+    //! \brief Combine the hashes of the arguments with a constructor specific seed.
+    std::size_t hashArguments(std::size_t seed) const;
+
     std::vector<std::shared_ptr<TipType>> arguments ;
 };
 
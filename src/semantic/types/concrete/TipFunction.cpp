@@ -35,6 +35,10 @@ std::ostream &TipFunction::print(std::ostream &out) const {
 }
 
 bool TipFunction::operator==(const TipType &other) const {
+    if(internedWith(other)) {
+        return this == &other;
+    }
+
     auto otherTipFunction = dynamic_cast<const TipFunction *>(&other);
     if(!otherTipFunction) {
         return false;
@@ -57,6 +61,10 @@ bool TipFunction::operator!=(const TipType &other) const {
     return !(*this == other);
 }
 
+std::size_t TipFunction::computeHash() const {
+    return hashArguments(0xf5);
+}
+
 void TipFunction::accept(TipTypeVisitor * visitor) {
   if (visitor->visit(this)) {
     for (auto a : arguments) {
@@ -5,6 +5,10 @@
 TipInt::TipInt() { }
 
 bool TipInt::operator==(const TipType &other) const {
+    if(internedWith(other)) {
+        return this == &other;
+    }
+
     auto otherTipInt = dynamic_cast<TipInt const *>(&other);
     if(!otherTipInt) {
         return false;
@@ -17,6 +21,10 @@ bool TipInt::operator!=(const TipType &other) const {
     return !(*this == other);
 }
 
+std::size_t TipInt::computeHash() const {
+    return 0x17;
+}
+
 std::ostream &TipInt::print(std::ostream &out) const {
     out << std::string("int");
     return out;
@@ -13,6 +13,10 @@ const std::shared_ptr<TipType> &TipMu::getT() const {
 }
 
 bool TipMu::operator==(const TipType &other) const {
+    if(internedWith(other)) {
+        return this == &other;
+    }
+
     auto mu = dynamic_cast<const TipMu *>(&other);
     if(!mu) {
       return false;
@@ -24,6 +28,10 @@ bool TipMu::operator!=(const TipType &other) const {
     return !(*this == other);
 }
 
+std::size_t TipMu::computeHash() const {
+    return hashCombine(hashCombine(0x3c, v->hash()), t->hash());
+}
+
 std::ostream &TipMu::print(std::ostream &out) const {
     out << "\u03bc" << *v << "." << *t;
     return out;
@@ -23,6 +23,10 @@ std::ostream& TipRecord::print(std::ostream &out) const {
 
 // This does not obey the semantics of alpha init values 
 bool TipRecord::operator==(const TipType &other) const {
+    if(internedWith(other)) {
+        return this == &other;
+    }
+
     auto tipRecord = dynamic_cast<const TipRecord *>(&other);
     if(!tipRecord) {
         return false;
@@ -45,6 +49,11 @@ bool TipRecord::operator!=(const TipType &other) const {
     return !(*this == other);
 }
 
+// Field names do not participate in equality so they are not hashed either
+std::size_t TipRecord::computeHash() const {
+    return hashArguments(0x4b);
+}
+
 std::vector<std::shared_ptr<TipType>>& TipRecord::getInits() {
     return arguments;
 }
@@ -24,6 +24,8 @@ public:
     void accept(TipTypeVisitor *visitor) override;
 
 protected:
+    std::size_t computeHash() const override;
+
     std::ostream& print(std::ostream &out) const override;
 
 private:
@@ -6,6 +6,10 @@ TipRef::TipRef(std::shared_ptr<TipType> of)
   : TipCons(std::move(std::vector<std::shared_ptr<TipType>> {of})) { }
 
 bool TipRef::operator==(const TipType &other) const {
+    if(internedWith(other)) {
+        return this == &other;
+    }
+
     auto otherTipRef = dynamic_cast<const TipRef *>(&other);
     if(!otherTipRef) {
         return false;
@@ -18,6 +22,10 @@ bool TipRef::operator!=(const TipType &other) const {
     return !(*this == other);
 }
 
+std::size_t TipRef::computeHash() const {
+    return hashArguments(0x2e);
+}
+
 std::ostream& TipRef::print(std::ostream &out) const {
     out << "&" << *arguments.front();
     return out;
@@ -1,20 +1,44 @@
 #pragma once
 
+#include <cstddef>
 #include <ostream>
 #include <memory>
 
-// Forward declare the visitor to resolve circular dependency
+// Forward declare the visitor and context to resolve circular dependency
 class TipTypeVisitor;
+class TypeContext;
 
 /*! \class TipType
  * \brief Abstract base class of all types
  *
- * Defines equality comparisons, output operator, and accept for visitor.
+ * Defines equality comparisons, hashing, output operator, and accept for visitor.
+ *
+ * A type may be interned in a TypeContext, in which case it is the canonical
+ * representative of all structurally equal types in that context.  Interned
+ * types are immutable and equality among types interned in the same context
+ * is pointer equality.
+ * \sa TypeContext
  */
 class TipType {
 public:
+    TipType() = default;
+
+    //! \brief Copies are never interned.
+    TipType(const TipType &other) { }
+
     virtual bool operator==(const TipType& other) const = 0;
     virtual bool operator!=(const TipType& other) const = 0;
+
+    /*! \brief Structural hash consistent with operator==.
+     *
+     * Types that compare equal must produce the same hash so that terms
+     * can be indexed in hash-based containers, e.g., the UnionFind.
+     */
+    std::size_t hash() const { return context ? internedHash : computeHash(); }
+
+    //! \brief The context the type is interned in or nullptr.
+    TypeContext* getContext() const { return context; }
+
     virtual ~TipType() = default;
     friend std::ostream& operator<<(std::ostream& os, const TipType& obj) {
         return obj.print(os);
@@ -25,6 +49,22 @@ public:
 protected:
     virtual std::ostream& print(std::ostream &out) const = 0;
 
+    virtual std::size_t computeHash() const = 0;
+
+    //! \brief True when both types are canonical in the same context.
+    bool internedWith(const TipType &other) const {
+        return context != nullptr && context == other.context;
+    }
+
+    //! \brief Mix a value into an accumulated hash (boost::hash_combine).
+    static std::size_t hashCombine(std::size_t seed, std::size_t value) {
+        return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+
+private:
+    friend class TypeContext;
+    TypeContext *context = nullptr;
+    std::size_t internedHash = 0;
 };
 
 
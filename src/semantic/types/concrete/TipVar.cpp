@@ -1,12 +1,17 @@
 #include "TipVar.h"
 #include "TipAlpha.h"
 #include "TipTypeVisitor.h"
+#include <functional>
 #include <sstream>
 #include <iostream>
 
 TipVar::TipVar(ASTNode * node): node(node) {};
 
 bool TipVar::operator==(const TipType &other) const {
+    if(internedWith(other)) {
+        return this == &other;
+    }
+
     auto otherTipVar = dynamic_cast<TipVar const *>(&other);
     auto otherTipAlpha = dynamic_cast<TipAlpha const *>(&other);
     if(!otherTipVar || otherTipAlpha) {
@@ -20,6 +25,10 @@ bool TipVar::operator!=(const TipType &other) const {
     return !(*this == other);
 }
 
+std::size_t TipVar::computeHash() const {
+    return std::hash<ASTNode*>()(node);
+}
+
 std::ostream &TipVar::print(std::ostream &out) const {
     out << "[[" << *node << "@" << node->getLine() << ":" << node->getColumn() << "]]";
     return out;
@@ -0,0 +1,114 @@
+#include "TypeContext.h"
+
+TypeContext::~TypeContext() {
+    // Types still referenced elsewhere are no longer canonical
+    for(auto &t : types) {
+        TipType *type = t.get();
+        type->context = nullptr;
+    }
+}
+
+template <typename T>
+std::shared_ptr<T> TypeContext::canonical(std::shared_ptr<T> candidate) {
+    auto found = types.find(candidate);
+    if(found != types.end()) {
+        return std::static_pointer_cast<T>(*found);
+    }
+
+    TipType *type = candidate.get();
+    type->internedHash = type->hash();
+    type->context = this;
+    types.insert(candidate);
+    return candidate;
+}
+
+std::shared_ptr<TipType> TypeContext::intern(std::shared_ptr<TipType> t) {
+    if(t->getContext() == this) {
+        return t;
+    }
+
+    // Adopt t when it is not owned by another context and its subterms are canonical
+    auto adoptable = t->getContext() == nullptr;
+    if(auto mu = std::dynamic_pointer_cast<TipMu>(t)) {
+        auto v = std::static_pointer_cast<TipVar>(intern(mu->getV()));
+        auto body = intern(mu->getT());
+        if(adoptable && v == mu->getV() && body == mu->getT()) {
+            return canonical(t);
+        }
+        return getMu(v, body);
+    } else if(auto c = std::dynamic_pointer_cast<TipCons>(t)) {
+        std::vector<std::shared_ptr<TipType>> args;
+        for(auto &a : c->getArguments()) {
+            auto arg = intern(a);
+            adoptable = adoptable && arg == a;
+            args.push_back(arg);
+        }
+        if(adoptable) {
+            return canonical(t);
+        }
+        return withArguments(c.get(), args);
+    }
+
+    // Type variables have no subterms
+    if(adoptable) {
+        return canonical(t);
+    }
+    auto v = std::static_pointer_cast<TipVar>(t);
+    if(auto alpha = std::dynamic_pointer_cast<TipAlpha>(t)) {
+        return getAlpha(alpha->getNode(), alpha->getName());
+    }
+    return getVar(v->getNode());
+}
+
+/*! \brief Rebuild a constructor with new arguments.
+ * We explicitly test the types here, as in TipCons::doMatch, so extend this
+ * if you add a subtype of TipCons.
+ */
+std::shared_ptr<TipCons> TypeContext::withArguments(TipCons const * c, std::vector<std::shared_ptr<TipType>> args) {
+    if(dynamic_cast<TipFunction const *>(c)) {
+        auto ret = args.back();
+        args.pop_back();
+        return getFunction(args, ret);
+    } else if(dynamic_cast<TipRef const *>(c)) {
+        return getRef(args.front());
+    } else if(auto record = dynamic_cast<TipRecord const *>(c)) {
+        return getRecord(args, record->getNames());
+    }
+    return getInt();
+}
+
+std::shared_ptr<TipInt> TypeContext::getInt() {
+    return canonical(std::make_shared<TipInt>());
+}
+
+std::shared_ptr<TipRef> TypeContext::getRef(std::shared_ptr<TipType> of) {
+    return canonical(std::make_shared<TipRef>(intern(of)));
+}
+
+std::shared_ptr<TipFunction> TypeContext::getFunction(
+        std::vector<std::shared_ptr<TipType>> params, std::shared_ptr<TipType> ret) {
+    for(auto &p : params) {
+        p = intern(p);
+    }
+    return canonical(std::make_shared<TipFunction>(params, intern(ret)));
+}
+
+std::shared_ptr<TipRecord> TypeContext::getRecord(
+        std::vector<std::shared_ptr<TipType>> inits, std::vector<std::string> names) {
+    for(auto &i : inits) {
+        i = intern(i);
+    }
+    return canonical(std::make_shared<TipRecord>(inits, names));
+}
+
+std::shared_ptr<TipVar> TypeContext::getVar(ASTNode * node) {
+    return canonical(std::make_shared<TipVar>(node));
+}
+
+std::shared_ptr<TipAlpha> TypeContext::getAlpha(ASTNode * node, std::string const & name) {
+    return canonical(std::make_shared<TipAlpha>(node, name));
+}
+
+std::shared_ptr<TipMu> TypeContext::getMu(std::shared_ptr<TipVar> v, std::shared_ptr<TipType> t) {
+    return canonical(std::make_shared<TipMu>(std::static_pointer_cast<TipVar>(intern(v)), intern(t)));
+}
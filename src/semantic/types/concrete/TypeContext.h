@@ -0,0 +1,78 @@
+#pragma once
+
+#include "TipAlpha.h"
+#include "TipCons.h"
+#include "TipFunction.h"
+#include "TipInt.h"
+#include "TipMu.h"
+#include "TipRecord.h"
+#include "TipRef.h"
+#include "TipType.h"
+#include "TipVar.h"
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/*!
+ * \class TypeContext
+ *
+ * \brief An arena of hash-consed types.
+ *
+ * The context owns a single canonical node for each structurally distinct
+ * type that is interned in it.  Since the subterms of a canonical node are
+ * themselves canonical, equality of interned types is pointer equality and
+ * hashing and lookup only ever inspect the immediate subterms of a node.
+ *
+ * Interned types are immutable; operations that would update a type, e.g.,
+ * substitution, produce a new canonical type instead.  Types that outlive
+ * their context revert to being ordinary structurally compared types.
+ *
+ * Field names do not take part in record equality, so records with the
+ * same field types share the names of the first such record interned.
+ */
+class TypeContext {
+public:
+    TypeContext() = default;
+    TypeContext(const TypeContext &) = delete;
+    TypeContext& operator=(const TypeContext &) = delete;
+    ~TypeContext();
+
+    /*! \brief Returns the canonical type that is structurally equal to t.
+     *
+     * Subterms of t are interned first.  If t is not interned in another
+     * context and its subterms are already canonical it is adopted as is.
+     */
+    std::shared_ptr<TipType> intern(std::shared_ptr<TipType> t);
+
+    //! \brief Returns the canonical constructor of the same kind as c with the given arguments.
+    std::shared_ptr<TipCons> withArguments(TipCons const * c, std::vector<std::shared_ptr<TipType>> args);
+
+    std::shared_ptr<TipInt> getInt();
+    std::shared_ptr<TipRef> getRef(std::shared_ptr<TipType> of);
+    std::shared_ptr<TipFunction> getFunction(std::vector<std::shared_ptr<TipType>> params, std::shared_ptr<TipType> ret);
+    std::shared_ptr<TipRecord> getRecord(std::vector<std::shared_ptr<TipType>> inits, std::vector<std::string> names);
+    std::shared_ptr<TipVar> getVar(ASTNode * node);
+    std::shared_ptr<TipAlpha> getAlpha(ASTNode * node, std::string const & name = "");
+    std::shared_ptr<TipMu> getMu(std::shared_ptr<TipVar> v, std::shared_ptr<TipType> t);
+
+    //! \brief The number of canonical types in the context.
+    std::size_t size() const { return types.size(); }
+
+private:
+    struct TypeHash {
+        std::size_t operator()(const std::shared_ptr<TipType> &t) const { return t->hash(); }
+    };
+    struct TypeEqual {
+        bool operator()(const std::shared_ptr<TipType> &t1, const std::shared_ptr<TipType> &t2) const {
+            return *t1 == *t2;
+        }
+    };
+
+    /*! \brief Returns the canonical type equal to the candidate.
+     * \pre The subterms of candidate are canonical in this context.
+     */
+    template <typename T> std::shared_ptr<T> canonical(std::shared_ptr<T> candidate);
+
+    std::unordered_set<std::shared_ptr<TipType>, TypeHash, TypeEqual> types;
+};
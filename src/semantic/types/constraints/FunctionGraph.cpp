@@ -1,116 +1,152 @@
 #include "FunctionGraph.h"
+#include <algorithm>
 #include <stack>
 #include <iostream>
+#include <unordered_set>
 #include <assert.h>
 
-void FunctionGraphCreator::FuncVisitor::endVisit(ASTFunAppExpr* func){
-    if(auto f = dynamic_cast<ASTVariableExpr*>(func->getFunction())){
-        if(locals.find(f->getName()) == locals.end()){
-            functions.emplace(program->findFunctionByName(f->getName()));
-        } else{
-            auto func{ program->findFunctionByName(f->getName()) };
-            if(func){
-                functions.emplace(func);
-            } else{
-                // Function variable being called
-            }
+FunctionGraphCreator::FuncVisitor::FuncVisitor(FunctionGraphCreator* creator) : creator{ creator }{}
+bool FunctionGraphCreator::FuncVisitor::visit(ASTFunction* func){
+    current = creator->graph.at(func).get();
+    function = func;
+    return true;
+}
+// The function a variable names, if any
+ASTFunction* FunctionGraphCreator::FuncVisitor::Named(ASTVariableExpr* var){
+    if(var->getDecl() == nullptr){
+        // Not bound by a symbol table, locals never share the name of a function
+        return creator->program->findFunctionByName(var->getName());
+    } else if(var->isFunction()){
+        return creator->program->getFunctions()[var->getSlot()];
+    }
+    return nullptr;
+}
+void FunctionGraphCreator::FuncVisitor::endVisit(ASTFunAppExpr* call){
+    if(auto f = dynamic_cast<ASTVariableExpr*>(call->getFunction())){
+        if(auto func{ Named(f) }){
+            AddCall(func);
         }
     } else{
         // Function variable being called
     }
 }
-void FunctionGraphCreator::FuncVisitor::endVisit(ASTDeclNode* decl){
-    locals.emplace(decl->getName());
-}
-FunctionGraphCreator::FuncVisitor::FuncVisitor(ASTProgram* p) : program{ p }{}
-void FunctionGraphCreator::DfsTraverseAsDAG(FunctionGroup* current,
-                                            std::set<FunctionGroup*>& visited,
-                                            std::vector<FunctionGroup*>& callstack){
-    if(visited.find(current) != visited.end()){
-        for(int i = 0; i < callstack.size(); i++){
-            if(callstack[i] == current){
-                callstack[i]->recursive = true;
-                for(int j = i + 1; j < callstack.size(); j++){
-                    callstack[j]->recursive = true;
-                    Union(callstack[j], current);
-                }
-                return;
-            }
-        }
-    } else{
-        visited.emplace(current);
-        callstack.emplace_back(current);
-        for(auto& call : current->GetCalls()){
-            DfsTraverseAsDAG(call, visited, callstack);
-        }
-        callstack.pop_back();
-        visited.erase(current);
+// Functions used as values must be typed before the function using them,
+// a function using itself as a value is not a recursive call
+void FunctionGraphCreator::FuncVisitor::endVisit(ASTVariableExpr* var){
+    auto func{ Named(var) };
+    if(func && func != function){
+        AddCall(func);
     }
 }
+void FunctionGraphCreator::FuncVisitor::AddCall(ASTFunction* callee){
+    current->AddCall(creator->graph.at(callee).get());
+}
 FunctionGraphCreator::FunctionGraphCreator(ASTProgram* program) : program{ program }{
     BuildGraph();
     Derecursify();
 }
-void FunctionGraphCreator::Union(FunctionGroup* fg1, FunctionGroup* fg2){
-    auto r1{ Find(fg1) };
-    auto r2{ Find(fg2) };
-    if(r1 == r2){
-        return;
-    } else if(rank[r1] > rank[r2]){
-        parents[r2] = r1;
-    } else if(rank[r2] > rank[r1]){
-        parents[r1] = r2;
-    } else{
-        parents[r1] = r2;
-        rank[r2] += 1;
-    }
-}
-FunctionGroup* FunctionGraphCreator::Find(FunctionGroup* fg1){
-    auto parent{ parents[fg1] };
-    if(parent == fg1){
-        return fg1;
-    } else {
-        return parents[fg1] = Find(parent);
-    }
+FunctionGroup* FunctionGraphCreator::Find(FunctionGroup* group){
+    auto merged{ mergedInto.find(group) };
+    return merged == mergedInto.end() ? group : merged->second;
 }
 void FunctionGraphCreator::BuildGraph(){
     graph.erase(graph.begin(), graph.end());
-    for(auto func : program->getFunctions()){
-        graph.emplace(func, std::make_shared<FunctionGroup>(func));
+    auto functions{ program->getFunctions() };
+    for(int i = 0; i < functions.size(); i++){
+        graph.emplace(functions[i], std::make_shared<FunctionGroup>(functions[i], i));
     }
 
-    for(auto func : program->getFunctions()){
-        FuncVisitor visitor{ program };
-        auto& node{ graph.at(func) };
-        func->accept(&visitor);
-        for(auto callTarget : visitor.functions){
-            node->AddCall(graph.at(callTarget).get());
-        }
-    }
+    // A single pass over the program collects the calls of every function
+    FuncVisitor visitor{ this };
+    program->accept(&visitor);
 }
+/*
+ * The recursive groups are the strongly connected components of the call
+ * graph, found with Tarjan's algorithm.  Each function is pushed and popped
+ * once and each call is followed once, so this is linear in the size of the
+ * graph.  The traversal keeps its own stack since call chains can be deeper
+ * than the native stack allows.
+ */
 void FunctionGraphCreator::Derecursify(){
-    for(auto& pair : graph){
-        parents.emplace(pair.second.get(), pair.second.get());
-        rank.emplace(pair.second.get(), 0);
+    struct Frame {
+        FunctionGroup* group;
+        std::set<FunctionGroup*>::const_iterator next;
+    };
+
+    std::unordered_map<FunctionGroup*, int> index{};
+    std::unordered_map<FunctionGroup*, int> lowlink{};
+    std::unordered_set<FunctionGroup*> onStack{};
+    std::vector<FunctionGroup*> stack{};
+    std::vector<Frame> callstack{};
+
+    auto push{ [&](FunctionGroup* group){
+        auto i{ static_cast<int>(index.size()) };
+        index.emplace(group, i);
+        lowlink.emplace(group, i);
+        stack.push_back(group);
+        onStack.insert(group);
+        callstack.push_back(Frame{ group, group->GetCalls().begin() });
+    } };
+
+    for(auto func : program->getFunctions()){
+        auto start{ graph.at(func).get() };
+        if(index.count(start)){
+            continue;
+        }
+        push(start);
+
+        while(!callstack.empty()){
+            auto group{ callstack.back().group };
+            auto& next{ callstack.back().next };
+            if(next != group->GetCalls().end()){
+                auto callee{ *next++ };
+                if(!index.count(callee)){
+                    push(callee);
+                } else if(onStack.count(callee)){
+                    lowlink[group] = std::min(lowlink[group], index[callee]);
+                }
+                continue;
+            }
+
+            callstack.pop_back();
+            if(!callstack.empty()){
+                auto caller{ callstack.back().group };
+                lowlink[caller] = std::min(lowlink[caller], lowlink[group]);
+            }
+            if(lowlink[group] != index[group]){
+                continue;
+            }
+
+            // The group is the root of a component, which is on top of the stack
+            FunctionGroup* member{};
+            do{
+                member = stack.back();
+                stack.pop_back();
+                onStack.erase(member);
+                if(member != group){
+                    group->recursive = true;
+                    member->recursive = true;
+                    group->Union(member);
+                    mergedInto.emplace(member, group);
+                }
+            } while(member != group);
+            roots.emplace_back(group);
+        }
     }
-    std::set<FunctionGroup*> visited{};
-    std::vector<FunctionGroup*> callstack{};
-    for(auto& pair : graph){
-        DfsTraverseAsDAG(pair.second.get(), visited, callstack);
+
+    for(auto& root : roots){
+        root->Finalize([this](FunctionGroup* group){ return Find(group); });
     }
 
+    // Every function of a component shares the group of its root
+    std::unordered_map<FunctionGroup*, std::shared_ptr<FunctionGroup>> owners{};
     for(auto& pair : graph){
-        auto parent{ Find(pair.second.get()) };
-        if(parent != pair.second.get()){
-            parent->Union(pair.second.get());
-            pair.second = graph[*parent->GetFuncs().begin()];
-        } else{
-            roots.emplace_back(parent);
+        if(Find(pair.second.get()) == pair.second.get()){
+            owners.emplace(pair.second.get(), pair.second);
         }
     }
-
-    for(auto& root : roots){
-        root->Finalize();
+    for(auto& pair : graph){
+        pair.second = owners.at(Find(pair.second.get()));
     }
 }
 std::queue<FunctionGroup*> FunctionGraphCreator::InverseTopoSort(){
@@ -8,24 +8,39 @@
 #include <queue>
 #include <vector>
 #include <set>
-
+#include <unordered_map>
+
+/*!
+ * \class FunctionGraphCreator
+ *
+ * \brief Builds the call graph of a program and groups mutually recursive
+ * functions together.
+ *
+ * The graph is built in a single pass over the program and the groups are
+ * the strongly connected components of the call graph, so construction is
+ * linear in the size of the program.  Functions are found through the
+ * bindings of their references once the symbol table of the program has
+ * been built, and by name before that.
+ */
 class FunctionGraphCreator {
-  std::map<FunctionGroup*, FunctionGroup*> parents;
-  std::map<FunctionGroup*, int> rank;
+  // Groups merged into the root of their component
+  std::unordered_map<FunctionGroup*, FunctionGroup*> mergedInto;
 
-  void Union(FunctionGroup* f1, FunctionGroup* f2);
-  FunctionGroup* Find(FunctionGroup* f1);
+  FunctionGroup* Find(FunctionGroup* group);
 
   class FuncVisitor : public ASTVisitor {
-    friend class FunctionGraphCreator;
-    std::set<ASTFunction*> functions;
-    std::set<std::string> locals;
-    ASTProgram* program;
+    FunctionGraphCreator* creator;
+    FunctionGroup* current = nullptr;
+    ASTFunction* function = nullptr;
+
+    ASTFunction* Named(ASTVariableExpr* var);
+    void AddCall(ASTFunction* callee);
 
   public:
-    FuncVisitor(ASTProgram* program);
-    void endVisit(ASTDeclNode* call) override;
+    FuncVisitor(FunctionGraphCreator* creator);
+    bool visit(ASTFunction* func) override;
     void endVisit(ASTFunAppExpr* call) override;
+    void endVisit(ASTVariableExpr* var) override;
   };
 
   std::map<ASTFunction*, std::shared_ptr<FunctionGroup>> graph;
@@ -34,9 +49,6 @@ class FunctionGraphCreator {
 
   void BuildGraph();
   void Derecursify();
-  void DfsTraverseAsDAG(FunctionGroup* current, 
-                        std::set<FunctionGroup*>& visited, 
-                        std::vector<FunctionGroup*>& callstack);
 
 public:
   FunctionGraphCreator(ASTProgram* program);
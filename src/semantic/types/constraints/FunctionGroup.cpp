@@ -1,7 +1,9 @@
 #include "FunctionGroup.h"
+#include <algorithm>
 
-FunctionGroup::FunctionGroup(ASTFunction* base){
+FunctionGroup::FunctionGroup(ASTFunction* base, int index){
 	associatedFunctions.emplace(base);
+	sourceOrder.emplace(index, base);
 }
 void FunctionGroup::AddCall(FunctionGroup* group){
 	if(group == this){
@@ -17,32 +19,28 @@ void FunctionGroup::Union(FunctionGroup* group){
 	possibleCalls.insert(group->possibleCalls.begin(), group->possibleCalls.end());
 	callsiteFuncs.insert(group->callsiteFuncs.begin(), group->callsiteFuncs.end());
 	associatedFunctions.insert(group->associatedFunctions.begin(), group->associatedFunctions.end());
+	sourceOrder.insert(group->sourceOrder.begin(), group->sourceOrder.end());
 
 	possibleCalls.erase(group);
 	possibleCalls.erase(this);
 	callsiteFuncs.erase(group);
 	callsiteFuncs.erase(this);
 }
-void FunctionGroup::Finalize(){
-	if(possibleCalls.size()){
-		for(auto it = possibleCalls.begin(); it != possibleCalls.end();){
-			if(!(*it)->alive){
-				it = possibleCalls.erase(it);
-			} else{
-				it++;
+void FunctionGroup::Finalize(const std::function<FunctionGroup*(FunctionGroup*)>& resolve){
+	// Edges to groups that were merged away are redirected to the group they were merged into
+	auto redirect{ [&](std::set<FunctionGroup*>& groups){
+		std::set<FunctionGroup*> resolved{};
+		for(auto group : groups){
+			auto target{ resolve(group) };
+			if(target != this){
+				resolved.emplace(target);
 			}
 		}
-	}
-	if(callsiteFuncs.size()){
-		for(auto it = callsiteFuncs.begin(); it != callsiteFuncs.end();){
-			if(!(*it)->alive){
-				it = callsiteFuncs.erase(it);
-			} else{
-				it++;
-			}
-		}
-		callsiteFuncsDuplicate = callsiteFuncs;
-	}
+		groups = resolved;
+	} };
+	redirect(possibleCalls);
+	redirect(callsiteFuncs);
+	callsiteFuncsDuplicate = callsiteFuncs;
 }
 bool FunctionGroup::IsTerminal() const{ return callsiteFuncs.size() == 0; }
 void FunctionGroup::PruneCallsite(FunctionGroup* group){ callsiteFuncs.erase(group); }
@@ -59,4 +57,12 @@ std::string FunctionGroup::GetName(){
 	}
 }
 const std::set<FunctionGroup*>& FunctionGroup::GetCalls() const{ return possibleCalls; }
-const std::set<ASTFunction*>& FunctionGroup::GetFuncs() const{ return associatedFunctions; }
\ No newline at end of file
+const std::set<ASTFunction*>& FunctionGroup::GetFuncs() const{ return associatedFunctions; }
+std::vector<ASTFunction*> FunctionGroup::GetFuncsInSourceOrder() const{
+	std::vector<ASTFunction*> funcs;
+	for(auto& func : sourceOrder){
+		funcs.push_back(func.second);
+	}
+	return funcs;
+}
+int FunctionGroup::GetSourceIndex() const{ return sourceOrder.begin()->first; }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+#include <map>
 #include <vector>
 #include <set>
 
@@ -7,6 +9,8 @@
 
 class FunctionGroup {
     std::set<ASTFunction*> associatedFunctions;
+    // The functions by their index in the program
+    std::map<int, ASTFunction*> sourceOrder;
     std::set<FunctionGroup*> possibleCalls;
     std::set<FunctionGroup*> callsiteFuncs;
 
@@ -15,12 +19,17 @@ class FunctionGroup {
 public:
 
     bool recursive{ false };
-    FunctionGroup(ASTFunction* func);
+    // The index of the function in the program, which follows its files in order
+    FunctionGroup(ASTFunction* func, int index);
     const std::set<FunctionGroup*>& GetCalls() const;
     const std::set<ASTFunction*>& GetFuncs() const;
+    // The functions ordered by their position in the program, independent of addresses
+    std::vector<ASTFunction*> GetFuncsInSourceOrder() const;
+    // The index in the program of the first function
+    int GetSourceIndex() const;
     void AddCall(FunctionGroup* group);
     void Union(FunctionGroup* group);
-    void Finalize();
+    void Finalize(const std::function<FunctionGroup*(FunctionGroup*)>& resolve);
     bool IsTerminal() const;
     void PruneCallsite(FunctionGroup* group);
     void RestoreCallsites();
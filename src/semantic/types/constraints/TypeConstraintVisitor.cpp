@@ -13,18 +13,15 @@ TypeConstraintVisitor::TypeConstraintVisitor(SymbolTable* st, std::unique_ptr<Co
  *  \brief Convert an AST node to a type variable.
  *
  * Utility function that creates type variables and uses declaration nodes
- * as a canonical representative for program variables.  There are two case
- * that need to be checked: if the variable is local to a function or if
- * it is a function value.
+ * as a canonical representative for program variables, whether the variable
+ * is local to a function or is a function value.
  */
 std::shared_ptr<TipType> TypeConstraintVisitor::astToVar(ASTNode * n) {
   if (auto ve = dynamic_cast<ASTVariableExpr*>(n)) {
-    ASTDeclNode * canonical;
-    if ((canonical = symbolTable->getLocal(ve->getName(), scope.top()))) {
+    // The symbol table bound the name to its declaration
+    if (auto canonical = ve->getDecl()) {
       return std::make_shared<TipVar>(canonical);
-    } else if ((canonical = symbolTable->getFunction(ve->getName()))) {
-      return std::make_shared<TipVar>(canonical);
-    } 
+    }
   } 
 
   return std::make_shared<TipVar>(n);
@@ -98,7 +95,7 @@ void TypeConstraintVisitor::endVisit(ASTBinaryExpr  * element) {
   // result type is integer
   constraintHandler->handle(astToVar(element), intType);
 
-  if (op != "==" && op != "!=") {
+  if (op != ASTBinaryExpr::EQ && op != ASTBinaryExpr::NE) {
     // operands are integer
     constraintHandler->handle(astToVar(element->getLeft()), intType);
     constraintHandler->handle(astToVar(element->getRight()), intType);
@@ -8,6 +8,7 @@
 std::shared_ptr<TipType> Substituter::substitute(
         TipType* t, TipVar* v, std::shared_ptr<TipType> s) {
   Substituter visitor(v,s);
+  visitor.context = t->getContext();
   t->accept(&visitor);
   return visitor.getResult();
 }
@@ -16,6 +17,10 @@ std::shared_ptr<TipType> Substituter::getResult() {
   return visitedTypes.back();
 }
 
+void Substituter::push(std::shared_ptr<TipType> t) {
+  visitedTypes.push_back(context ? context->intern(t) : t);
+}
+
 void Substituter::endVisit(TipFunction * element) {
   std::vector<std::shared_ptr<TipType>> argTypes;
   for (auto &arg : element->getArguments()) {
@@ -29,12 +34,12 @@ void Substituter::endVisit(TipFunction * element) {
 
   std::shared_ptr<TipType> retType = argTypes.back();
   argTypes.pop_back();
-  visitedTypes.push_back(std::make_shared<TipFunction>(argTypes, retType));
+  push(std::make_shared<TipFunction>(argTypes, retType));
 }
 
 void Substituter::endVisit(TipInt * element) {
   // Zero element in visitedTypes (a special case of Cons)
-  visitedTypes.push_back(std::make_shared<TipInt>());
+  push(std::make_shared<TipInt>());
 }
 
 void Substituter::endVisit(TipMu * element) {
@@ -46,7 +51,7 @@ void Substituter::endVisit(TipMu * element) {
   auto vType = std::dynamic_pointer_cast<TipVar>(visitedTypes.back());
   visitedTypes.pop_back();
 
-  visitedTypes.push_back(std::make_shared<TipMu>(vType, tType));
+  push(std::make_shared<TipMu>(vType, tType));
 }
 
 void Substituter::endVisit(TipRecord * element) {
@@ -60,14 +65,14 @@ void Substituter::endVisit(TipRecord * element) {
   // so we set them right here
   std::reverse(initTypes.begin(), initTypes.end());
 
-  visitedTypes.push_back(std::make_shared<TipRecord>(initTypes, element->getNames()));
+  push(std::make_shared<TipRecord>(initTypes, element->getNames()));
 }
 
 void Substituter::endVisit(TipRef * element) {
   // One element in visitedTypes (a special case of Cons)
   auto pointedToType = visitedTypes.back();
   visitedTypes.pop_back();
-  visitedTypes.push_back(std::make_shared<TipRef>(pointedToType));
+  push(std::make_shared<TipRef>(pointedToType));
 }
 
 /*! \brief Substitute if variable is the target.
@@ -75,18 +80,18 @@ void Substituter::endVisit(TipRef * element) {
 void Substituter::endVisit(TipVar * element) {
   if (*element == *target) {
     auto copy = Copier::copy(substitution);
-    visitedTypes.push_back(copy);
+    push(copy);
   } else {
-    visitedTypes.push_back(std::make_shared<TipVar>(element->getNode()));
+    push(std::make_shared<TipVar>(element->getNode()));
   }
 }
 
 void Substituter::endVisit(TipAlpha * element) {
   if (*element == *target) {
     auto copy = Copier::copy(substitution);
-    visitedTypes.push_back(copy);
+    push(copy);
   } else {
-    visitedTypes.push_back(std::make_shared<TipAlpha>(element->getNode(), element->getName()));
+    push(std::make_shared<TipAlpha>(element->getNode(), element->getName()));
   }
 }
 
@@ -96,23 +101,26 @@ void Substituter::endVisit(TipAlpha * element) {
  * it overrides the behavior for TipVar and TipAlpha.
  */
 std::shared_ptr<TipType> Copier::copy(std::shared_ptr<TipType> t) {
+  if (t->getContext() != nullptr) {
+    return t;
+  }
+
   Copier visitor;
   t->accept(&visitor);
   return visitor.getResult();
 }
 
 void Copier::endVisit(TipVar * element) {
-  visitedTypes.push_back(std::make_shared<TipVar>(element->getNode()));
+  push(std::make_shared<TipVar>(element->getNode()));
 }
 
 void Copier::endVisit(TipAlpha * element) {
-  visitedTypes.push_back(std::make_shared<TipAlpha>(element->getNode(), element->getName()));
+  push(std::make_shared<TipAlpha>(element->getNode(), element->getName()));
 }
 
-int DeepCopier::substitution_id = 0;
-
-std::shared_ptr<TipType> DeepCopier::copy(std::shared_ptr<TipType> t){
-    DeepCopier visitor;
+std::shared_ptr<TipType> DeepCopier::copy(std::shared_ptr<TipType> t, int &substitutionId){
+    DeepCopier visitor{ substitutionId };
+    visitor.context = t->getContext();
     t->accept(&visitor);
     return visitor.getResult();
 }
@@ -120,10 +128,13 @@ std::shared_ptr<TipType> DeepCopier::copy(std::shared_ptr<TipType> t){
 void DeepCopier::endVisit(TipAlpha* element){
     if(replacements.find(*element) != replacements.end()){
         auto found{ replacements.at(*element) };
-        visitedTypes.push_back(std::make_shared<TipAlpha>(found->getNode(), found->getName()));
+        push(std::make_shared<TipAlpha>(found->getNode(), found->getName()));
     } else{
-        auto copy{ std::make_shared<TipAlpha>(element->getNode(),
+        std::shared_ptr<TipAlpha> copy{ std::make_shared<TipAlpha>(element->getNode(),
                                               element->getName() + "-" + std::to_string(substitution_id++)) };
+        if(context){
+            copy = context->getAlpha(copy->getNode(), copy->getName());
+        }
         replacements.emplace(*element, copy);
         visitedTypes.push_back(copy);
     }
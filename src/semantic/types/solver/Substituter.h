@@ -3,8 +3,12 @@
 #include <map>
 
 #include "TipTypeVisitor.h"
+#include "TypeContext.h"
 
 /*! \brief Produces a type with designated variable substitutions.
+ *
+ * When the type is interned in a TypeContext the result is built in, and
+ * interned in, the same context.
  */
 class Substituter: public TipTypeVisitor {
   TipVar* target;
@@ -12,8 +16,12 @@ class Substituter: public TipTypeVisitor {
 
 protected:
   std::vector<std::shared_ptr<TipType>> visitedTypes;
+  TypeContext *context = nullptr;
   Substituter() = default;
 
+  //! \brief Record a rebuilt type, interning it if there is a context.
+  void push(std::shared_ptr<TipType> t);
+
 public:
   Substituter(TipVar *t, std::shared_ptr<TipType> s) : target(t), substitution(s) {}
 
@@ -47,6 +55,7 @@ public:
  *
  * This subtype of the Substituter overrides the behavior for TipVar
  * and TipAlpha to just copy that node rather than perform a substitution.
+ * Interned types are immutable so they are shared rather than copied.
  */
 class Copier : public Substituter {
 public:
@@ -59,16 +68,20 @@ public:
 };
 
 /*! \brief Makes a deep copy of a TipType
+ *
+ * Alphas in the copy are renamed apart using a counter supplied by the
+ * caller, which lets independent solvers number their copies
+ * deterministically.
  */
 class DeepCopier : public Copier {
 private:
-	static int substitution_id;
+	int &substitution_id;
 	std::map<TipAlpha, std::shared_ptr<TipAlpha>> replacements;
 
 public:
-	DeepCopier() = default;
+	explicit DeepCopier(int &substitutionId) : substitution_id(substitutionId) {}
 
-	static std::shared_ptr<TipType> copy(std::shared_ptr<TipType> s);
+	static std::shared_ptr<TipType> copy(std::shared_ptr<TipType> s, int &substitutionId);
 
 	virtual void endVisit(TipAlpha* element) override;
 };
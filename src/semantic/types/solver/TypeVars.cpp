@@ -1,4 +1,5 @@
 #include "TypeVars.h"
+#include "TypeContext.h"
 
 std::set<std::shared_ptr<TipVar>> TypeVars::collect(TipType* t) {
   TypeVars visitor;
@@ -10,10 +11,22 @@ void TypeVars::endVisit(TipMu * element) {
   vars.erase(element->getV());
 }
 
+/*
+ * Variables of interned types are collected as their canonical nodes so
+ * that each variable occurs in the set exactly once.
+ */
 void TypeVars::endVisit(TipVar * element) {
-  vars.insert(std::make_shared<TipVar>(element->getNode()));
+  if (auto context = element->getContext()) {
+    vars.insert(context->getVar(element->getNode()));
+  } else {
+    vars.insert(std::make_shared<TipVar>(element->getNode()));
+  }
 }
 
 void TypeVars::endVisit(TipAlpha * element) {
-  vars.insert(std::make_shared<TipAlpha>(element->getNode(), element->getName()));
+  if (auto context = element->getContext()) {
+    vars.insert(context->getAlpha(element->getNode(), element->getName()));
+  } else {
+    vars.insert(std::make_shared<TipAlpha>(element->getNode(), element->getName()));
+  }
 }
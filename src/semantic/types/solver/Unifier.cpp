@@ -44,13 +44,15 @@ std::string print(std::set<std::shared_ptr<TipVar>> varSet) {
 
 }
 
-Unifier::Unifier() : unionFind(std::move(std::make_unique<UnionFind>())) {}
+Unifier::Unifier() : context(std::make_unique<TypeContext>()),
+                     unionFind(std::move(std::make_unique<UnionFind>())) {}
 
-Unifier::Unifier(std::vector<TypeConstraint> constrs) : constraints(std::move(constrs)) {
+Unifier::Unifier(std::vector<TypeConstraint> constrs) : constraints(std::move(constrs)),
+                                                        context(std::make_unique<TypeContext>()) {
     std::vector<std::shared_ptr<TipType>> types;
     for(TypeConstraint& constraint : constraints) {
-        auto lhs = constraint.lhs;
-        auto rhs = constraint.rhs;
+        auto lhs = context->intern(constraint.lhs);
+        auto rhs = context->intern(constraint.rhs);
         types.push_back(lhs);
         types.push_back(rhs);
 
@@ -81,11 +83,21 @@ void Unifier::solve() {
 
 void Unifier::solve(FunctionGroup* group, SymbolTable* table){
     TypeConstraintCollectVisitor visitor(table);
-    for(auto& func : group->GetFuncs()){
+    for(auto& func : group->GetFuncsInSourceOrder()){
         func->accept(&visitor);
     }
     auto& constraints{ visitor.getCollectedConstraints() };
     solve(constraints, group);
+
+    for(auto& func : group->GetFuncsInSourceOrder()){
+        funcMap[func->getName()] = inferred(std::make_shared<TipVar>(func->getDecl()));
+    }
+}
+
+void Unifier::importSignature(ASTDeclNode* decl, std::shared_ptr<TipType> signature){
+    // Interning first keeps the copy out of the context that owns the signature
+    auto copy{ DeepCopier::copy(context->intern(signature), substitutionId) };
+    unify(context->getVar(decl), copy);
 }
 
 std::string typeToString(const TipType& type){
@@ -111,7 +123,7 @@ void Unifier::solve(const std::vector<TypeConstraint>& constraints, FunctionGrou
                 unify(constraint.lhs, constraint.rhs);
             } else {
                 // Use saved function
-                auto copy = DeepCopier::copy(inferred(constraint.lhs));
+                auto copy = DeepCopier::copy(inferred(constraint.lhs), substitutionId);
                 unify(copy, constraint.rhs);
             }
 
@@ -140,6 +152,9 @@ void Unifier::solve(const std::vector<TypeConstraint>& constraints, FunctionGrou
  * \sa t2
  */
 void Unifier::unify(std::shared_ptr<TipType> t1, std::shared_ptr<TipType> t2) {
+    t1 = context->intern(t1);
+    t2 = context->intern(t2);
+
     LOG_S(1) << "Unifying " << *t1 << " and " << *t2;
 
     auto rep1 = unionFind->find(t1);
@@ -203,12 +218,12 @@ std::shared_ptr<TipType> Unifier::close(
 
       // If the variable is an alpha, then reuse it else create a new
       // alpha with the node.
-      auto newV = (isAlpha(v)) ? v : std::make_shared<TipAlpha>(v->getNode());
+      auto newV = (isAlpha(v)) ? v : context->getAlpha(v->getNode());
       auto freeV = TypeVars::collect(closedV.get());
       if (contains(freeV,newV)) {
         // Cyclic reference requires a mu type constructor
         auto substClosedV = Substituter::substitute(closedV.get(), v.get(), newV);
-        auto mu = std::make_shared<TipMu>(newV, substClosedV);
+        auto mu = context->getMu(newV, substClosedV);
 
         LOG_S(1) << "Close making " << *mu << " to end var " << *v;
         return mu;
@@ -220,7 +235,7 @@ std::shared_ptr<TipType> Unifier::close(
       }
     } else {
       // Unconstrained type variable - should we start with fresh names to make output cleaner?
-      auto alpha = std::make_shared<TipAlpha>(v->getNode());
+      auto alpha = context->getAlpha(v->getNode());
 
       LOG_S(1) << "Close making " << *alpha << " to end var " << *v;
       return alpha;
@@ -228,7 +243,6 @@ std::shared_ptr<TipType> Unifier::close(
 
   } else if (isCons(type)) {
     auto c = std::dynamic_pointer_cast<TipCons>(type);
-    auto copy = Copier::copy(c);
 
     LOG_S(1) << "Close starting cons " << *c << " with visited " << print(visited);
 
@@ -250,19 +264,19 @@ std::shared_ptr<TipType> Unifier::close(
       temp.clear();
     }
 
-    // replace arguments with current
-    c->setArguments(current);
+    // interned terms are immutable so build the closed constructor
+    auto closedC = context->withArguments(c.get(), current);
 
-    LOG_S(1) << "Close making " << *c << " to end cons " << *copy;
+    LOG_S(1) << "Close making " << *closedC << " to end cons " << *c;
 
-    return c;
+    return closedC;
 
   } else if (isMu(type)) {
     auto m = std::dynamic_pointer_cast<TipMu>(type);
 
     LOG_S(1) << "Close starting mu " << *m << " with visited " << print(visited);
 
-    auto closedMu = std::make_shared<TipMu>(m->getV(), close(m->getT(), visited));
+    auto closedMu = context->getMu(m->getV(), close(m->getT(), visited));
 
     LOG_S(1) << "Close making " << *closedMu << " to end mu " << *m;
 
@@ -276,16 +290,25 @@ std::shared_ptr<TipType> Unifier::close(
  *
  * Here we want to produce an inferred type that is "closed" in the
  * sense that all variables in the type definition are replaced with
- * their base types.  Because the close() function may destructively update
- * the unionFind structure, by generating new types, we save a copy
- * and restore it after closing.
+ * their base types.  Because the close() function updates the unionFind
+ * structure, by generating new types, we mark the structure and roll
+ * those changes back after closing.
  */ 
 std::shared_ptr<TipType> Unifier::inferred(std::shared_ptr<TipType> v) {
-  auto unionFindCopy = unionFind->copy();
   std::set<std::shared_ptr<TipVar>> visited;
-  auto closedV = close(v, visited);
-  unionFind = std::move(unionFindCopy);
-  return closedV;
+  unionFind->mark();
+  try {
+    auto closedV = close(context->intern(v), visited);
+    unionFind->rollback();
+    return closedV;
+  } catch (...) {
+    unionFind->rollback();
+    throw;
+  }
+}
+
+std::shared_ptr<TipType> Unifier::representative(std::shared_ptr<TipType> t) {
+  return unionFind->find(context->intern(t));
 }
 
 void Unifier::throwUnifyException(std::shared_ptr<TipType> t1, std::shared_ptr<TipType> t2) {
@@ -5,8 +5,10 @@
 #include "TypeConstraint.h"
 #include "UnionFind.h"
 #include "TipFunction.h"
+#include "TypeContext.h"
 #include "FunctionGroup.h"
 #include "SymbolTable.h"
+#include <map>
 #include <set>
 #include <vector>
 
@@ -18,6 +20,9 @@
  * Make uses of a union-find data structure. This class will throw a 
  * UnificationError anytime two terms cannot be unified, either because
  * their constructor or arity mismatch.
+ *
+ * All terms are interned in a TypeContext owned by the unifier, so the
+ * union-find and the inferred types share structurally equal subterms.
  */
 class Unifier {
 public:
@@ -49,6 +54,14 @@ public:
      */
     void solve();
 
+    /*! \brief Solve the constraints of a group of functions.
+     *
+     * Functions outside of the group are typed by the signatures imported
+     * into this unifier.  The closed types of the functions in the group
+     * are recorded as the type signatures of this unifier.
+     * \sa importSignature
+     * \sa getTypeSignatures
+     */
     void solve(FunctionGroup* group, SymbolTable* symbols);
 
     void solve(const std::vector<TypeConstraint>& constraints, FunctionGroup* group = nullptr);
@@ -61,6 +74,21 @@ public:
      */
     std::shared_ptr<TipType> inferred(std::shared_ptr<TipType> t);
 
+    /*! \brief Returns the representative of the class of the given type.
+     * \pre The unifier has computed a solution.
+     * Unlike inferred the type is not closed, so all types that were unified
+     * have the same representative and types that were not do not.
+     */
+    std::shared_ptr<TipType> representative(std::shared_ptr<TipType> t);
+
+    /*! \brief Type a function solved by another unifier.
+     *
+     * The signature is copied into this unifier with its alphas renamed
+     * apart, so that signatures imported from different unifiers never
+     * share variables.
+     */
+    void importSignature(ASTDeclNode* decl, std::shared_ptr<TipType> signature);
+
     std::map<std::string, std::shared_ptr<TipType>> getTypeSignatures();
 
 private:
@@ -73,8 +101,12 @@ private:
     void throwUnifyException(std::shared_ptr<TipType> TipType1, std::shared_ptr<TipType> TipType2);
 
     std::vector<TypeConstraint> constraints;
+    std::unique_ptr<TypeContext> context;
     std::unique_ptr<UnionFind> unionFind;
 
     std::map<std::string, std::shared_ptr<TipType>> funcMap;
+
+    // Numbers the alphas of copied function types
+    int substitutionId = 0;
 };
 
@@ -1,12 +1,8 @@
 #include "UnionFind.h"
-#include "Substituter.h"
 
 #include "loguru.hpp"
 #include <iostream>
-
-namespace { // Anonymous namespace for local helpers
-bool verbose = false;
-}
+#include <stdexcept>
 
 UnionFind::UnionFind(std::vector<std::shared_ptr<TipType>> seed) {
     for(auto &term : seed) {
@@ -14,47 +10,51 @@ UnionFind::UnionFind(std::vector<std::shared_ptr<TipType>> seed) {
     }
 }
 
-/*
-std::ostream& operator<<(std::ostream& os, const UnionFind& obj) {
-  return obj.print(os);
+void UnionFind::mark() {
+    marks.push_back(trail.size());
 }
 
-std::ostream &UnionFind::print(std::ostream &out) const {
-  out << "UnionFind edges {\n"; 
-  for(auto const &edge : edges) {
-    out << *edge.first << " -> " << *edge.second << std::endl;
-  }
-  out << "}\n"; 
-  return out; 
-}
-*/
-
-std::unique_ptr<UnionFind> UnionFind::copy() {
-  std::vector<std::shared_ptr<TipType>> emptySeed;
-  auto ufCopy = std::make_unique<UnionFind>(emptySeed);
-
-  // Insert the vertices and edges in the copy
-  for(auto const &edge : edges) {
-    auto src = Copier::copy(edge.first);
-    auto dest = Copier::copy(edge.second);
-    ufCopy->edges.insert(std::pair<std::shared_ptr<TipType>, std::shared_ptr<TipType>>(src, dest));
-  } 
-  return std::move(ufCopy);
+void UnionFind::rollback() {
+    auto checkpoint = marks.back();
+    marks.pop_back();
+
+    while(trail.size() > checkpoint) {
+        auto &change = trail.back();
+        if(change.array == nullptr) {
+            // Terms are only ever appended so the insertion is the last one
+            ids.erase(terms.back());
+            terms.pop_back();
+            parents.pop_back();
+            ranks.pop_back();
+            representatives.pop_back();
+        } else {
+            (*change.array)[change.index] = change.value;
+        }
+        trail.pop_back();
+    }
 }
 
-/*
- * Add path compression instead of iterative parent lookup.
+/*! \fn set
+ *
+ * All updates to existing entries go through here so that they are
+ * recorded on the trail while a mark is active.
  */
+void UnionFind::set(std::vector<int> &array, int index, int value) {
+    if(!marks.empty()) {
+        trail.push_back(Change{&array, index, array[index]});
+    }
+    array[index] = value;
+}
+
 std::shared_ptr<TipType> UnionFind::find(std::shared_ptr<TipType> t) {
     LOG_S(1) << "UnionFind looking for representive of " << *t;
 
     // Effectively a noop if the term is already in the map.
-    smart_insert(t);
+    auto id = smart_insert(t);
+    auto rep = representatives[root(id)];
 
-    auto parent = t;
-    while(*get_parent(parent) != *parent) {
-        parent = get_parent(parent);
-    }
+    // Callers rely on getting the term itself back when it is a representative.
+    auto parent = (rep == id) ? t : terms[rep];
 
     LOG_S(1) << "UnionFind found representative " << *parent;
 
@@ -62,62 +62,77 @@ std::shared_ptr<TipType> UnionFind::find(std::shared_ptr<TipType> t) {
 }
 
 void UnionFind::quick_union(std::shared_ptr<TipType> t1, std::shared_ptr<TipType> t2) {
-    smart_insert(t1);
-    smart_insert(t2);
-
-    auto t1_root = find(t1);
-    auto t2_root = find(t2);
-
-    // semantics-based insert
-    for(auto const &edge : edges) {
-        if(*t1_root == *edge.first) {
-            edges.erase(edge.first);
-            edges.insert(std::pair<std::shared_ptr<TipType>, std::shared_ptr<TipType>>(t1_root, t2_root));
-            break;
-        }
+    auto t1_root = root(smart_insert(t1));
+    auto t2_root = root(smart_insert(t2));
+
+    if(t1_root == t2_root) {
+        return;
+    }
+
+    // union-by-rank decides the shape, t2 still decides the representative
+    auto rep = representatives[t2_root];
+    if(ranks[t1_root] < ranks[t2_root]) {
+        set(parents, t1_root, t2_root);
+    } else if(ranks[t1_root] > ranks[t2_root]) {
+        set(parents, t2_root, t1_root);
+        set(representatives, t1_root, rep);
+    } else {
+        set(parents, t1_root, t2_root);
+        set(ranks, t2_root, ranks[t2_root] + 1);
     }
 }
 
 bool UnionFind::connected(std::shared_ptr<TipType> t1, std::shared_ptr<TipType> t2) {
-    return *find(t1) == *find(t2);
+    return root(smart_insert(t1)) == root(smart_insert(t2));
 }
 
-/*! \fn get_parent
+/*! \fn root
  *
- * Unification ensures that the forest that includes all relevant type nodes.
- * A tree within the forest is traversed by directed edges to the parent.
- * During closure of terms, new type nodes may be generated by substitution.
- * When they are encountered they are added to the forest.
+ * Walks to the root of the tree containing the id and then compresses
+ * the path so that every id visited points directly at the root.
  */
-std::shared_ptr<TipType> UnionFind::get_parent(std::shared_ptr<TipType> t) {
-    for(auto const &edge : edges) {
-        if(*t == *edge.first) {
-            return edge.second;
-        }
+int UnionFind::root(int id) {
+    auto r = id;
+    while(parents[r] != r) {
+        r = parents[r];
     }
-    
-    smart_insert(t);
-    return t;
+
+    while(parents[id] != r) {
+        auto next = parents[id];
+        set(parents, id, r);
+        id = next;
+    }
+    return r;
 }
 
-/**
- * Inserts should be based on the dereferenced value.
+/*! \fn smart_insert
+ *
+ * Inserts should be based on the dereferenced value.  Unification ensures
+ * that the forest includes all relevant type nodes, but during closure of
+ * terms new type nodes may be generated by substitution.  When they are
+ * encountered they are added to the forest as singletons.
+ *
+ * \return the id of the term
  */
-void UnionFind::smart_insert(std::shared_ptr<TipType> t) {
+int UnionFind::smart_insert(std::shared_ptr<TipType> t) {
     if(t == nullptr) {
         throw std::invalid_argument("Refusing to insert a nullptr into the map.");
     }
-    
-    LOG_S(1) << "UnionFind inserting term " << *t;
 
-    for(auto const &edge : edges) {
-        if(*t == *edge.first) {
-            LOG_S(1) << " ; already in the graph as " << *edge.first;
-            return;
-        }
+    auto id = static_cast<int>(terms.size());
+    auto inserted = ids.emplace(t, id);
+    if(!inserted.second) {
+        return inserted.first->second;
     }
 
-    LOG_S(1) << " ; adding new edge\n";
-    edges.insert(std::pair<std::shared_ptr<TipType>, std::shared_ptr<TipType>>(t, t));
-}
+    LOG_S(1) << "UnionFind adding new term " << *t;
 
+    terms.push_back(t);
+    parents.push_back(id);
+    ranks.push_back(0);
+    representatives.push_back(id);
+    if(!marks.empty()) {
+        trail.push_back(Change{nullptr, id, 0});
+    }
+    return id;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
-#include <map>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include <TipType.h>
 
@@ -9,6 +10,17 @@
  *
  * \brief Specialized implementation of a union-find data structure tailored to work with
  * TipTypes wrapped in shared pointers.
+ *
+ * Terms are interned by their structural hash into dense integer ids so that
+ * locating a term is an expected constant time operation rather than a scan
+ * over all terms.  The forest over those ids uses union-by-rank and path
+ * compression.  Since ranks, not the order of arguments to quick_union,
+ * determine the shape of the forest, the canonical representative of each
+ * class is tracked separately.
+ *
+ * Changes made after a call to mark are recorded on a trail so that they can
+ * be undone by rollback, which lets callers explore the structure, e.g., when
+ * closing types, without copying it.
  */
 class UnionFind {
 public:
@@ -16,20 +28,63 @@ public:
     explicit UnionFind(std::vector<std::shared_ptr<TipType>> seed);
     ~UnionFind() = default;
 
+    /*! \brief Returns the canonical representative of the term.
+     *
+     * The term is inserted if it has not been seen before.  If the term is
+     * its own representative the argument itself is returned.
+     */
     std::shared_ptr<TipType> find(std::shared_ptr<TipType> t1);
+
+    /*! \brief Merge the classes of the two terms.
+     *
+     * The representative of t2 becomes the representative of the merged class.
+     */
     void quick_union(std::shared_ptr<TipType> t1, std::shared_ptr<TipType>t2);
     bool connected(std::shared_ptr<TipType> t1, std::shared_ptr<TipType> t2);
 
-    /*! \brief Returns a deep copy of the union-find structure.
+    /*! \brief Start recording changes to the structure.
+     *
+     * Marks nest; each rollback undoes the changes since the matching mark.
      */
-    std::unique_ptr<UnionFind> copy();
+    void mark();
+
+    //! \brief Undo all changes made since the most recent mark.
+    void rollback();
+
+    //! \brief The number of distinct terms in the structure.
+    std::size_t size() const { return terms.size(); }
 
 private:
-    // A mapping from terms to parents.
-    std::map<std::shared_ptr<TipType>, std::shared_ptr<TipType>> edges;
+    struct TermHash {
+        std::size_t operator()(const std::shared_ptr<TipType> &t) const { return t->hash(); }
+    };
+    struct TermEqual {
+        bool operator()(const std::shared_ptr<TipType> &t1, const std::shared_ptr<TipType> &t2) const {
+            return *t1 == *t2;
+        }
+    };
 
-    std::shared_ptr<TipType> get_parent(std::shared_ptr<TipType> t);
-    void smart_insert(std::shared_ptr<TipType> t);
-    std::ostream& print(std::ostream &out) const;
-};
+    // The first inserted instance of each term indexed by id.
+    std::vector<std::shared_ptr<TipType>> terms;
+
+    // A mapping from terms to their ids based on structural equality.
+    std::unordered_map<std::shared_ptr<TipType>, int, TermHash, TermEqual> ids;
 
+    // The forest of ids along with the rank and representative of each root.
+    std::vector<int> parents;
+    std::vector<int> ranks;
+    std::vector<int> representatives;
+
+    // An undo log of changes and the trail positions of active marks.
+    struct Change {
+        std::vector<int> *array;  // nullptr records the insertion of a term
+        int index;
+        int value;
+    };
+    std::vector<Change> trail;
+    std::vector<std::size_t> marks;
+
+    int smart_insert(std::shared_ptr<TipType> t);
+    int root(int id);
+    void set(std::vector<int> &array, int index, int value);
+};
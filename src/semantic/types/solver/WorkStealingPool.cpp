@@ -0,0 +1,125 @@
+#include "WorkStealingPool.h"
+
+namespace { // Anonymous namespace for local helpers
+
+// The pool and index of the worker running on this thread, if any.
+thread_local const WorkStealingPool *currentPool = nullptr;
+thread_local unsigned currentWorker = 0;
+
+}
+
+WorkStealingPool::WorkStealingPool(unsigned threads) {
+    if(threads == 0) {
+        threads = 1;
+    }
+    for(unsigned i = 0; i < threads; i++) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for(unsigned i = 0; i < threads; i++) {
+        this->threads.emplace_back([this, i] { run(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    available.notify_all();
+    for(auto &t : threads) {
+        t.join();
+    }
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+    // Tasks submitted from a worker stay on that worker
+    auto self = (currentPool == this) ? currentWorker : 0;
+    {
+        // Counted before it can be stolen, so it cannot complete first
+        std::lock_guard<std::mutex> guard(lock);
+        queued++;
+        pending++;
+    }
+    {
+        std::lock_guard<std::mutex> guard(workers[self]->lock);
+        workers[self]->tasks.push_back(std::move(task));
+    }
+    available.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> guard(lock);
+    finished.wait(guard, [this] { return pending == 0; });
+    if(error) {
+        auto e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+/*! \fn take
+ *
+ * Pops the newest task of the worker's own deque or, failing that, steals
+ * the oldest task of the other workers.
+ */
+bool WorkStealingPool::take(unsigned self, std::function<void()> &task) {
+    {
+        std::lock_guard<std::mutex> guard(workers[self]->lock);
+        if(!workers[self]->tasks.empty()) {
+            task = std::move(workers[self]->tasks.back());
+            workers[self]->tasks.pop_back();
+            return true;
+        }
+    }
+
+    for(unsigned i = 1; i < workers.size(); i++) {
+        auto &victim = workers[(self + i) % workers.size()];
+        std::lock_guard<std::mutex> guard(victim->lock);
+        if(!victim->tasks.empty()) {
+            task = std::move(victim->tasks.front());
+            victim->tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::run(unsigned self) {
+    currentPool = this;
+    currentWorker = self;
+
+    while(true) {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            available.wait(guard, [this] { return queued > 0 || stopping; });
+            if(queued == 0 && stopping) {
+                return;
+            }
+        }
+
+        std::function<void()> task;
+        if(!take(self, task)) {
+            // Another worker got there first
+            std::this_thread::yield();
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            queued--;
+        }
+
+        try {
+            task();
+        } catch(...) {
+            std::lock_guard<std::mutex> guard(lock);
+            if(!error) {
+                error = std::current_exception();
+            }
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        if(--pending == 0) {
+            finished.notify_all();
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!
+ * \class WorkStealingPool
+ *
+ * \brief A fixed size thread pool where idle workers steal queued tasks.
+ *
+ * Each worker owns a deque of tasks.  Tasks submitted from a worker, e.g.,
+ * a task that makes its dependents ready, are pushed onto that worker's
+ * deque and popped LIFO for locality.  Workers that run out of tasks steal
+ * the oldest task from another worker.
+ */
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threads);
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool &) = delete;
+    ~WorkStealingPool();
+
+    //! \brief Queue a task.  May be called from within a running task.
+    void submit(std::function<void()> task);
+
+    /*! \brief Block until every submitted task has completed.
+     *
+     * If a task threw an exception the first one is rethrown here.
+     */
+    void wait();
+
+private:
+    struct Worker {
+        std::deque<std::function<void()>> tasks;
+        std::mutex lock;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    std::mutex lock;
+    std::condition_variable available;
+    std::condition_variable finished;
+    std::size_t queued = 0;
+    std::size_t pending = 0;
+    bool stopping = false;
+    std::exception_ptr error;
+
+    bool take(unsigned self, std::function<void()> &task);
+    void run(unsigned self);
+};
@@ -0,0 +1,246 @@
+#include "CompileServer.h"
+#include "InternalError.h"
+#include "loguru.hpp"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace { // Anonymous namespace for local helpers
+
+/*
+ * Messages are sequences of 32 bit integers and of strings, each sent as its
+ * length followed by its bytes.  Client and server run on the same host so
+ * integers are sent in its byte order.
+ */
+void sendBytes(int fd, const char *data, std::size_t size) {
+  while (size > 0) {
+    auto sent = ::write(fd, data, size);
+    if (sent < 0 && errno == EINTR) {
+      continue;
+    }
+    if (sent <= 0) {
+      throw InternalError("lost the connection to the compile server peer");
+    }
+    data += sent;
+    size -= sent;
+  }
+}
+
+void receiveBytes(int fd, char *data, std::size_t size) {
+  while (size > 0) {
+    auto received = ::read(fd, data, size);
+    if (received < 0 && errno == EINTR) {
+      continue;
+    }
+    if (received <= 0) {
+      throw InternalError("lost the connection to the compile server peer");
+    }
+    data += received;
+    size -= received;
+  }
+}
+
+void sendInt(int fd, int32_t value) {
+  sendBytes(fd, reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+int32_t receiveInt(int fd) {
+  int32_t value;
+  receiveBytes(fd, reinterpret_cast<char *>(&value), sizeof(value));
+  return value;
+}
+
+void sendString(int fd, const std::string &value) {
+  sendInt(fd, value.size());
+  sendBytes(fd, value.data(), value.size());
+}
+
+std::string receiveString(int fd) {
+  auto size = receiveInt(fd);
+  if (size < 0) {
+    throw InternalError("malformed message from the compile server peer");
+  }
+  std::string value(size, '\0');
+  receiveBytes(fd, &value[0], size);
+  return value;
+}
+
+sockaddr_un socketAddress(const std::string &socketPath) {
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (socketPath.size() >= sizeof(address.sun_path)) {
+    throw InternalError("socket path is too long: " + socketPath);
+  }
+  std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+  return address;
+}
+
+// A connected socket, or -1 if nothing listens on the path.
+int connectTo(const std::string &socketPath) {
+  auto address = socketAddress(socketPath);
+  int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    throw InternalError(std::string("cannot create a socket: ") + std::strerror(errno));
+  }
+  if (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+    ::close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+std::string currentDirectory() {
+  std::unique_ptr<char, decltype(&std::free)> directory(::getcwd(nullptr, 0), &std::free);
+  if (!directory) {
+    throw InternalError(std::string("cannot get the working directory: ") + std::strerror(errno));
+  }
+  return directory.get();
+}
+
+// Redirects a stream into a string for as long as it lives.
+class StreamCapture {
+  std::ostream &stream;
+  std::streambuf *original;
+  std::stringstream captured;
+
+public:
+  explicit StreamCapture(std::ostream &stream) : stream(stream), original(stream.rdbuf(captured.rdbuf())) {}
+  ~StreamCapture() { stream.rdbuf(original); }
+  std::string str() { stream.flush(); return captured.str(); }
+};
+
+}
+
+CompileServer::CompileServer(std::string socketPath) : socketPath(std::move(socketPath)) {
+  auto address = socketAddress(this->socketPath);
+
+  // A socket file nobody listens on is left behind by a server that was killed
+  int running = connectTo(this->socketPath);
+  if (running >= 0) {
+    ::close(running);
+    throw InternalError("a compile server is already listening on " + this->socketPath);
+  }
+  struct stat status;
+  if (::stat(this->socketPath.c_str(), &status) == 0 && S_ISSOCK(status.st_mode)) {
+    ::unlink(this->socketPath.c_str());
+  }
+
+  listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listener < 0 ||
+      ::bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+      ::listen(listener, SOMAXCONN) != 0) {
+    auto reason = std::strerror(errno);
+    if (listener >= 0) {
+      ::close(listener);
+    }
+    throw InternalError("cannot listen on " + this->socketPath + ": " + reason);
+  }
+}
+
+CompileServer::~CompileServer() {
+  ::close(listener);
+  ::unlink(socketPath.c_str());
+}
+
+void CompileServer::serve(const Handler &handler, unsigned requests) {
+  // Clients that go away must not take the server with them
+  std::signal(SIGPIPE, SIG_IGN);
+
+  unsigned served = 0;
+  while (requests == 0 || served < requests) {
+    int connection = ::accept(listener, nullptr, nullptr);
+    if (connection < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw InternalError(std::string("cannot accept a connection: ") + std::strerror(errno));
+    }
+
+    // Clients that disconnect early, e.g., to see if a server is running, are dropped
+    try {
+      serveConnection(connection, handler);
+    } catch (InternalError &e) {
+      LOG_S(1) << "Dropped a request: " << e.what();
+    }
+    ::close(connection);
+    served++;
+  }
+}
+
+/*
+ * The request is read in full before the working directory or the standard
+ * streams change, so a client that goes away leaves the server as it was.
+ */
+void CompileServer::serveConnection(int connection, const Handler &handler) {
+  auto count = receiveInt(connection);
+  auto directory = receiveString(connection);
+  std::vector<std::string> args;
+  for (int i = 0; i < count; i++) {
+    args.push_back(receiveString(connection));
+  }
+  LOG_S(1) << "Serving a request with " << count << " arguments in " << directory;
+
+  auto serverDirectory = currentDirectory();
+
+  Response response;
+  {
+    StreamCapture output(std::cout);
+    StreamCapture diagnostics(std::cerr);
+    if (::chdir(directory.c_str()) != 0) {
+      std::cerr << "tipc: error: cannot change to directory '" << directory << "': " << std::strerror(errno) << "\n";
+      response.status = EXIT_FAILURE;
+    } else {
+      try {
+        response.status = handler(args);
+      } catch (std::exception &e) {
+        std::cerr << "tipc: " << e.what() << "\n" << "tipc: internal error\n";
+        response.status = EXIT_FAILURE;
+      }
+    }
+    response.output = output.str();
+    response.diagnostics = diagnostics.str();
+  }
+  if (::chdir(serverDirectory.c_str()) != 0) {
+    throw InternalError("cannot return to directory " + serverDirectory);
+  }
+
+  sendInt(connection, response.status);
+  sendString(connection, response.output);
+  sendString(connection, response.diagnostics);
+}
+
+CompileServer::Response CompileServer::request(const std::string &socketPath,
+                                               const std::vector<std::string> &args) {
+  int connection = connectTo(socketPath);
+  if (connection < 0) {
+    throw InternalError("no compile server is listening on " + socketPath);
+  }
+
+  Response response;
+  try {
+    sendInt(connection, args.size());
+    sendString(connection, currentDirectory());
+    for (auto &arg : args) {
+      sendString(connection, arg);
+    }
+    response.status = receiveInt(connection);
+    response.output = receiveString(connection);
+    response.diagnostics = receiveString(connection);
+  } catch (InternalError &) {
+    ::close(connection);
+    throw;
+  }
+  ::close(connection);
+  return response;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/*! \class CompileServer
+ *  \brief Serve compilations to clients over a local Unix socket.
+ *
+ * Starting tipc initializes LLVM, registers its command line options and
+ * deserializes the ANTLR ATN of the TIP grammar, and the first parses fill
+ * the DFA caches of the parser.  For many small compilations this startup
+ * dominates.  A server pays for it once and then compiles each request in
+ * the same process, so these caches stay warm across requests.
+ *
+ * A request is the command line of a compilation and the working directory
+ * of the client, the response is its exit status along with what it wrote
+ * to stdout and stderr.  The server runs in the working directory of each
+ * request, so output files, e.g., bitcode or objects, are written where the
+ * client would have written them.  Requests are served one at a time.
+ */
+class CompileServer {
+public:
+  /*! \brief Compile the given command line arguments.
+   *
+   * Called in the working directory of the request with stdout and stderr
+   * captured for the response.
+   * \return the exit status of the compilation
+   */
+  using Handler = std::function<int(const std::vector<std::string> &args)>;
+
+  //! \brief The result of a request.
+  struct Response {
+    int status;
+    std::string output;
+    std::string diagnostics;
+  };
+
+  /*! \brief Listen on the socket, replacing a stale socket file.
+   *
+   * \throws InternalError if the socket cannot be created or another
+   *         server is listening on it
+   */
+  explicit CompileServer(std::string socketPath);
+
+  //! \brief Stop listening and remove the socket file.
+  ~CompileServer();
+
+  /*! \brief Serve requests with the handler.
+   *
+   * \param requests the number of requests to serve before returning,
+   *        or 0 to serve forever
+   */
+  void serve(const Handler &handler, unsigned requests = 0);
+
+  /*! \brief Send a request to the server listening on the socket.
+   *
+   * \param socketPath the socket of the server
+   * \param args the command line arguments, without the program name
+   * \throws InternalError if there is no server or the connection fails
+   */
+  static Response request(const std::string &socketPath, const std::vector<std::string> &args);
+
+private:
+  std::string socketPath;
+  int listener = -1;
+
+  void serveConnection(int connection, const Handler &handler);
+};
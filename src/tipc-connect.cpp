@@ -0,0 +1,28 @@
+#include "CompileServer.h"
+#include "InternalError.h"
+#include <iostream>
+
+/*! \brief tipc-connect client.
+ *
+ * Compiles with a tipc started with --server instead of starting a compiler.
+ * The first argument is the socket of the server and the others are passed
+ * to it as the command line of tipc.  The output, diagnostics and exit status
+ * are those of the compilation.  The client links neither LLVM nor ANTLR, so
+ * it starts in a fraction of the time tipc does.
+ */
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "usage: tipc-connect <socket> <tipc arguments>...\n";
+    return EXIT_FAILURE;
+  }
+
+  try {
+    auto response = CompileServer::request(argv[1], std::vector<std::string>(argv + 2, argv + argc));
+    std::cout << response.output;
+    std::cerr << response.diagnostics;
+    return response.status;
+  } catch (InternalError& e) {
+    std::cerr << "tipc-connect: " << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+}
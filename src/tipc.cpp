@@ -1,68 +1,166 @@
 #include "FrontEnd.h"
+#include "MappedFile.h"
 #include "SemanticAnalysis.h"
 #include "CodeGenerator.h"
 #include "Optimizer.h"
+#include "JIT.h"
+#include "CompileServer.h"
 #include "ParseError.h"
 #include "InternalError.h"
 #include "SemanticError.h"
 #include "llvm/Support/CommandLine.h"
 #include "loguru.hpp"
-#include <fstream>
+#include <functional>
 
 using namespace llvm;
 using namespace std;
 
+// The runtime library object built along with tipc
+#ifndef TIP_RTLIB_OBJECT
+#define TIP_RTLIB_OBJECT "tip_rtlib.o"
+#endif
+
+enum EmitKind { EmitBitcode, EmitLLVMAssembly, EmitObject, EmitAssembly, EmitExecutable };
+
 static cl::OptionCategory TIPcat("tipc Options",
                                  "Options for controlling the TIP compilation process.");
 static cl::opt<bool> ppretty("pp", cl::desc("pretty print"), cl::cat(TIPcat));
 static cl::opt<bool> psym("ps", cl::desc("print symbols"), cl::cat(TIPcat));
 static cl::opt<bool> ptypes("pt", cl::desc("print symbols with types (supercedes --ps)"), cl::cat(TIPcat));
-static cl::opt<bool> disopt("do", cl::desc("disable bitcode optimization"), cl::cat(TIPcat));
+static cl::opt<bool> disopt("do", cl::desc("disable bitcode optimization (same as -O0)"), cl::cat(TIPcat));
+static cl::opt<Optimizer::OptLevel> optLevel(cl::desc("optimization level (default -O2):"),
+                                             cl::values(
+                                                 clEnumValN(Optimizer::O0, "O0", "no optimization"),
+                                                 clEnumValN(Optimizer::O1, "O1", "fast optimization"),
+                                                 clEnumValN(Optimizer::O2, "O2", "default optimization"),
+                                                 clEnumValN(Optimizer::O3, "O3", "aggressive optimization"),
+                                                 clEnumValN(Optimizer::Os, "Os", "optimize for size")),
+                                             cl::init(Optimizer::O2),
+                                             cl::cat(TIPcat));
+static cl::opt<std::string> passes("passes",
+                                   cl::desc("run a custom optimization pipeline instead of an -O level"),
+                                   cl::value_desc("pipeline"),
+                                   cl::init(""),
+                                   cl::cat(TIPcat));
+static cl::opt<unsigned> jobs("jobs",
+                              cl::desc("number of threads used for parsing, type inference and code generation"),
+                              cl::value_desc("N"),
+                              cl::init(1),
+                              cl::cat(TIPcat));
+static cl::opt<bool> gc("gc",
+                        cl::desc("reclaim unreachable heap memory with a garbage collector"),
+                        cl::cat(TIPcat));
+static cl::opt<std::string> cacheDir("cache",
+                                     cl::desc("reuse the code of unchanged functions from a cache directory"),
+                                     cl::value_desc("directory"),
+                                     cl::init(""),
+                                     cl::cat(TIPcat));
+#ifdef TIP_EMBED_RUNTIME
+static cl::opt<bool> lto("lto",
+                         cl::desc("link the runtime library into the program before optimizing it"),
+                         cl::cat(TIPcat));
+#else
+// Built without the embedded runtime, programs are always linked with its object
+static const bool lto = false;
+#endif
+static cl::opt<bool> run("run",
+                         cl::desc("run the program in process instead of emitting bitcode"),
+                         cl::cat(TIPcat));
+static cl::opt<std::string> serverSocket("server",
+                                         cl::desc("serve compilations on a Unix socket until killed"),
+                                         cl::value_desc("socket"),
+                                         cl::init(""),
+                                         cl::cat(TIPcat));
+static cl::opt<FrontEnd::ParserKind> parser("parser",
+                                            cl::desc("parser of the front end (default antlr):"),
+                                            cl::values(
+                                                clEnumValN(FrontEnd::ANTLR, "antlr", "parser generated by ANTLR"),
+                                                clEnumValN(FrontEnd::DESCENT, "descent", "hand written recursive descent parser")),
+                                            cl::init(FrontEnd::ANTLR),
+                                            cl::cat(TIPcat));
 static cl::opt<bool> debug("verbose", cl::desc("enable log messages"), cl::cat(TIPcat));
 static cl::opt<bool> emitHrAsm("asm",
                            cl::desc("emit human-readable LLVM assembly language instead of LLVM Bitcode"),
                            cl::cat(TIPcat));
+static cl::opt<EmitKind> emitKind("emit",
+                                  cl::desc("kind of file to emit (default bc):"),
+                                  cl::values(
+                                      clEnumValN(EmitBitcode, "bc", "LLVM bitcode"),
+                                      clEnumValN(EmitLLVMAssembly, "ll", "LLVM assembly language (same as --asm)"),
+                                      clEnumValN(EmitObject, "obj", "native object file"),
+                                      clEnumValN(EmitAssembly, "asm", "native assembly language"),
+                                      clEnumValN(EmitExecutable, "exe", "native executable linked with the runtime library")),
+                                  cl::init(EmitBitcode),
+                                  cl::cat(TIPcat));
+static cl::opt<std::string> rtlib("rtlib",
+                                  cl::desc("runtime library object linked by --emit=exe"),
+                                  cl::value_desc("object"),
+                                  cl::init(TIP_RTLIB_OBJECT),
+                                  cl::cat(TIPcat));
 static cl::opt<std::string> logfile("log",
                                    cl::value_desc("logfile"),
                                    cl::desc("log all messages to logfile (enables --verbose)"),
+                                   cl::init(""),
                                    cl::cat(TIPcat));
 static cl::opt<std::string> sourceFile(cl::Positional,
                                        cl::desc("<tip source file>"),
-                                       cl::Required,
+                                       cl::init(""),
                                        cl::cat(TIPcat));
+static cl::list<std::string> moreInputs(cl::Positional,
+                                        cl::desc("<more tip source files, then program arguments of --run, "
+                                                 "after -- if negative>..."),
+                                        cl::cat(TIPcat));
 
-/*! \brief tipc driver.
- * 
- * This function is the entry point for tipc.   It handles command line parsing
- * using LLVM CommandLine support.  It runs the phases of the compiler in sequence.
- * If an error is detected, via an exception, it reports the error and exits.  
- * If there is no error, then the LLVM bitcode is emitted to a file whose name
- * is the provided source file suffixed by ".bc".
+static const char *const overview = "tipc - a TIP to llvm compiler\n";
+
+/*! \brief Compile the source files as selected by the options.
+ *
+ * Runs the phases of the compiler in sequence.  The source files are parsed
+ * in parallel and together form one program.  If an error is detected, via
+ * an exception, it reports the error and returns a failure status.  If there
+ * is no error, then the LLVM bitcode is emitted to a file whose name is the
+ * first source file suffixed by ".bc", or the kind of file selected by
+ * --emit.  With --run the program is instead compiled to memory and run with
+ * the remaining arguments, and the process exits with its status.
  */
-int main(int argc, char *argv[]) {
-  cl::HideUnrelatedOptions(TIPcat);
-  cl::ParseCommandLineOptions(argc, argv, "tipc - a TIP to llvm compiler\n");
+static int compile() {
+  if (sourceFile.empty()) {
+    LOG_S(ERROR) << "tipc: error: no tip source file given";
+    return EXIT_FAILURE;
+  }
 
-  loguru::g_preamble = false;
-  bool logging = !logfile.getValue().empty();
-  if(debug || logging) {
-    loguru::g_preamble = true;
-    loguru::g_preamble_date = false;
-    loguru::g_preamble_time = false;
-    loguru::g_preamble_uptime = false;
-    loguru::g_preamble_thread = false;
-    loguru::init(argc, argv);
-    loguru::g_stderr_verbosity = logging ? loguru::Verbosity_OFF : 1;
-    if (logging) {
-      loguru::add_file(logfile.getValue().c_str(), loguru::Append, loguru::Verbosity_MAX);
+  if (!passes.empty()) {
+    auto problem = Optimizer::checkPipeline(passes);
+    if (!problem.empty()) {
+      LOG_S(ERROR) << "tipc: error: invalid pass pipeline: " << problem;
+      return EXIT_FAILURE;
     }
   }
 
-  std::ifstream stream;
-  stream.open(sourceFile);
-  if(!stream.good()) {
-    LOG_S(ERROR) << "tipc: error: no such file: '" << sourceFile << "'";
-    exit(1);
+  /*
+   * The positional arguments after the first are further source files of the
+   * program.  With --run the program arguments follow them, so there only
+   * the leading arguments naming .tip files are taken as sources.
+   */
+  std::vector<std::string> sourceFiles { sourceFile };
+  std::vector<std::string> programArgs;
+  for (auto &input : moreInputs) {
+    if (!run || (programArgs.empty() && StringRef(input).endswith(".tip"))) {
+      sourceFiles.push_back(input);
+    } else {
+      programArgs.push_back(input);
+    }
+  }
+
+  std::vector<std::unique_ptr<MappedFile>> mappedFiles;
+  std::vector<FrontEnd::Source> sources;
+  for (auto &file : sourceFiles) {
+    mappedFiles.push_back(std::make_unique<MappedFile>(file));
+    if (!mappedFiles.back()->good()) {
+      LOG_S(ERROR) << "tipc: error: no such file: '" << file << "'";
+      return EXIT_FAILURE;
+    }
+    sources.push_back({ file, mappedFiles.back()->getContents() });
   }
 
   /*
@@ -72,10 +170,12 @@ int main(int argc, char *argv[]) {
    * the underlying pointer, i.e., via a call to get().
    */
   try {
-    auto ast = FrontEnd::parse(stream);
+    // Errors in a single file are reported without its name, as they always were
+    auto ast = sources.size() == 1 ? FrontEnd::parse(sources[0].text, parser)
+                                   : FrontEnd::parse(sources, parser, jobs);
 
     try {
-      auto analysisResults = SemanticAnalysis::analyze(ast.get());
+      auto analysisResults = SemanticAnalysis::analyze(ast.get(), jobs);
 
       if (ppretty) {
         FrontEnd::prettyprint(ast.get(), std::cout);
@@ -86,14 +186,47 @@ int main(int argc, char *argv[]) {
       } else if (psym) {
         analysisResults->getSymbolTable()->print(std::cout);
       }
-      auto llvmModule = CodeGenerator::generate(ast.get(), analysisResults.get(), sourceFile);
+      // Functions are optimized on the thread that generated them
+      std::function<void(llvm::Module*)> optimize;
+      if (!passes.empty()) {
+        optimize = [](llvm::Module* m) { Optimizer::optimize(m, passes.getValue()); };
+      } else if (!disopt && optLevel != Optimizer::O0) {
+        optimize = [](llvm::Module* m) { Optimizer::optimize(m, optLevel.getValue()); };
+      }
+
+      // The JIT takes ownership of the context along with the module
+      auto context = std::make_unique<llvm::LLVMContext>();
+      // Cached code is only valid for the options that shaped it
+      std::unique_ptr<CodeGenCache> cache;
+      if (!cacheDir.empty()) {
+        auto level = (disopt ? Optimizer::O0 : optLevel.getValue());
+        cache = std::make_unique<CodeGenCache>(cacheDir, "O" + std::to_string(level) + " passes=" +
+                                               passes.getValue() + " lto=" + std::to_string(lto));
+      }
 
-      if (!disopt) {
-        Optimizer::optimize(llvmModule.get());
+      auto llvmModule = CodeGenerator::generate(ast.get(), analysisResults.get(), sourceFile, *context,
+                                                jobs, lto ? nullptr : optimize, gc, cache.get());
+
+#ifdef TIP_EMBED_RUNTIME
+      // With the runtime linked in the whole program is optimized at once
+      if (lto) {
+        CodeGenerator::linkRuntime(llvmModule.get());
+        if (optimize) {
+          optimize(llvmModule.get());
+        }
       }
+#endif
 
-      if(emitHrAsm) {
+      if (run) {
+        JIT jit(std::move(llvmModule), std::move(context), lto);
+        // Exit while the program is still loaded, its runtime may have exit handlers
+        exit(jit.run(sourceFile, programArgs));
+      } else if(emitHrAsm || emitKind == EmitLLVMAssembly) {
         CodeGenerator::emitHumanReadableAssembly(llvmModule.get());
+      } else if (emitKind == EmitObject || emitKind == EmitAssembly) {
+        CodeGenerator::emitNative(llvmModule.get(), emitKind == EmitAssembly);
+      } else if (emitKind == EmitExecutable) {
+        CodeGenerator::emitExecutable(llvmModule.get(), lto ? "" : rtlib.getValue());
       } else {
         CodeGenerator::emit(llvmModule.get());
       }
@@ -101,16 +234,121 @@ int main(int argc, char *argv[]) {
     } catch (SemanticError& e) {
       LOG_S(ERROR) << "tipc: " << e.what();
       LOG_S(ERROR) << "tipc: semantic error";
-      exit (EXIT_FAILURE);
+      return EXIT_FAILURE;
     } catch (InternalError& e) {
       LOG_S(ERROR) << "tipc: " << e.what();
       LOG_S(ERROR) << "tipc: internal error";
-      exit (EXIT_FAILURE);
+      return EXIT_FAILURE;
     }
   } catch (ParseError& e) {
     LOG_S(ERROR) << "tipc: " << e.what();
     LOG_S(ERROR) << "tipc: parse error";
-    exit (EXIT_FAILURE);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+// Forwards log messages of a request to its diagnostics.
+static void logToStderr(void *, const loguru::Message &message) {
+  std::cerr << message.preamble << message.indentation << message.prefix << message.message << "\n";
+}
+
+/*! \brief Compile a request of the compile server.
+ *
+ * The options of the request replace those of the previous one.  Its log
+ * messages are written to stderr, which the server returns to the client,
+ * instead of to the stderr of the server.
+ */
+static int serveRequest(const std::vector<std::string> &args) {
+  std::vector<const char *> argv { "tipc" };
+  for (auto &arg : args) {
+    // These print and exit, which would stop the server
+    auto option = StringRef(arg).ltrim('-');
+    if (arg.size() > option.size() && (option.startswith("help") || option == "version")) {
+      std::cerr << "tipc: error: " << arg << " is not accepted by the compile server\n";
+      return EXIT_FAILURE;
+    }
+    argv.push_back(arg.c_str());
+  }
+
+  // String options are initialized to "" so that they are reset as well
+  cl::ResetAllOptionOccurrences();
+  std::string errors;
+  raw_string_ostream errorStream(errors);
+  if (!cl::ParseCommandLineOptions(argv.size(), argv.data(), overview, &errorStream)) {
+    std::cerr << errorStream.str();
+    return EXIT_FAILURE;
+  }
+  if (run || !serverSocket.empty()) {
+    std::cerr << "tipc: error: " << (run ? "--run" : "--server") << " is not accepted by the compile server\n";
+    return EXIT_FAILURE;
+  }
+
+  bool logging = !logfile.getValue().empty();
+  loguru::g_preamble = debug || logging;
+  auto stderrVerbosity = loguru::g_stderr_verbosity;
+  loguru::g_stderr_verbosity = loguru::Verbosity_OFF;
+  if (logging) {
+    loguru::add_file(logfile.getValue().c_str(), loguru::Append, loguru::Verbosity_MAX);
+  } else {
+    loguru::add_callback("request", logToStderr, nullptr, debug ? 1 : loguru::Verbosity_INFO);
+  }
+
+  auto stopLogging = [&]() {
+    loguru::remove_callback(logging ? logfile.getValue().c_str() : "request");
+    loguru::g_stderr_verbosity = stderrVerbosity;
+  };
+  try {
+    auto status = compile();
+    stopLogging();
+    return status;
+  } catch (...) {
+    stopLogging();
+    throw;
+  }
+}
+
+/*! \brief tipc driver.
+ * 
+ * This function is the entry point for tipc.   It handles command line parsing
+ * using LLVM CommandLine support and then compiles the source files.  With
+ * --server it instead compiles the requests of clients, see tipc-connect,
+ * until it is killed.
+ */
+int main(int argc, char *argv[]) {
+  cl::HideUnrelatedOptions(TIPcat);
+  cl::ParseCommandLineOptions(argc, argv, overview);
+
+  // Requests of the server are logged with the same preamble
+  loguru::g_preamble = false;
+  loguru::g_preamble_date = false;
+  loguru::g_preamble_time = false;
+  loguru::g_preamble_uptime = false;
+  loguru::g_preamble_thread = false;
+
+  bool logging = !logfile.getValue().empty();
+  if(debug || logging) {
+    loguru::g_preamble = true;
+    loguru::init(argc, argv);
+    loguru::g_stderr_verbosity = logging ? loguru::Verbosity_OFF : 1;
+    if (logging) {
+      loguru::add_file(logfile.getValue().c_str(), loguru::Append, loguru::Verbosity_MAX);
+    }
+  }
+
+  if (!serverSocket.empty()) {
+    try {
+      CompileServer server(serverSocket);
+      FrontEnd::prewarm();
+      LOG_S(INFO) << "tipc: serving compilations on " << serverSocket;
+      server.serve(serveRequest);
+      return EXIT_SUCCESS;
+    } catch (InternalError& e) {
+      LOG_S(ERROR) << "tipc: " << e.what();
+      return EXIT_FAILURE;
+    }
   }
 
+  return compile();
 }
@@ -0,0 +1,4 @@
+#!/usr/bin/env bash
+# Generates the input read by input.tip
+echo 5000000
+seq -2500000 2499999
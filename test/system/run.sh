@@ -2,6 +2,7 @@
 
 declare -r ROOT_DIR=${TRAVIS_BUILD_DIR:-$(git rev-parse --show-toplevel)}
 declare -r TIPC=${ROOT_DIR}/build/src/tipc
+declare -r TIPC_CONNECT=${ROOT_DIR}/build/src/tipc-connect
 declare -r RTLIB=${ROOT_DIR}/rtlib
 declare -r SCRATCH_DIR=$(mktemp -d)
 
@@ -67,6 +68,95 @@ do
   rm $i.bc
 done
 
+for level in -O1 -O3 -Os --gc
+do
+  for i in selftests/*.tip
+  do
+    initialize_test
+    base="$(basename $i .tip)"
+
+    ${TIPC} ${level} $i
+    ${TIPCLANG} $i.bc ${RTLIB}/tip_rtlib.bc -o $base
+
+    ./${base} &>/dev/null
+    exit_code=${?}
+    if [ ${exit_code} -ne 0 ]; then
+      echo -n "Test failure for ${level} : "
+      echo $i
+      ./${base}
+      ((numfailures++))
+    else
+      rm ${base}
+    fi
+    rm $i.bc
+  done
+done
+
+# Executables emitted directly by tipc, with and without the runtime linked
+# in, which is only possible when tipc was built with the runtime embedded
+lto_modes=""
+if ${TIPC} --help | grep -q -e "--lto"; then
+  lto_modes="--lto"
+fi
+for lto in "" ${lto_modes}
+do
+  for i in selftests/*.tip
+  do
+    initialize_test
+    base="$(basename $i .tip)"
+
+    ${TIPC} ${lto} --emit=exe $i
+
+    selftests/${base} &>/dev/null
+    exit_code=${?}
+    if [ ${exit_code} -ne 0 ]; then
+      echo -n "Test failure for ${lto} --emit=exe : "
+      echo $i
+      selftests/${base}
+      ((numfailures++))
+    else
+      rm selftests/${base}
+    fi
+  done
+done
+
+# The executable is written next to a source in another directory
+initialize_test
+cp iotests/fib.tip ${SCRATCH_DIR}/fib.tip
+${TIPC} --emit=exe ${SCRATCH_DIR}/fib.tip
+${SCRATCH_DIR}/fib 7 >${SCRATCH_DIR}/fib.output 2>&1
+diff ${SCRATCH_DIR}/fib.output iotests/fib-7.expected >${SCRATCH_DIR}/fib.diff
+if [[ -s ${SCRATCH_DIR}/fib.diff ]] || [ -e fib ]
+then
+  echo "Test failure for --emit=exe in another directory : iotests/fib.tip"
+  cat ${SCRATCH_DIR}/fib.diff
+  ((numfailures++))
+  rm -f fib
+fi
+
+# Sources without the .tip suffix lose whatever extension they have, and
+# a source without any extension is refused rather than overwritten
+initialize_test
+cp iotests/fib.tip ${SCRATCH_DIR}/fib.TIP
+${TIPC} --emit=exe ${SCRATCH_DIR}/fib.TIP
+${SCRATCH_DIR}/fib 7 >${SCRATCH_DIR}/fib.output 2>&1
+diff ${SCRATCH_DIR}/fib.output iotests/fib-7.expected >${SCRATCH_DIR}/fib.diff
+if [[ -s ${SCRATCH_DIR}/fib.diff ]]
+then
+  echo "Test failure for --emit=exe without the .tip suffix : iotests/fib.tip"
+  cat ${SCRATCH_DIR}/fib.diff
+  ((numfailures++))
+fi
+
+initialize_test
+cp iotests/fib.tip ${SCRATCH_DIR}/fib
+${TIPC} --emit=exe ${SCRATCH_DIR}/fib &>/dev/null
+exit_code=${?}
+if [ ${exit_code} -eq 0 ] || ! cmp -s ${SCRATCH_DIR}/fib iotests/fib.tip; then
+  echo "Test failure for --emit=exe without an extension : iotests/fib.tip expected error"
+  ((numfailures++))
+fi
+
 # IO related test cases
 for i in iotests/*.expected
 do
@@ -95,6 +185,40 @@ do
   rm $executable
 done
 
+# The same IO test cases run in process by the compiler
+for i in iotests/*.expected
+do
+  initialize_test
+  expected="$(basename $i .tip)"
+  executable="$(echo $expected | cut -f1 -d-)"
+  input="$(echo $expected | cut -f2 -d- | cut -f1 -d.)"
+
+  ${TIPC} --run iotests/$executable.tip $input >${SCRATCH_DIR}/$executable.output 2>&1
+
+  diff ${SCRATCH_DIR}/$executable.output $i > ${SCRATCH_DIR}/$executable.diff
+
+  if [[ -s ${SCRATCH_DIR}/$executable.diff ]]
+  then
+    echo -n "Test differences for --run : "
+    echo $i
+    cat ${SCRATCH_DIR}/$executable.diff
+    ((numfailures++))
+  fi
+done
+
+for i in selftests/*.tip
+do
+  initialize_test
+
+  ${TIPC} --run $i &>/dev/null
+  exit_code=${?}
+  if [ ${exit_code} -ne 0 ]; then
+    echo -n "Test failure for --run : "
+    echo $i
+    ((numfailures++))
+  fi
+done
+
 # Tests to cover driver logic for error and argument handling
 for i in iotests/*error.tip
 do
@@ -123,6 +247,28 @@ then
   ((numfailures++))
 fi 
 
+# A program split over several files, which must not define a function twice
+initialize_test
+sed -n '/^fib/,/^}/p' iotests/fib.tip >${SCRATCH_DIR}/fib1.tip
+sed -n '/^main/,/^}/p' iotests/fib.tip >${SCRATCH_DIR}/fib2.tip
+${TIPC} --jobs=2 --run ${SCRATCH_DIR}/fib1.tip ${SCRATCH_DIR}/fib2.tip 7 >${SCRATCH_DIR}/fib.output 2>&1
+diff ${SCRATCH_DIR}/fib.output iotests/fib-7.expected >${SCRATCH_DIR}/fib.diff
+if [[ -s ${SCRATCH_DIR}/fib.diff ]]
+then
+  echo "Test differences for several files : iotests/fib-7.expected"
+  cat ${SCRATCH_DIR}/fib.diff
+  ((numfailures++))
+fi
+
+initialize_test
+${TIPC} iotests/fib.tip iotests/fib.tip &>/dev/null
+exit_code=${?}
+if [ ${exit_code} -eq 0 ]; then
+  echo "Test failure for several files : iotests/fib.tip expected error"
+  ((numfailures++))
+  rm iotests/fib.tip.bc
+fi
+
 # Type checking at the system level
 for i in selftests/*.tip
 do
@@ -140,6 +286,64 @@ do
   fi 
 done
 
+# The same test cases compiled by a compile server, whose socket is kept
+# out of the scratch directory since that is emptied for each test
+declare -r SERVER_DIR=$(mktemp -d)
+declare -r SOCKET=${SERVER_DIR}/tipc.sock
+${TIPC} --server=${SOCKET} &>/dev/null &
+server_pid=$!
+for wait in $(seq 50); do [ -S ${SOCKET} ] && break; sleep 0.1; done
+
+for i in selftests/*.tip
+do
+  initialize_test
+  base="$(basename $i .tip)"
+
+  ${TIPC_CONNECT} ${SOCKET} $i
+  ${TIPCLANG} $i.bc ${RTLIB}/tip_rtlib.bc -o $base
+
+  ./${base} &>/dev/null
+  exit_code=${?}
+  if [ ${exit_code} -ne 0 ]; then
+    echo -n "Test failure for --server : "
+    echo $i
+    ./${base}
+    ((numfailures++))
+  else
+    rm ${base}
+  fi
+  rm $i.bc
+done
+
+for i in iotests/*error.tip
+do
+  initialize_test
+
+  ${TIPC_CONNECT} ${SOCKET} $i &>/dev/null
+  exit_code=${?}
+  if [ ${exit_code} -eq 0 ]; then
+    echo -n "Test failure for --server : "
+    echo -n $i
+    echo " expected error"
+    ((numfailures++))
+    rm iotests/*error.tip.bc
+  fi
+done
+
+initialize_test
+${TIPC_CONNECT} ${SOCKET} -pp -ps iotests/fib.tip >${SCRATCH_DIR}/fib.ppps
+diff iotests/fib.ppps ${SCRATCH_DIR}/fib.ppps >${SCRATCH_DIR}/fib.diff
+if [[ -s ${SCRATCH_DIR}/fib.diff ]]
+then
+  echo "Test differences for --server : iotests/fib.ppps"
+  cat ${SCRATCH_DIR}/fib.diff
+  ((numfailures++))
+fi
+
+kill ${server_pid}
+wait ${server_pid} 2>/dev/null
+rm -r ${SERVER_DIR}
+
 # Logging test 
 #   kick the tires on logging to make sure there are null pointer derefs
 initialize_test
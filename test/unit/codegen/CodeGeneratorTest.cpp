@@ -0,0 +1,330 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "ASTHelper.h"
+#include "CodeGenerator.h"
+#include "Optimizer.h"
+#include "SemanticAnalysis.h"
+#include "llvm/BinaryFormat/Magic.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::string GenerateIR(const std::string &program, llvm::LLVMContext &context, bool gc = false) {
+    std::stringstream stream;
+    stream << program;
+    auto ast = ASTHelper::build_ast(stream);
+    auto analysis = SemanticAnalysis::analyze(ast.get());
+    auto module = CodeGenerator::generate(ast.get(), analysis.get(), "test", context, gc);
+    REQUIRE_FALSE(llvm::verifyModule(*module, &llvm::errs()));
+
+    std::string ir;
+    llvm::raw_string_ostream os(ir);
+    module->print(os, nullptr);
+    return os.str();
+}
+
+// Optimize at the default level of tipc.
+void Optimize(llvm::Module *module) {
+    Optimizer::optimize(module, Optimizer::O2);
+}
+
+// Names of the functions defined in the module.
+std::set<std::string> DefinedFunctions(llvm::Module &module) {
+    std::set<std::string> names;
+    for (auto &f : module) {
+        if (!f.isDeclaration()) {
+            names.insert(f.getName().str());
+        }
+    }
+    return names;
+}
+
+// A program of n functions where each calls its predecessor in a loop.
+std::string ChainProgram(int n) {
+    std::stringstream program;
+    program << "f0(x) { return x; }\n";
+    for (int i = 1; i < n; i++) {
+        program << "f" << i << "(x) { var i, r; i = 0; r = 0; "
+                << "while (x > i) { r = r + f" << i - 1 << "(i) * " << i << " + {a: i, b: r}.b; i = i + 1; } "
+                << "if (r > 100) { r = r - 100; } else { r = r + 1; } return r; }\n";
+    }
+    return program.str();
+}
+
+const std::vector<std::string> programs {
+    R"(main() { return 42; })",
+    R"(fib(n) { var r; if (n > 1) { r = fib(n - 1) + fib(n - 2); } else { r = n; } return r; }
+       main(n) { return fib(n); })",
+    R"(foo() { var r; r = {a: 1, b: 2}; return r.b; })",
+    R"(f(p) { *p = *p + 1; return 0; } main() { var x, y; x = 1; y = f(&x); while (x > 0) { x = x - 1; } output x; return x; })",
+};
+
+}
+
+TEST_CASE("CodeGenerator: Test compilations do not share state", "[CodeGenerator]") {
+    llvm::LLVMContext c1, c2, c3;
+    auto first = GenerateIR(programs[3], c1);
+
+    // A program without main gets a generated _tip_main even after one with main
+    auto noMain = GenerateIR(programs[2], c2);
+    REQUIRE(noMain.find("define i64 @_tip_main()") != std::string::npos);
+    REQUIRE(noMain.find("_tip_main_undefined") != std::string::npos);
+
+    // Labels and fields start over for each program
+    REQUIRE(GenerateIR(programs[3], c3) == first);
+}
+
+TEST_CASE("CodeGenerator: Test concurrent compilations", "[CodeGenerator]") {
+    std::vector<std::string> expected;
+    for (auto &program : programs) {
+        llvm::LLVMContext context;
+        expected.push_back(GenerateIR(program, context));
+    }
+
+    const int rounds = 4;
+    std::vector<std::string> actual(programs.size() * rounds);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < actual.size(); i++) {
+        threads.emplace_back([&actual, i] {
+            llvm::LLVMContext context;
+            actual[i] = GenerateIR(programs[i % programs.size()], context);
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    for (int i = 0; i < actual.size(); i++) {
+        REQUIRE(actual[i] == expected[i % programs.size()]);
+    }
+}
+
+TEST_CASE("CodeGenerator: Test records are allocated with compact layouts", "[CodeGenerator]") {
+    llvm::LLVMContext context;
+    auto ir = GenerateIR(R"(
+      main() {
+        var x, y;
+        x = {a: 1, b: 2, c: 3, d: 4};
+        y = {e: 5};
+        return x.d + y.e;
+      }
+    )", context);
+
+    // Four and one int64 slots rather than five for each
+    REQUIRE(ir.find("@_tip_heap_refill(i64 32)") != std::string::npos);
+    REQUIRE(ir.find("@_tip_heap_refill(i64 8)") != std::string::npos);
+    REQUIRE(ir.find("@_tip_heap_refill(i64 40)") == std::string::npos);
+}
+
+TEST_CASE("CodeGenerator: Test heap allocation bumps the arena inline", "[CodeGenerator]") {
+    llvm::LLVMContext context;
+    auto ir = GenerateIR(R"(
+      main() {
+        var p;
+        p = alloc 7;
+        return *p;
+      }
+    )", context);
+
+    REQUIRE(ir.find("@_tip_heap_next = external global i8*") != std::string::npos);
+    REQUIRE(ir.find("getelementptr i8, i8* %heap.next, i64 8") != std::string::npos);
+    REQUIRE(ir.find("store i8* %heap.bumped, i8** @_tip_heap_next") != std::string::npos);
+    REQUIRE(ir.find("@calloc") == std::string::npos);
+}
+
+TEST_CASE("CodeGenerator: Test garbage collected functions link shadow stack frames", "[CodeGenerator]") {
+    llvm::LLVMContext context;
+    auto ir = GenerateIR(R"(
+      inc(x) { return x + 1; }
+      get(p) { return *p; }
+      main() {
+        var p, n, r;
+        n = inc(1);
+        p = alloc n;
+        r = {a: p, b: n};
+        return get(r.a) + r.b;
+      }
+    )", context, true);
+
+    // The cell may hold a reference, only the first slot of the record does
+    REQUIRE(ir.find("@_tip_gc_alloc(i64 8, i64 1)") != std::string::npos);
+    REQUIRE(ir.find("@_tip_gc_alloc(i64 16, i64 1)") != std::string::npos);
+    REQUIRE(ir.find("_tip_heap_refill") == std::string::npos);
+
+    // Main roots p and r, but not n, and a temporary for the initializer of
+    // the cell that is reused for the record.  Functions that cannot collect
+    // link no frame.
+    REQUIRE(ir.find("alloca { i8*, i64, [3 x i64*] }") != std::string::npos);
+    auto inc = ir.find("define i64 @inc");
+    auto get = ir.find("define i64 @get");
+    auto main = ir.find("define i64 @_tip_main");
+    REQUIRE(ir.find("gc.frame", inc) > main);
+    REQUIRE(ir.find("gc.frame", get) > main);
+
+    auto plain = GenerateIR(R"(main() { return *(alloc 3); })", context);
+    REQUIRE(plain.find("_tip_gc") == std::string::npos);
+}
+
+TEST_CASE("CodeGenerator: Test known callees are called directly", "[CodeGenerator]") {
+    llvm::LLVMContext c1, c2;
+
+    auto named = GenerateIR(programs[1], c1);
+    REQUIRE(named.find("call i64 @fib(") != std::string::npos);
+    REQUIRE(named.find("_tip_ftable, i64 0") == std::string::npos);
+
+    // Function values are still dispatched through the table
+    auto value = GenerateIR(R"(inc(x) { return x + 1; } main() { var f; f = inc; return f(1); })", c2);
+    REQUIRE(value.find("_tip_ftable, i64 0") != std::string::npos);
+    REQUIRE(value.find("call i64 @inc(") == std::string::npos);
+}
+
+TEST_CASE("CodeGenerator: Test parallel generation links the partitions", "[CodeGenerator]") {
+    std::vector<std::string> parallelPrograms { programs[1], programs[3], ChainProgram(10) };
+    for (auto &program : parallelPrograms) {
+        std::stringstream stream;
+        stream << program;
+        auto ast = ASTHelper::build_ast(stream);
+        auto analysis = SemanticAnalysis::analyze(ast.get());
+
+        llvm::LLVMContext serialContext;
+        auto serial = CodeGenerator::generate(ast.get(), analysis.get(), "test", serialContext, 1,
+                                              Optimize);
+
+        for (unsigned jobs : {2, 3, 16}) {
+            llvm::LLVMContext context;
+            auto parallel = CodeGenerator::generate(ast.get(), analysis.get(), "test", context, jobs,
+                                                    Optimize);
+            REQUIRE_FALSE(llvm::verifyModule(*parallel, &llvm::errs()));
+            REQUIRE(DefinedFunctions(*parallel) == DefinedFunctions(*serial));
+
+            // The shared globals are defined exactly once and stay private to the program
+            REQUIRE(parallel->getNamedGlobal("_tip_ftable")->hasInternalLinkage());
+            REQUIRE_FALSE(parallel->getNamedGlobal("_tip_input_array")->isDeclaration());
+            REQUIRE_FALSE(parallel->getNamedGlobal("_tip_num_inputs")->isDeclaration());
+        }
+    }
+}
+
+TEST_CASE("CodeGenerator: Test unchanged function groups are reused from the cache", "[CodeGenerator]") {
+    llvm::SmallString<128> dir;
+    REQUIRE_FALSE(llvm::sys::fs::createUniqueDirectory("tipc", dir));
+
+    // The globals and one partition per function, then one function changes
+    auto program = ChainProgram(10);
+    auto changed = program;
+    changed.replace(changed.find("* 5 +"), 5, "* 50 +");
+    std::vector<std::pair<std::string, unsigned>> runs { {program, 0}, {program, 11}, {changed, 10} };
+
+    for (auto &run : runs) {
+        std::stringstream stream;
+        stream << run.first;
+        auto ast = ASTHelper::build_ast(stream);
+        auto analysis = SemanticAnalysis::analyze(ast.get());
+
+        CodeGenCache cache(dir.str().str(), "O2");
+        llvm::LLVMContext context;
+        auto module = CodeGenerator::generate(ast.get(), analysis.get(), "test", context, 2,
+                                              Optimize, false, &cache);
+        REQUIRE_FALSE(llvm::verifyModule(*module, &llvm::errs()));
+        REQUIRE(cache.getHits() == run.second);
+        REQUIRE(cache.getMisses() == 11 - run.second);
+
+        llvm::LLVMContext serialContext;
+        auto serial = CodeGenerator::generate(ast.get(), analysis.get(), "test", serialContext, 1,
+                                              Optimize);
+        REQUIRE(DefinedFunctions(*module) == DefinedFunctions(*serial));
+        REQUIRE(module->getNamedGlobal("_tip_ftable")->hasInternalLinkage());
+    }
+
+    llvm::sys::fs::remove_directories(dir);
+}
+
+#ifdef TIP_EMBED_RUNTIME
+TEST_CASE("CodeGenerator: Test the runtime library is linked and internalized", "[CodeGenerator]") {
+    std::stringstream stream;
+    stream << programs[3];
+    auto ast = ASTHelper::build_ast(stream);
+    auto analysis = SemanticAnalysis::analyze(ast.get());
+    llvm::LLVMContext context;
+    auto module = CodeGenerator::generate(ast.get(), analysis.get(), "test", context);
+
+    CodeGenerator::linkRuntime(module.get());
+    REQUIRE_FALSE(llvm::verifyModule(*module, &llvm::errs()));
+
+    // Only main is left for the system linker, the runtime is defined in the module
+    for (auto &f : *module) {
+        if (!f.isDeclaration() && !f.hasLocalLinkage()) {
+            REQUIRE(f.getName() == "main");
+        }
+    }
+    REQUIRE_FALSE(module->getFunction("main")->isDeclaration());
+    for (auto name : {"_tip_output", "_tip_error", "_tip_heap_refill"}) {
+        auto f = module->getFunction(name);
+        REQUIRE((f == nullptr || (!f->isDeclaration() && f->hasLocalLinkage())));
+    }
+    REQUIRE(module->getNamedGlobal("_tip_input_array")->hasLocalLinkage());
+}
+#endif
+
+TEST_CASE("CodeGenerator: Test native code is emitted for the host", "[CodeGenerator]") {
+    llvm::SmallString<128> dir;
+    REQUIRE_FALSE(llvm::sys::fs::createUniqueDirectory("tipc", dir));
+    llvm::SmallString<128> source(dir);
+    llvm::sys::path::append(source, "native.tip");
+
+    std::stringstream stream;
+    stream << programs.back();
+    auto ast = ASTHelper::build_ast(stream);
+    auto analysis = SemanticAnalysis::analyze(ast.get());
+    llvm::LLVMContext context;
+    auto module = CodeGenerator::generate(ast.get(), analysis.get(), source.str().str(), context);
+
+    CodeGenerator::emitNative(module.get(), false);
+    CodeGenerator::emitNative(module.get(), true);
+    auto object = source.str().str() + ".o";
+    auto assembly = source.str().str() + ".s";
+
+    llvm::file_magic magic;
+    REQUIRE_FALSE(llvm::identify_magic(object, magic));
+    REQUIRE((magic == llvm::file_magic::elf_relocatable || magic == llvm::file_magic::macho_object));
+
+    std::ifstream text(assembly);
+    std::string line;
+    bool found = false;
+    while (std::getline(text, line)) {
+        found = found || line.find("_tip_main") != std::string::npos;
+    }
+    REQUIRE(found);
+
+    llvm::sys::fs::remove(object);
+    llvm::sys::fs::remove(assembly);
+    llvm::sys::fs::remove(dir);
+}
+
+/*
+ * Serial and parallel generation and optimization of a large program.
+ * Hidden by default, run it with: codegen_unit_tests "[benchmark]"
+ */
+TEST_CASE("CodeGenerator: Benchmark parallel generation", "[.][CodeGenerator][benchmark]") {
+    std::stringstream stream;
+    stream << ChainProgram(2000);
+    auto ast = ASTHelper::build_ast(stream);
+    auto analysis = SemanticAnalysis::analyze(ast.get(), 4);
+
+    for (unsigned jobs : {1, 2, 4, 8}) {
+        BENCHMARK("generate and optimize with " + std::to_string(jobs) + " jobs") {
+            llvm::LLVMContext context;
+            return CodeGenerator::generate(ast.get(), analysis.get(), "test", context, jobs,
+                                           Optimize)->size();
+        };
+    }
+}
@@ -0,0 +1,73 @@
+#include "catch.hpp"
+#include "ASTHelper.h"
+#include "CodeGenerator.h"
+#include "InternalError.h"
+#include "JIT.h"
+#include "Optimizer.h"
+#include "SemanticAnalysis.h"
+
+#include <sstream>
+
+namespace {
+
+std::unique_ptr<JIT> Compile(const std::string &program, bool optimize = false, bool gc = false) {
+    std::stringstream stream;
+    stream << program;
+    auto ast = ASTHelper::build_ast(stream);
+    auto analysis = SemanticAnalysis::analyze(ast.get());
+    auto context = std::make_unique<llvm::LLVMContext>();
+    auto module = CodeGenerator::generate(ast.get(), analysis.get(), "test", *context, gc);
+    if (optimize) {
+        Optimizer::optimize(module.get(), Optimizer::O2);
+    }
+    return std::make_unique<JIT>(std::move(module), std::move(context));
+}
+
+// Call the TIP main function of the program with the given arguments.
+int64_t CallMain(JIT &jit, std::vector<int64_t> args) {
+    auto numInputs = (int64_t *) jit.lookup("_tip_num_inputs");
+    REQUIRE(*numInputs == (int64_t) args.size());
+    auto inputArray = (int64_t *) jit.lookup("_tip_input_array");
+    std::copy(args.begin(), args.end(), inputArray);
+    auto tipMain = (int64_t (*)()) jit.lookup("_tip_main");
+    return tipMain();
+}
+
+const std::string program = R"(
+fib(n) { var r; if (n > 1) { r = fib(n - 1) + fib(n - 2); } else { r = n; } return r; }
+apply(f, x) { return f(x); }
+main(a, b) {
+    var p, q, i, s;
+    p = alloc a;
+    q = {x: b, y: p};
+    i = 0; s = 0;
+    while (b > i) { s = s + *({v: i, w: alloc i}.w); i = i + 1; }
+    return apply(fib, *(q.y)) + q.x + s;
+}
+)";
+
+}
+
+TEST_CASE("JIT: Test programs run in process", "[JIT]") {
+    // fib(10) + 5 + (0 + 1 + 2 + 3 + 4)
+    for (auto optimize : {false, true}) {
+        auto jit = Compile(program, optimize);
+        REQUIRE(CallMain(*jit, {10, 5}) == 70);
+        REQUIRE(CallMain(*jit, {1, 0}) == 1);
+    }
+}
+
+TEST_CASE("JIT: Test garbage collected programs run in process", "[JIT]") {
+    auto jit = Compile(program, true, true);
+    REQUIRE(CallMain(*jit, {10, 5}) == 70);
+}
+
+TEST_CASE("JIT: Test programs are run through the runtime", "[JIT]") {
+    auto jit = Compile("main(a) { return a - 5; }");
+    REQUIRE(jit->run("test", {"5"}) == 0);
+}
+
+TEST_CASE("JIT: Test missing symbols are reported", "[JIT]") {
+    auto jit = Compile("main() { return 0; }");
+    REQUIRE_THROWS_AS(jit->lookup("_tip_nothing"), InternalError);
+}
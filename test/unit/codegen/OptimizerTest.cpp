@@ -0,0 +1,89 @@
+#include "catch.hpp"
+#include "ASTHelper.h"
+#include "CodeGenerator.h"
+#include "InternalError.h"
+#include "Optimizer.h"
+#include "SemanticAnalysis.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <sstream>
+
+namespace {
+
+std::unique_ptr<llvm::Module> Generate(const std::string &program, llvm::LLVMContext &context) {
+    std::stringstream stream;
+    stream << program;
+    auto ast = ASTHelper::build_ast(stream);
+    auto analysis = SemanticAnalysis::analyze(ast.get());
+    return CodeGenerator::generate(ast.get(), analysis.get(), "test", context);
+}
+
+std::string Print(llvm::Module *module) {
+    std::string ir;
+    llvm::raw_string_ostream os(ir);
+    module->print(os, nullptr);
+    return os.str();
+}
+
+const std::string dispatch = R"(
+inc(x) { return x + 1; }
+main() { var f; f = inc; return f(41) + inc(0); }
+)";
+
+const std::string loop = R"(
+main(n) { var i, r; i = 0; r = 0; while (n > i) { r = r + {a: i, b: 2}.b; i = i + 1; } return r; }
+)";
+
+}
+
+TEST_CASE("Optimizer: Test O0 leaves the module unchanged", "[Optimizer]") {
+    llvm::LLVMContext context;
+    auto module = Generate(dispatch, context);
+    auto before = Print(module.get());
+    Optimizer::optimize(module.get(), Optimizer::O0);
+    REQUIRE(Print(module.get()) == before);
+}
+
+TEST_CASE("Optimizer: Test calls through the function table are inlined", "[Optimizer]") {
+    for (auto level : {Optimizer::O2, Optimizer::O3}) {
+        llvm::LLVMContext context;
+        auto module = Generate(dispatch, context);
+        Optimizer::optimize(module.get(), level);
+        REQUIRE_FALSE(llvm::verifyModule(*module, &llvm::errs()));
+
+        auto main = module->getFunction("_tip_main");
+        auto ir = Print(module.get());
+        INFO(ir);
+        for (auto &block : *main) {
+            for (auto &inst : block) {
+                REQUIRE_FALSE(llvm::isa<llvm::CallInst>(inst));
+            }
+        }
+        REQUIRE(ir.find("ret i64 43") != std::string::npos);
+    }
+}
+
+TEST_CASE("Optimizer: Test every level produces a valid module", "[Optimizer]") {
+    for (auto level : {Optimizer::O0, Optimizer::O1, Optimizer::O2, Optimizer::O3, Optimizer::Os}) {
+        for (auto &program : {dispatch, loop}) {
+            llvm::LLVMContext context;
+            auto module = Generate(program, context);
+            Optimizer::optimize(module.get(), level);
+            REQUIRE_FALSE(llvm::verifyModule(*module, &llvm::errs()));
+        }
+    }
+}
+
+TEST_CASE("Optimizer: Test custom pipelines", "[Optimizer]") {
+    REQUIRE(Optimizer::checkPipeline("function(mem2reg,instcombine),globalopt").empty());
+    REQUIRE_FALSE(Optimizer::checkPipeline("function(no-such-pass)").empty());
+
+    llvm::LLVMContext context;
+    auto module = Generate(dispatch, context);
+    REQUIRE(Print(module.get()).find("alloca") != std::string::npos);
+    Optimizer::optimize(module.get(), std::string("function(mem2reg)"));
+    REQUIRE(Print(module.get()).find("alloca") == std::string::npos);
+
+    REQUIRE_THROWS_AS(Optimizer::optimize(module.get(), std::string("no-such-pass")), InternalError);
+}
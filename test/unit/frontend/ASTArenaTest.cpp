@@ -0,0 +1,215 @@
+#include "catch.hpp"
+#include "ASTArena.h"
+#include "ASTHelper.h"
+#include "ASTVisitor.h"
+#include "FrontEnd.h"
+#include "GeneralHelper.h"
+#include "InternalError.h"
+#include "SymbolInterner.h"
+
+#include <chrono>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Collects the names of variable references.
+class VariableCollector : public ASTVisitor {
+public:
+  std::vector<const std::string*> names;
+  void endVisit(ASTVariableExpr *element) override { names.push_back(&element->getName()); }
+};
+
+// Counts the nodes of an AST.
+class NodeCounter : public ASTVisitor {
+public:
+  long count = 0;
+  bool visit(ASTFunction *element) override { count++; return true; }
+  bool visit(ASTNumberExpr *element) override { count++; return true; }
+  bool visit(ASTVariableExpr *element) override { count++; return true; }
+  bool visit(ASTBinaryExpr *element) override { count++; return true; }
+  bool visit(ASTInputExpr *element) override { count++; return true; }
+  bool visit(ASTFunAppExpr *element) override { count++; return true; }
+  bool visit(ASTAllocExpr *element) override { count++; return true; }
+  bool visit(ASTRefExpr *element) override { count++; return true; }
+  bool visit(ASTDeRefExpr *element) override { count++; return true; }
+  bool visit(ASTNullExpr *element) override { count++; return true; }
+  bool visit(ASTFieldExpr *element) override { count++; return true; }
+  bool visit(ASTRecordExpr *element) override { count++; return true; }
+  bool visit(ASTAccessExpr *element) override { count++; return true; }
+  bool visit(ASTDeclNode *element) override { count++; return true; }
+  bool visit(ASTDeclStmt *element) override { count++; return true; }
+  bool visit(ASTAssignStmt *element) override { count++; return true; }
+  bool visit(ASTWhileStmt *element) override { count++; return true; }
+  bool visit(ASTIfStmt *element) override { count++; return true; }
+  bool visit(ASTOutputStmt *element) override { count++; return true; }
+  bool visit(ASTReturnStmt *element) override { count++; return true; }
+  bool visit(ASTErrorStmt *element) override { count++; return true; }
+  bool visit(ASTBlockStmt *element) override { count++; return true; }
+};
+
+// Counts the cache misses of this thread where the kernel exposes them.
+class CacheMissCounter {
+  int fd = -1;
+
+public:
+  CacheMissCounter() {
+#ifdef __linux__
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+  }
+
+  ~CacheMissCounter() {
+#ifdef __linux__
+    if (fd >= 0) {
+      close(fd);
+    }
+#endif
+  }
+
+  bool available() const { return fd >= 0; }
+
+  void start() {
+#ifdef __linux__
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+  }
+
+  long long stop() {
+    long long count = 0;
+#ifdef __linux__
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fd, &count, sizeof(count)) != sizeof(count)) {
+      count = 0;
+    }
+#endif
+    return count;
+  }
+};
+
+}
+
+TEST_CASE("ASTArena: Test names are interned", "[ASTArena]") {
+    ASTArena arena;
+    auto x = arena.intern("x");
+    REQUIRE(*x == "x");
+    REQUIRE(arena.intern(std::string("x")) == x);
+    REQUIRE(arena.intern("y") != x);
+}
+
+TEST_CASE("ASTArena: Test names are shared by arenas", "[ASTArena]") {
+    auto symbols = std::make_shared<SymbolInterner>();
+    ASTArena first(symbols);
+    ASTArena second(symbols);
+    auto x = first.intern("x");
+    REQUIRE(second.intern("x") == x);
+    REQUIRE(symbols->intern("x") == x);
+    REQUIRE(symbols->find("x") == x);
+    REQUIRE(symbols->find("never interned anywhere") == nullptr);
+
+    ASTArena other;
+    REQUIRE(other.intern("x") != x);
+    REQUIRE_THROWS_AS(first.adopt(std::make_unique<ASTArena>()), InternalError);
+}
+
+TEST_CASE("ASTArena: Test names are released with the program", "[ASTArena]") {
+    auto ast = FrontEnd::parse({{"a.tip", "f(x) { return x; }"}, {"b.tip", "main() { return f(1); }"}});
+    std::weak_ptr<SymbolInterner> symbols = ast->getArena().getSymbols();
+    REQUIRE(symbols.lock()->find("f") == ast->getFunctions()[0]->getDecl()->getSymbol());
+    ast.reset();
+    REQUIRE(symbols.expired());
+}
+
+TEST_CASE("ASTArena: Test lists of children are copied", "[ASTArena]") {
+    ASTArena arena;
+    std::vector<ASTExpr*> actuals {arena.make<ASTNumberExpr>(1), arena.make<ASTNullExpr>()};
+    auto call = arena.make<ASTFunAppExpr>(arena.make<ASTVariableExpr>(arena.intern("f")), arena.copy(actuals));
+    actuals.clear();
+
+    std::stringstream stream;
+    stream << *call;
+    REQUIRE(stream.str() == "f(1, null)");
+    REQUIRE(call->getActuals().size() == 2);
+    REQUIRE(arena.copy(std::vector<ASTExpr*>()).empty());
+}
+
+TEST_CASE("ASTArena: Test nodes of a program share their names", "[ASTArena]") {
+    std::stringstream stream;
+    stream << R"(
+      f(x) { var y; y = x; return x + y; }
+      main() { var x; x = f(1); return x; }
+    )";
+    auto ast = ASTHelper::build_ast(stream);
+    REQUIRE(ast->getArena().getBytesAllocated() > 0);
+
+    VariableCollector collector;
+    ast->accept(&collector);
+    std::vector<std::string> names;
+    for (auto name : collector.names) {
+        names.push_back(*name);
+    }
+    REQUIRE(names == std::vector<std::string> {"y", "x", "x", "y", "x", "f", "x"});
+
+    // every x is the same string, whichever function it is in
+    REQUIRE(collector.names[1] == collector.names[2]);
+    REQUIRE(collector.names[2] == collector.names[6]);
+    REQUIRE(collector.names[0] == collector.names[3]);
+}
+
+/*
+ * Memory per node, time to traverse the tree and the cache misses while
+ * doing so, and time to free the tree.  Cache misses are only counted where
+ * the kernel exposes hardware counters.  Hidden by default, run it with:
+ * frontend_unit_tests "[benchmark]"
+ */
+TEST_CASE("ASTArena: Benchmark node memory and traversal", "[.][ASTArena][benchmark]") {
+    for (int lines : {10000, 100000, 1000000}) {
+        auto ast = FrontEnd::parse(GeneralHelper::generateProgram(lines), FrontEnd::DESCENT);
+        NodeCounter nodes;
+        ast->accept(&nodes);
+
+        CacheMissCounter misses;
+        const int traversals = 20;
+        long long missCount = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < traversals; i++) {
+            NodeCounter counter;
+            if (misses.available()) {
+                misses.start();
+            }
+            ast->accept(&counter);
+            if (misses.available()) {
+                missCount += misses.stop();
+            }
+        }
+        std::chrono::duration<double, std::milli> traversal = std::chrono::steady_clock::now() - start;
+
+        double bytes = ast->getArena().getBytesAllocated();
+        start = std::chrono::steady_clock::now();
+        ast.reset();
+        std::chrono::duration<double, std::milli> free = std::chrono::steady_clock::now() - start;
+
+        std::stringstream cache;
+        if (misses.available()) {
+            cache << missCount / traversals << " cache misses";
+        } else {
+            cache << "cache misses not available";
+        }
+        WARN(lines << " lines: " << nodes.count << " nodes, " << bytes / nodes.count << " bytes/node, traversal "
+             << traversal.count() / traversals << " ms, " << cache.str() << ", free " << free.count() << " ms");
+    }
+}
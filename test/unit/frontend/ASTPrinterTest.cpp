@@ -193,12 +193,13 @@ TEST_CASE("ASTPrinterTest: condiional expression printers", "[ASTNodePrint]") {
 }
 
 TEST_CASE("ASTPrinterTest: local expr test", "[ASTNodePrint]") {
-    // Constructor expects unique pointers so we must create them
-    auto zero = std::make_unique<ASTNumberExpr>(0); 
-    auto var = std::make_unique<ASTVariableExpr>("y"); 
+    // Children and names are allocated in an arena that outlives the nodes
+    ASTArena arena;
+    auto zero = arena.make<ASTNumberExpr>(0); 
+    auto var = arena.make<ASTVariableExpr>(arena.intern("y")); 
 
     // Here we just use the default constructor
-    ASTBinaryExpr ypluszero("+", std::move(var), std::move(zero)); 
+    ASTBinaryExpr ypluszero(ASTBinaryExpr::ADD, var, zero); 
 
     std::stringstream  stream;
     stream << ypluszero;
@@ -207,15 +208,16 @@ TEST_CASE("ASTPrinterTest: local expr test", "[ASTNodePrint]") {
     REQUIRE(actual == "(y+0)");
 }
 
-TEST_CASE("ASTPrinterTest: local unique expr test", "[ASTNodePrint]") {
-    auto zero = std::make_unique<ASTNumberExpr>(0); 
-    auto var = std::make_unique<ASTVariableExpr>("y"); 
+TEST_CASE("ASTPrinterTest: local arena expr test", "[ASTNodePrint]") {
+    ASTArena arena;
+    auto zero = arena.make<ASTNumberExpr>(0); 
+    auto var = arena.make<ASTVariableExpr>(arena.intern("y")); 
 
-    // Here we create a unique pointer to the binary expr
-    auto ypluszero = std::make_unique<ASTBinaryExpr>("+", std::move(var), std::move(zero)); 
+    // Here we allocate the binary expr in the arena as well
+    auto ypluszero = arena.make<ASTBinaryExpr>(ASTBinaryExpr::ADD, var, zero); 
 
     std::stringstream  stream;
-    stream << *ypluszero; // dereference is an operation for unique pointers
+    stream << *ypluszero; // the arena hands out plain pointers
     auto actual = stream.str();
 
     REQUIRE(actual == "(y+0)");
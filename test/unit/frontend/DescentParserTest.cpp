@@ -0,0 +1,177 @@
+#include "catch.hpp"
+#include "ASTVisitor.h"
+#include "DescentParser.h"
+#include "FrontEnd.h"
+#include "GeneralHelper.h"
+#include "ParseError.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <sys/resource.h>
+
+namespace {
+
+// Prints the source location of every node of an AST.
+class LocationPrinter : public ASTVisitor {
+  std::ostream &out;
+
+  void print(ASTNode *element) { out << element->getLine() << ":" << element->getColumn() << " "; }
+
+public:
+  explicit LocationPrinter(std::ostream &out) : out(out) {}
+
+  void endVisit(ASTFunction *element) override { print(element); }
+  void endVisit(ASTNumberExpr *element) override { print(element); }
+  void endVisit(ASTVariableExpr *element) override { print(element); }
+  void endVisit(ASTBinaryExpr *element) override { print(element); }
+  void endVisit(ASTInputExpr *element) override { print(element); }
+  void endVisit(ASTFunAppExpr *element) override { print(element); }
+  void endVisit(ASTAllocExpr *element) override { print(element); }
+  void endVisit(ASTRefExpr *element) override { print(element); }
+  void endVisit(ASTDeRefExpr *element) override { print(element); }
+  void endVisit(ASTNullExpr *element) override { print(element); }
+  void endVisit(ASTFieldExpr *element) override { print(element); }
+  void endVisit(ASTRecordExpr *element) override { print(element); }
+  void endVisit(ASTAccessExpr *element) override { print(element); }
+  void endVisit(ASTDeclNode *element) override { print(element); }
+  void endVisit(ASTDeclStmt *element) override { print(element); }
+  void endVisit(ASTAssignStmt *element) override { print(element); }
+  void endVisit(ASTWhileStmt *element) override { print(element); }
+  void endVisit(ASTIfStmt *element) override { print(element); }
+  void endVisit(ASTOutputStmt *element) override { print(element); }
+  void endVisit(ASTReturnStmt *element) override { print(element); }
+  void endVisit(ASTErrorStmt *element) override { print(element); }
+  void endVisit(ASTBlockStmt *element) override { print(element); }
+};
+
+/*
+ * The printed AST and the locations of its nodes, or the location of the
+ * parse error for a program that does not parse.
+ */
+std::string Parse(const std::string &program, FrontEnd::ParserKind parser) {
+    std::stringstream printed;
+    try {
+        auto ast = FrontEnd::parse(program, parser);
+        FrontEnd::prettyprint(ast.get(), printed);
+        LocationPrinter locations(printed);
+        ast->accept(&locations);
+    } catch (ParseError &e) {
+        std::string what = e.what();
+        printed << "error" << what.substr(what.rfind('@'));
+    }
+    return printed.str();
+}
+
+// The TIP programs of the system tests.
+std::vector<std::string> SystemTestPrograms() {
+    std::vector<std::string> files;
+    for (auto directory : {"/selftests", "/iotests"}) {
+        std::error_code ec;
+        for (llvm::sys::fs::directory_iterator file(std::string(TIP_SYSTEM_TESTS) + directory, ec), end;
+             file != end && !ec; file.increment(ec)) {
+            if (llvm::StringRef(file->path()).endswith(".tip")) {
+                files.push_back(file->path());
+            }
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+// The peak resident memory of the process in kilobytes.
+long PeakMemory() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+}
+
+TEST_CASE("DescentParser: Test system test programs parse as with ANTLR", "[DescentParser]") {
+    auto files = SystemTestPrograms();
+    REQUIRE_FALSE(files.empty());
+    for (auto &file : files) {
+        auto buffer = llvm::MemoryBuffer::getFile(file);
+        REQUIRE(buffer);
+        std::string program = (*buffer)->getBuffer().str();
+        INFO(file);
+        REQUIRE(Parse(program, FrontEnd::DESCENT) == Parse(program, FrontEnd::ANTLR));
+    }
+}
+
+TEST_CASE("DescentParser: Test precedence and locations match ANTLR", "[DescentParser]") {
+    std::vector<std::string> programs {
+        "main() { var x; x = alloc 1 + 2 * 3 == 4 > 5; return *x; }",
+        "main() { var x; x = *x.f(1).g + &x(2) * -3 - -4 - 5 / 6 / 7; return x; }",
+        "main() { var x; x = ((x)).f((1), (x)(2)); (*x).g = {}.h; return (1 + 2) * (3); }",
+        "main() { {a: 1}.a = 2; {} = 3; {} x = 4; {}.b = 5; {} *x = 6; return 0; }",
+        "main() { if (1) if (2) output 3; else error 4; while (input) {} return null; }",
+        "f(a,b){var c;var d,e;{{}}return a;}\n\tg ( ) { return f ( 1 , 2 ) ; } // done",
+        "main() { /* / * ** */ return 1 ; } } ignored",
+        "main() { return 1 / 2; } /* not a comment",
+    };
+    for (auto &program : programs) {
+        INFO(program);
+        REQUIRE(Parse(program, FrontEnd::DESCENT) == Parse(program, FrontEnd::ANTLR));
+    }
+}
+
+TEST_CASE("DescentParser: Test errors are reported where ANTLR reports them", "[DescentParser]") {
+    std::vector<std::string> programs {
+        "",
+        "main() { var x;\n  x = 1\n  return x;\n}",
+        "main( { return 0; }",
+        "main(a b) { return 0; }",
+        "main() { var x y; return 0; }",
+        "main() { x y = 1; return 0; }",
+        "main() { x = 1 + ; return 0; }",
+        "main() { x = - y; return 0; }",
+        "main() { x = {a 1}; return 0; }",
+        "main() { var x; output x; var y; return 0; }",
+        "main() { return 0; }\nf() { return 1 }",
+        "main() { return 0 # 1; }",
+        "main() { return !1; }",
+        "main() { if (x) { return 0; } }",
+        "main() { return 0;",
+    };
+    for (auto &program : programs) {
+        INFO(program);
+        auto result = Parse(program, FrontEnd::DESCENT);
+        REQUIRE(result.rfind("error@", 0) == 0);
+        REQUIRE(result == Parse(program, FrontEnd::ANTLR));
+    }
+
+    std::vector<std::pair<std::string, std::string>> messages {
+        {"main() { return 0 # 1; }", "token recognition error at: '#'@1:18"},
+        {"main() { return !\n1; }", "token recognition error at: '!\\n'@1:16"},
+        {"main() { var x;\n  x = 1\n  return x;\n}", "mismatched input 'return' expecting ';'@3:2"},
+        {"main() { return 0;", "mismatched input '<EOF>' expecting '}'@1:18"},
+    };
+    for (auto &message : messages) {
+        REQUIRE_THROWS_WITH(DescentParser::parse(message.first), message.second);
+    }
+}
+
+/*
+ * Throughput in lines per second and growth of the peak resident memory
+ * while parsing with either parser, the hand written one first since the
+ * peak only grows.  Hidden by default, run it with: frontend_unit_tests "[benchmark]"
+ */
+TEST_CASE("DescentParser: Benchmark against ANTLR", "[.][DescentParser][benchmark]") {
+    FrontEnd::prewarm();
+    for (int lines : {1000, 10000, 100000, 1000000}) {
+        auto program = GeneralHelper::generateProgram(lines);
+        for (auto parser : {FrontEnd::DESCENT, FrontEnd::ANTLR}) {
+            auto before = PeakMemory();
+            auto start = std::chrono::steady_clock::now();
+            auto ast = FrontEnd::parse(program, parser);
+            std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+            WARN((parser == FrontEnd::DESCENT ? "descent: " : "antlr: ") << lines << " lines at "
+                 << static_cast<long>(lines / seconds.count()) << " lines/s, peak memory grew by "
+                 << PeakMemory() - before << " KB");
+        }
+    }
+}
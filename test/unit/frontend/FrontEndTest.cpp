@@ -0,0 +1,206 @@
+#include "catch.hpp"
+#include "ASTHelper.h"
+#include "ExceptionContainsWhat.h"
+#include "FrontEnd.h"
+#include "GeneralHelper.h"
+#include "MappedFile.h"
+#include "ParseError.h"
+#include "SourceStream.h"
+#include "TIPLexer.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <sys/resource.h>
+#include <thread>
+
+namespace {
+
+// The printed AST of a program parsed by the front end.
+std::string ParseAndPrint(const std::string &program) {
+    std::stringstream stream(program);
+    auto ast = FrontEnd::parse(stream);
+    std::stringstream printed;
+    FrontEnd::prettyprint(ast.get(), printed);
+    return printed.str();
+}
+
+// The printed AST of a program parsed in ANTLR's default LL mode.
+std::string ParseLLAndPrint(const std::string &program) {
+    std::stringstream stream(program);
+    auto ast = ASTHelper::build_ast(stream);
+    std::stringstream printed;
+    FrontEnd::prettyprint(ast.get(), printed);
+    return printed.str();
+}
+
+// The peak resident memory of the process in kilobytes.
+long PeakMemory() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// The number of tokens in the input.
+int Lex(antlr4::CharStream &input) {
+    TIPLexer lexer(&input);
+    int count = 0;
+    while (lexer.nextToken()->getType() != antlr4::Token::EOF) {
+        count++;
+    }
+    return count;
+}
+
+}
+
+TEST_CASE("FrontEnd: Test two stage parsing builds the LL parse", "[FrontEnd]") {
+    std::vector<std::string> programs {
+        GeneralHelper::generateProgram(50),
+        R"(main() { var x; x = {a: 1, b: {c: &x}}; *((x.b).c) = input; return x.a; })",
+        R"(f(g) { return g(1)(2)(3); } main() { output -1 != 2 == 3 > 4; error null; return f(f); })",
+    };
+    for (auto &program : programs) {
+        REQUIRE(ParseAndPrint(program) == ParseLLAndPrint(program));
+    }
+}
+
+TEST_CASE("FrontEnd: Test text and streams parse alike", "[FrontEnd]") {
+    auto program = GeneralHelper::generateProgram(30);
+    std::stringstream stream(program);
+    auto fromStream = FrontEnd::parse(stream);
+    std::stringstream printed;
+    FrontEnd::prettyprint(fromStream.get(), printed);
+    REQUIRE(ParseAndPrint(program) == printed.str());
+}
+
+TEST_CASE("FrontEnd: Test syntax errors are reported from the LL stage", "[FrontEnd]") {
+    std::stringstream stream;
+    stream << "main() {\n  var x;\n  x = 1\n  return x;\n}\n";
+    REQUIRE_THROWS_MATCHES(FrontEnd::parse(stream), ParseError, ContainsWhat("@4:2"));
+
+    std::stringstream lexical;
+    lexical << "main() { return 1 # 2; }";
+    REQUIRE_THROWS_AS(FrontEnd::parse(lexical), ParseError);
+}
+
+TEST_CASE("FrontEnd: Test prewarming leaves parsing unchanged", "[FrontEnd]") {
+    auto program = GeneralHelper::generateProgram(20);
+    auto cold = ParseAndPrint(program);
+    FrontEnd::prewarm();
+    REQUIRE(ParseAndPrint(program) == cold);
+}
+
+TEST_CASE("FrontEnd: Test source files are joined into one program", "[FrontEnd]") {
+    std::string first = "f(x) { return x + 1; }\ng(y) { return f(y); }\n";
+    std::string second = "main() { return g(2); }\n";
+    for (auto parser : {FrontEnd::ANTLR, FrontEnd::DESCENT}) {
+        auto ast = FrontEnd::parse({{"first.tip", first}, {"second.tip", second}}, parser, 2);
+        std::stringstream printed;
+        FrontEnd::prettyprint(ast.get(), printed);
+        REQUIRE(printed.str() == ParseAndPrint(first + second));
+
+        std::vector<std::string> files;
+        for (auto fn : ast->getFunctions()) {
+            files.push_back(*fn->getSourceFile());
+        }
+        REQUIRE(files == std::vector<std::string> {"first.tip", "first.tip", "second.tip"});
+        REQUIRE(ast->findFunctionByName("main") != nullptr);
+    }
+}
+
+TEST_CASE("FrontEnd: Test errors name the first source file with errors", "[FrontEnd]") {
+    std::vector<FrontEnd::Source> sources {
+        {"good.tip", "main() { return 0; }"},
+        {"bad.tip", "f() {\n  return 1\n}"},
+        {"worse.tip", "g() { return 1 # 2; }"},
+    };
+    for (unsigned jobs : {1u, 3u}) {
+        REQUIRE_THROWS_MATCHES(FrontEnd::parse(sources, FrontEnd::ANTLR, jobs), ParseError,
+                               ContainsWhat("bad.tip: ") && ContainsWhat("@3:0"));
+    }
+}
+
+/*
+ * Parser throughput in lines per second for two stage and LL only parsing.
+ * Hidden by default, run it with: frontend_unit_tests "[benchmark]"
+ */
+TEST_CASE("FrontEnd: Benchmark parser throughput", "[.][FrontEnd][benchmark]") {
+    FrontEnd::prewarm();
+    for (int lines : {1000, 10000, 100000, 1000000}) {
+        auto program = GeneralHelper::generateProgram(lines);
+        for (bool twoStage : {true, false}) {
+            std::stringstream stream(program);
+            auto start = std::chrono::steady_clock::now();
+            auto ast = twoStage ? FrontEnd::parse(stream) : ASTHelper::build_ast(stream);
+            std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+            WARN((twoStage ? "SLL then LL: " : "LL only: ") << lines << " lines at "
+                 << static_cast<long>(lines / seconds.count()) << " lines/s");
+        }
+    }
+}
+
+/*
+ * Time to parse a program split over many files on one thread and on all
+ * of them.  Hidden by default, run it with: frontend_unit_tests "[benchmark]"
+ */
+TEST_CASE("FrontEnd: Benchmark parallel parsing of source files", "[.][FrontEnd][benchmark]") {
+    FrontEnd::prewarm();
+    // Functions defined in several files are only an error to the symbol table
+    auto text = GeneralHelper::generateProgram(50000);
+    std::vector<FrontEnd::Source> sources;
+    for (int i = 0; i < 16; i++) {
+        sources.push_back({"file" + std::to_string(i) + ".tip", text});
+    }
+
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    for (auto parser : {FrontEnd::ANTLR, FrontEnd::DESCENT}) {
+        for (unsigned jobs : {1u, threads}) {
+            auto start = std::chrono::steady_clock::now();
+            auto ast = FrontEnd::parse(sources, parser, jobs);
+            std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+            WARN((parser == FrontEnd::ANTLR ? "antlr: " : "descent: ") << sources.size() << " files of 50000 lines on "
+                 << jobs << " threads in " << time.count() << " ms");
+        }
+    }
+}
+
+/*
+ * Lexing time and growth of the peak resident memory for a source of many
+ * megabytes, read through ANTLRInputStream and mapped through SourceStream.
+ * The peak only grows, so the mapped source, which should need less, is
+ * lexed first.  Hidden by default, run it with: frontend_unit_tests "[benchmark]"
+ */
+TEST_CASE("FrontEnd: Benchmark source ingestion", "[.][FrontEnd][benchmark]") {
+    llvm::SmallString<128> path;
+    int fd;
+    REQUIRE_FALSE(llvm::sys::fs::createTemporaryFile("tipc", "tip", fd, path));
+    size_t size;
+    {
+        auto program = GeneralHelper::generateProgram(300000);
+        size = program.size();
+        llvm::raw_fd_ostream os(fd, true);
+        os << program;
+    }
+
+    for (bool mapped : {true, false}) {
+        auto before = PeakMemory();
+        auto start = std::chrono::steady_clock::now();
+        int tokens;
+        if (mapped) {
+            MappedFile file(path.str().str());
+            SourceStream input(file.getContents());
+            tokens = Lex(input);
+        } else {
+            std::ifstream stream(path.str().str());
+            antlr4::ANTLRInputStream input(stream);
+            tokens = Lex(input);
+        }
+        std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+        WARN((mapped ? "SourceStream: " : "ANTLRInputStream: ") << tokens << " tokens of "
+             << size / 1024 << " KB in " << seconds.count()
+             << " s, peak memory grew by " << PeakMemory() - before << " KB");
+    }
+    llvm::sys::fs::remove(path);
+}
@@ -0,0 +1,84 @@
+#include "catch.hpp"
+#include "MappedFile.h"
+#include "SourceStream.h"
+#include "TIPLexer.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <sstream>
+
+namespace {
+
+// The text and type of every token of a source.
+std::vector<std::pair<std::string, size_t>> Tokens(antlr4::CharStream &input) {
+    TIPLexer lexer(&input);
+    std::vector<std::pair<std::string, size_t>> tokens;
+    for (auto token = lexer.nextToken(); token->getType() != antlr4::Token::EOF; token = lexer.nextToken()) {
+        tokens.emplace_back(token->getText(), token->getType());
+    }
+    return tokens;
+}
+
+// A temporary file holding the text, removed when the test ends.
+struct TemporaryFile {
+    llvm::SmallString<128> path;
+
+    explicit TemporaryFile(const std::string &text) {
+        int fd;
+        REQUIRE_FALSE(llvm::sys::fs::createTemporaryFile("tipc", "tip", fd, path));
+        llvm::raw_fd_ostream os(fd, true);
+        os << text;
+    }
+    ~TemporaryFile() { llvm::sys::fs::remove(path); }
+};
+
+}
+
+TEST_CASE("SourceStream: Test lexing matches ANTLRInputStream", "[SourceStream]") {
+    std::string program = "main() { var x; /* \xc3\xa9t\xc3\xa9 */ x = {f: -12}; return x.f >= 3; } // end";
+
+    SourceStream source(program);
+    antlr4::ANTLRInputStream decoded(program);
+    REQUIRE(Tokens(source) == Tokens(decoded));
+}
+
+TEST_CASE("SourceStream: Test look ahead, seek and text", "[SourceStream]") {
+    SourceStream source("ab\xff", "name");
+    REQUIRE(source.size() == 3);
+    REQUIRE(source.getSourceName() == "name");
+    REQUIRE(source.LA(-1) == antlr4::IntStream::EOF);
+    REQUIRE(source.LA(1) == 'a');
+    REQUIRE(source.LA(3) == 0xff);
+    REQUIRE(source.LA(4) == antlr4::IntStream::EOF);
+
+    source.consume();
+    REQUIRE(source.index() == 1);
+    REQUIRE(source.LA(-1) == 'a');
+    REQUIRE(source.LA(1) == 'b');
+
+    source.seek(10);
+    REQUIRE(source.index() == 3);
+    REQUIRE(source.LA(1) == antlr4::IntStream::EOF);
+    REQUIRE_THROWS(source.consume());
+
+    REQUIRE(source.getText(antlr4::misc::Interval(0, 1)) == "ab");
+    REQUIRE(source.getText(antlr4::misc::Interval(1, 20)) == "b\xff");
+    REQUIRE(source.getText(antlr4::misc::Interval(2, 1)) == "");
+    REQUIRE(source.toString() == "ab\xff");
+}
+
+TEST_CASE("MappedFile: Test contents of mapped files", "[MappedFile]") {
+    std::string program = "main() { return 42; }\n";
+    TemporaryFile file(program);
+    MappedFile mapped(file.path.str().str());
+    REQUIRE(mapped.good());
+    REQUIRE(mapped.getContents() == program);
+
+    TemporaryFile empty("");
+    MappedFile mappedEmpty(empty.path.str().str());
+    REQUIRE(mappedEmpty.good());
+    REQUIRE(mappedEmpty.getContents().empty());
+
+    MappedFile missing(std::string(file.path.str()) + ".missing");
+    REQUIRE_FALSE(missing.good());
+}
@@ -1,4 +1,5 @@
 #include "GeneralHelper.h"
+#include <sstream>
 
 std::vector<std::string> GeneralHelper::tokenize(std::string str, char delim) {
   std::vector<std::string> tokens;
@@ -12,3 +13,21 @@ std::vector<std::string> GeneralHelper::tokenize(std::string str, char delim) {
   tokens.push_back(str.substr(startIndex));
   return tokens;
 }
+
+std::string GeneralHelper::generateProgram(int lines) {
+  std::stringstream program;
+  for (int i = 0; i < lines / 10; i++) {
+    program << "f" << i << "(a, b) {\n"
+            << "  var x, y;\n"
+            << "  x = alloc {p: a, q: b};\n"
+            << "  y = 0;\n"
+            << "  while (a > y) {\n"
+            << "    if (a == b) { output (*x).p * 2; } else { y = y + f" << i << "(b - 1, a)(-1); }\n"
+            << "    y = y + 1;\n"
+            << "  }\n"
+            << "  return y;\n"
+            << "}\n";
+  }
+  program << "main() { return f0(1, 2); }\n";
+  return program.str();
+}
@@ -9,6 +9,12 @@
 class GeneralHelper {
 public:
   static std::vector<std::string> tokenize(std::string str, char delim);
+
+  /**
+   * A program of about the given number of lines, ten per function, used
+   * by the benchmarks.
+   */
+  static std::string generateProgram(int lines);
 };
 
 
@@ -5,12 +5,25 @@
 #include "ExceptionContainsWhat.h"
 
 #include "ASTHelper.h"
+#include "ASTVisitor.h"
+#include "FrontEnd.h"
 #include "SymbolTable.h"
 #include "SemanticError.h"
 
 #include <iostream>
 #include <optional>
 
+namespace {
+
+// Collects the variable references of a program.
+class VariableCollector : public ASTVisitor {
+public:
+  std::vector<ASTVariableExpr*> variables;
+  void endVisit(ASTVariableExpr *element) override { variables.push_back(element); }
+};
+
+}
+
 TEST_CASE("Symbol Table: locals", "[SymbolTable]") {
     std::stringstream stream;
     stream << R"(short() { var x, y, z; output x+y; return z; })";
@@ -178,4 +191,52 @@ TEST_CASE("Symbol Table: functions clash ", "[SymbolTable]") {
     REQUIRE_THROWS_MATCHES(SymbolTable::build(ast.get()),
                            SemanticError,
                            ContainsWhat("foo already declared"));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Symbol Table: functions clash across files", "[SymbolTable]") {
+    auto ast = FrontEnd::parse({{"a.tip", "foo() { return 0; }"},
+                                {"b.tip", "bar() { return 1; }\n\nfoo() { return 2; }"}});
+
+    REQUIRE_THROWS_MATCHES(SymbolTable::build(ast.get()),
+                           SemanticError,
+                           ContainsWhat("line 3 of b.tip: function name foo already declared on line 1 of a.tip"));
+}
+TEST_CASE("Symbol Table: references are bound", "[SymbolTable]") {
+    std::stringstream stream;
+    stream << R"(
+      foo(a) { var x; x = a; return x; }
+      bar() { var y; y = foo; return y(1); }
+    )";
+
+    auto ast = ASTHelper::build_ast(stream);
+
+    std::unique_ptr<SymbolTable> symbols;
+    REQUIRE_NOTHROW(symbols = SymbolTable::build(ast.get()));
+
+    VariableCollector collector;
+    ast->accept(&collector);
+    auto &vars = collector.variables;
+    REQUIRE(vars.size() == 6);
+
+    // x = a; return x;
+    auto foo = symbols->getFunction("foo");
+    REQUIRE(vars[0]->getDecl() == symbols->getLocal("x", foo));
+    REQUIRE(vars[0]->getSlot() == 1);
+    REQUIRE(vars[1]->getDecl() == symbols->getLocal("a", foo));
+    REQUIRE(vars[1]->getSlot() == 0);
+    REQUIRE_FALSE(vars[1]->isFunction());
+    REQUIRE(vars[2]->getDecl() == vars[0]->getDecl());
+
+    // y = foo; return y(1);
+    auto bar = symbols->getFunction("bar");
+    REQUIRE(vars[3]->getDecl() == symbols->getLocal("y", bar));
+    REQUIRE(vars[3]->getSlot() == 0);
+    REQUIRE(vars[4]->getDecl() == foo);
+    REQUIRE(vars[4]->isFunction());
+    REQUIRE(vars[4]->getSlot() == 0);
+    REQUIRE(vars[5]->getDecl() == vars[3]->getDecl());
+    REQUIRE_FALSE(vars[5]->isFunction());
+
+    REQUIRE(symbols->getLocal("y", foo) == nullptr);
+    REQUIRE(symbols->getFunction("baz") == nullptr);
+}
@@ -0,0 +1,139 @@
+#include "catch.hpp"
+#include "ASTHelper.h"
+#include "ASTVisitor.h"
+#include "SemanticAnalysis.h"
+#include "RecordLayouts.h"
+#include <sstream>
+#include <vector>
+
+namespace {
+
+// Collects the record and access expressions of a program in visit order.
+class RecordSites : public ASTVisitor {
+public:
+    std::vector<ASTExpr*> sites;
+    void endVisit(ASTRecordExpr * element) override { sites.push_back(element); }
+    void endVisit(ASTAccessExpr * element) override { sites.push_back(element); }
+};
+
+struct Analyzed {
+    std::unique_ptr<ASTProgram> ast;
+    std::unique_ptr<SemanticAnalysis> analysis;
+    std::vector<ASTExpr*> sites;
+};
+
+Analyzed Analyze(const std::string &program) {
+    std::stringstream stream;
+    stream << program;
+    Analyzed result;
+    result.ast = ASTHelper::build_ast(stream);
+    result.analysis = SemanticAnalysis::analyze(result.ast.get());
+    RecordSites visitor;
+    result.ast->accept(&visitor);
+    result.sites = visitor.sites;
+    return result;
+}
+
+RecordLayouts::Layout LayoutOf(Analyzed &a, int site) {
+    auto layouts = a.analysis->getRecordLayouts();
+    return layouts->getLayouts().at(layouts->getLayout(a.sites.at(site)));
+}
+
+}
+
+TEST_CASE("RecordLayouts: Test unrelated records get their own layouts", "[RecordLayouts]") {
+    auto a = Analyze(R"(
+      main() {
+        var x, y;
+        x = {a: 1, b: 2};
+        y = {c: 3, d: 4, e: 5};
+        return x.b + y.e;
+      }
+    )");
+    REQUIRE_FALSE(a.analysis->getRecordLayouts()->isWide());
+    REQUIRE(a.analysis->getRecordLayouts()->getLayouts().size() == 2);
+
+    REQUIRE(LayoutOf(a, 0) == RecordLayouts::Layout{"a", "b"});
+    REQUIRE(LayoutOf(a, 1) == RecordLayouts::Layout{"c", "d", "e"});
+    REQUIRE(LayoutOf(a, 2) == LayoutOf(a, 0));
+    REQUIRE(LayoutOf(a, 3) == LayoutOf(a, 1));
+}
+
+TEST_CASE("RecordLayouts: Test records reaching the same access share a layout", "[RecordLayouts]") {
+    auto a = Analyze(R"(
+      get(r) { return r.c; }
+      main() {
+        var x;
+        x = {a: 1};
+        if (input > 0) { x = {b: 2}; }
+        return get(x) + {d: 4}.d;
+      }
+    )");
+    auto layouts = a.analysis->getRecordLayouts();
+    REQUIRE_FALSE(layouts->isWide());
+
+    // The absent field c is given a slot so reading it stays in bounds
+    REQUIRE(LayoutOf(a, 0) == RecordLayouts::Layout{"c", "a", "b"});
+    REQUIRE(layouts->getLayout(a.sites[0]) == layouts->getLayout(a.sites[1]));
+    REQUIRE(layouts->getLayout(a.sites[1]) == layouts->getLayout(a.sites[2]));
+    REQUIRE(LayoutOf(a, 3) == RecordLayouts::Layout{"d"});
+}
+
+TEST_CASE("RecordLayouts: Test recursive records", "[RecordLayouts]") {
+    auto a = Analyze(R"(
+      main() {
+        var n, m;
+        n = {v: 1, next: null};
+        m = {v: 2, next: &n};
+        n = m;
+        return (*(m.next)).v;
+      }
+    )");
+    auto layouts = a.analysis->getRecordLayouts();
+    REQUIRE_FALSE(layouts->isWide());
+    REQUIRE(layouts->getLayouts().size() == 1);
+}
+
+TEST_CASE("RecordLayouts: Test slots holding references", "[RecordLayouts]") {
+    auto a = Analyze(R"(
+      inc(x) { return x + 1; }
+      main() {
+        var r, p, x;
+        p = alloc 5;
+        r = {n: 1, f: inc, p: p, q: {m: 2}, u: null};
+        x = r.w;
+        return r.n;
+      }
+    )");
+    auto layouts = a.analysis->getRecordLayouts();
+    REQUIRE_FALSE(layouts->isWide());
+    REQUIRE(LayoutOf(a, 1) == RecordLayouts::Layout{"n", "f", "p", "q", "u", "w"});
+
+    // Integers and functions are not references, unconstrained fields may be
+    REQUIRE(layouts->getReferences(layouts->getLayout(a.sites[1])) ==
+            std::vector<bool>{false, false, true, true, true, true});
+    REQUIRE(layouts->getReferences(layouts->getLayout(a.sites[0])) == std::vector<bool>{false});
+}
+
+TEST_CASE("RecordLayouts: Test polymorphic uses fall back to the wide layout", "[RecordLayouts]") {
+    auto a = Analyze(R"(
+      id(x) { return x; }
+      main() {
+        var r, s;
+        r = id({a: 1});
+        s = id(2);
+        return s + {b: 3}.b;
+      }
+    )");
+    auto layouts = a.analysis->getRecordLayouts();
+    REQUIRE(layouts->isWide());
+    REQUIRE(layouts->getLayouts().size() == 1);
+    REQUIRE(LayoutOf(a, 0) == RecordLayouts::Layout{"a", "b"});
+    REQUIRE(LayoutOf(a, 1) == LayoutOf(a, 0));
+    REQUIRE(layouts->getReferences(0) == std::vector<bool>{true, true});
+}
+
+TEST_CASE("RecordLayouts: Test programs without records", "[RecordLayouts]") {
+    auto a = Analyze(R"(main() { return 1; })");
+    REQUIRE(a.analysis->getRecordLayouts()->getLayouts().empty());
+}
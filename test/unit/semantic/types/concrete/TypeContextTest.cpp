@@ -0,0 +1,151 @@
+#include "catch.hpp"
+#include "TypeContext.h"
+#include "Substituter.h"
+#include "ASTNumberExpr.h"
+#include "InternalError.h"
+#include <sstream>
+#include <string>
+
+namespace {
+
+// A chain of n nested references over int, built without a context.
+std::shared_ptr<TipType> rawRefChain(int n) {
+    std::shared_ptr<TipType> t = std::make_shared<TipInt>();
+    for (int i = 0; i < n; i++) {
+        t = std::make_shared<TipRef>(t);
+    }
+    return t;
+}
+
+// A function type with n parameters that are all the same deep type.
+std::shared_ptr<TipType> rawWideFunction(int n, int depth) {
+    std::vector<std::shared_ptr<TipType>> params;
+    for (int i = 0; i < n; i++) {
+        params.push_back(rawRefChain(depth));
+    }
+    return std::make_shared<TipFunction>(params, rawRefChain(depth));
+}
+
+}
+
+TEST_CASE("TypeContext: Test structurally equal types are the same node", "[TypeContext]") {
+    TypeContext context;
+    ASTNumberExpr num(13);
+
+    REQUIRE(context.getInt() == context.getInt());
+    REQUIRE(context.getVar(&num) == context.getVar(&num));
+    REQUIRE(context.getAlpha(&num, "f") == context.getAlpha(&num, "f"));
+    REQUIRE(context.getRef(context.getInt()) == context.getRef(context.getInt()));
+
+    // Raw types are interned bottom up
+    auto raw1 = rawRefChain(3);
+    auto raw2 = rawRefChain(3);
+    REQUIRE(raw1 != raw2);
+    REQUIRE(context.intern(raw1) == context.intern(raw2));
+    REQUIRE(context.intern(raw2) == context.getRef(context.getRef(context.getRef(context.getInt()))));
+}
+
+TEST_CASE("TypeContext: Test distinct types are different nodes", "[TypeContext]") {
+    TypeContext context;
+    ASTNumberExpr num(13);
+
+    REQUIRE(context.getVar(&num) != context.getAlpha(&num));
+    REQUIRE(context.getAlpha(&num, "f") != context.getAlpha(&num, "g"));
+    REQUIRE(context.getRef(context.getInt()) != context.getRef(context.getVar(&num)));
+    REQUIRE_FALSE(*context.getVar(&num) == *context.getAlpha(&num));
+}
+
+TEST_CASE("TypeContext: Test subterms are shared", "[TypeContext]") {
+    TypeContext context;
+    auto f = context.intern(rawWideFunction(10, 10));
+
+    // int, the ten refs over it and the function itself
+    REQUIRE(context.size() == 12);
+
+    auto params = std::dynamic_pointer_cast<TipFunction>(f)->getParams();
+    for (auto &p : params) {
+        REQUIRE(p == params.front());
+    }
+}
+
+TEST_CASE("TypeContext: Test interned types are immutable", "[TypeContext]") {
+    TypeContext context;
+    auto ref = context.getRef(context.getInt());
+    std::vector<std::shared_ptr<TipType>> args { context.getRef(context.getInt()) };
+    REQUIRE_THROWS_AS(ref->setArguments(args), InternalError);
+}
+
+TEST_CASE("TypeContext: Test interned and raw types compare equal", "[TypeContext]") {
+    TypeContext context;
+    auto raw = rawWideFunction(2, 2);
+    auto interned = context.intern(rawWideFunction(2, 2));
+    REQUIRE(*raw == *interned);
+    REQUIRE(*interned == *raw);
+    REQUIRE(raw->hash() == interned->hash());
+
+    std::stringstream rawStream, internedStream;
+    rawStream << *raw;
+    internedStream << *interned;
+    REQUIRE(rawStream.str() == internedStream.str());
+}
+
+TEST_CASE("TypeContext: Test types outlive their context", "[TypeContext]") {
+    std::shared_ptr<TipType> survivor;
+    {
+        TypeContext context;
+        survivor = context.intern(rawRefChain(2));
+        REQUIRE(survivor->getContext() == &context);
+    }
+    REQUIRE(survivor->getContext() == nullptr);
+    REQUIRE(*survivor == *rawRefChain(2));
+}
+
+TEST_CASE("TypeContext: Test substitution stays in the context", "[TypeContext]") {
+    TypeContext context;
+    ASTNumberExpr num(13);
+    auto var = context.getVar(&num);
+    auto ref = context.getRef(var);
+
+    auto subst = Substituter::substitute(ref.get(), var.get(), context.getInt());
+    REQUIRE(subst == context.getRef(context.getInt()));
+
+    // Copies of interned types are shared
+    REQUIRE(Copier::copy(ref) == ref);
+}
+
+/*
+ * Before/after comparison of raw and interned types.  Hidden by default,
+ * run it with: typeinference_unit_tests "[benchmark]"
+ */
+TEST_CASE("TypeContext: Benchmark raw and interned types", "[.][TypeContext][benchmark]") {
+    const int width = 64;
+    const int depth = 256;
+
+    // The raw function allocates (width + 1) * (depth + 1) + 1 nodes where
+    // the interned one needs depth + 2.
+    TypeContext context;
+    auto interned = context.intern(rawWideFunction(width, depth));
+    auto internedCopy = context.intern(rawWideFunction(width, depth));
+    REQUIRE(context.size() == depth + 2);
+    WARN("raw nodes: " + std::to_string((width + 1) * (depth + 1) + 1) +
+         ", interned nodes: " + std::to_string(context.size()));
+
+    auto raw = rawWideFunction(width, depth);
+    auto rawCopy = rawWideFunction(width, depth);
+
+    BENCHMARK("build raw") {
+        return rawWideFunction(width, depth);
+    };
+
+    BENCHMARK("build interned") {
+        return context.intern(rawWideFunction(width, depth));
+    };
+
+    BENCHMARK("compare raw") {
+        return *raw == *rawCopy;
+    };
+
+    BENCHMARK("compare interned") {
+        return *interned == *internedCopy;
+    };
+}
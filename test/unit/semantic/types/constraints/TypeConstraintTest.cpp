@@ -4,11 +4,13 @@
 #include "TipInt.h"
 #include "SemanticAnalysis.h"
 #include "ASTHelper.h"
+#include "FrontEnd.h"
 #include <vector>
 #include <sstream>
 #include <queue>
 #include "FunctionGraph.h"
 #include "TypeConstraintCollectVisitor.h"
+#include "SemanticError.h"
 
 TEST_CASE("TypeConstraint: Constraints are compared term-wise", "[TypeConstraint]") {
     std::vector<std::shared_ptr<TipType>> args;
@@ -275,4 +277,160 @@ TEST_CASE("T16: Failure - Flow Polymorphism", "[Failing Tests]") {
 
     auto ast = ASTHelper::build_ast(stream);
     REQUIRE_THROWS(SemanticAnalysis::analyze(ast.get()));
-}
\ No newline at end of file
+}
+namespace {
+
+// Every inferred function and local type, in symbol table order.
+std::string AllTypes(ASTProgram* ast, unsigned jobs) {
+    auto analysis = SemanticAnalysis::analyze(ast, jobs);
+    auto types = analysis->getTypeResults();
+    auto symbols = analysis->getSymbolTable();
+
+    std::stringstream out;
+    for (auto f : symbols->getFunctions()) {
+        out << f->getName() << " : " << *types->getInferredType(f) << "\n";
+        for (auto l : symbols->getLocals(f)) {
+            out << "  " << l->getName() << " : " << *types->getInferredType(l) << "\n";
+        }
+    }
+    return out.str();
+}
+
+std::string ErrorMessage(ASTProgram* ast, unsigned jobs) {
+    try {
+        SemanticAnalysis::analyze(ast, jobs);
+    } catch (SemanticError &e) {
+        return e.what();
+    }
+    return "";
+}
+
+}
+
+TEST_CASE("T17: Parallel - Results do not depend on the number of jobs", "[Parallel]") {
+    std::stringstream stream;
+    stream << R"(
+        id(a) { return a; }
+        deref(p) { return *p; }
+        even(n) { var r; if (n == 0) { r = 1; } else { r = odd(n - 1); } return r; }
+        odd(n) { var r; if (n == 0) { r = 0; } else { r = even(n - 1); } return r; }
+        pair(x, y) { return {fst: x, snd: y}; }
+        g1() { var p; p = alloc 1; return deref(p); }
+        g2() { return id(even(3)); }
+        g3() { var f; f = id; return f(alloc 2); }
+        g4() { var r; r = pair(g1(), g2()); return r.fst; }
+        main() { return g4() + *g3(); }
+    )";
+
+    auto ast = ASTHelper::build_ast(stream);
+    auto serial = AllTypes(ast.get(), 1);
+    REQUIRE(serial.find("even : (int) -> int") != std::string::npos);
+    for (unsigned jobs : {2, 4, 8}) {
+        REQUIRE(AllTypes(ast.get(), jobs) == serial);
+    }
+}
+
+TEST_CASE("T18: Parallel - The serial error is reported", "[Parallel]") {
+    std::stringstream stream;
+    stream << R"(
+        ok(x) { return x + 1; }
+        bad1() { var x; x = alloc 1; return x + 1; }
+        bad2() { var y; y = {f: 1}; return *y; }
+        main() { return ok(2); }
+    )";
+
+    auto ast = ASTHelper::build_ast(stream);
+    auto serial = ErrorMessage(ast.get(), 1);
+    REQUIRE(!serial.empty());
+    for (unsigned jobs : {2, 4, 8}) {
+        REQUIRE(ErrorMessage(ast.get(), jobs) == serial);
+    }
+}
+
+namespace {
+
+/*
+ * A call graph over n functions where every function calls the next two, so
+ * there is a diamond at every step, and every block of ten functions is made
+ * mutually recursive by a call back to the start of the block.
+ */
+std::string DiamondProgram(int n) {
+    std::stringstream program;
+    for (int i = 0; i < n; i++) {
+        program << "f" << i << "(x) { var r; r = x";
+        for (int callee : {i + 1, i + 2}) {
+            if (callee < n) {
+                program << " + f" << callee << "(x)";
+            }
+        }
+        if (i % 10 == 9) {
+            program << " + f" << i - 9 << "(x)";
+        }
+        program << "; return r; }\n";
+    }
+    return program.str();
+}
+
+}
+
+TEST_CASE("T19: FlowAnalysis - Shared callees are not revisited", "[FlowAnalysis]") {
+    std::stringstream stream;
+    stream << DiamondProgram(200);
+
+    auto ast = ASTHelper::build_ast(stream);
+    FunctionGraphCreator analyzer{ ast.get() };
+
+    for (auto f : ast->getFunctions()) {
+        REQUIRE(analyzer.isFunctionRecursive(f));
+    }
+
+    auto queue{ analyzer.InverseTopoSort() };
+    REQUIRE(queue.size() == 20);
+    while (!queue.empty()) {
+        REQUIRE(queue.front()->GetFuncs().size() == 10);
+        queue.pop();
+    }
+}
+
+TEST_CASE("T20: FlowAnalysis - Functions are found by name", "[FlowAnalysis]") {
+    std::stringstream stream;
+    stream << R"(a() { return 0; } b() { return a(); })";
+
+    auto ast = ASTHelper::build_ast(stream);
+    REQUIRE(ast->findFunctionByName("a") == ast->getFunctions()[0]);
+    REQUIRE(ast->findFunctionByName("b") == ast->getFunctions()[1]);
+    REQUIRE(ast->findFunctionByName("c") == nullptr);
+}
+
+TEST_CASE("T21: FlowAnalysis - Functions of several files are in file order", "[FlowAnalysis]") {
+    // Both functions are at line 1, column 0 of their file
+    auto ast = FrontEnd::parse({{"a.tip", "g(x) { return f(x); }"},
+                                {"b.tip", "f(x) { return g(x); }"}});
+    FunctionGraphCreator analyzer{ ast.get() };
+
+    auto queue{ analyzer.InverseTopoSort() };
+    REQUIRE(queue.size() == 1);
+    auto funcs{ queue.front()->GetFuncsInSourceOrder() };
+    REQUIRE(funcs.size() == 2);
+    REQUIRE(funcs[0]->getName() == "g");
+    REQUIRE(funcs[1]->getName() == "f");
+    REQUIRE(queue.front()->GetSourceIndex() == 0);
+}
+
+/*
+ * Call graph construction on large synthetic programs.  Hidden by default,
+ * run it with: typeinference_unit_tests "[benchmark]"
+ */
+TEST_CASE("FunctionGraph: Benchmark large call graphs", "[.][FlowAnalysis][benchmark]") {
+    for (int n : {10000, 100000}) {
+        std::stringstream stream;
+        stream << DiamondProgram(n);
+        auto ast = ASTHelper::build_ast(stream);
+
+        REQUIRE(FunctionGraphCreator(ast.get()).InverseTopoSort().size() == n / 10);
+
+        BENCHMARK("build graph of " + std::to_string(n) + " functions") {
+            return FunctionGraphCreator(ast.get()).InverseTopoSort().size();
+        };
+    }
+}
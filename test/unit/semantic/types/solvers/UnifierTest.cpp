@@ -351,7 +351,8 @@ TEST_CASE("Unifier: Test unifying TipCons with the same arity", "[Unifier]") {
 }
 
 TEST_CASE("Unifier: Test unifying proper types with a type variable", "[Unifier]") {
-    ASTVariableExpr variableExpr("foo");
+    ASTArena arena;
+    ASTVariableExpr variableExpr(arena.intern("foo"));
     auto tipVar = std::make_shared<TipVar>(&variableExpr);
     auto tipInt = std::make_shared<TipInt>();
 
@@ -363,10 +364,11 @@ TEST_CASE("Unifier: Test unifying proper types with a type variable", "[Unifier]
 }
 
 TEST_CASE("Unifier: Test unifying two different type variables", "[Unifier]") {
-    ASTVariableExpr variableExprA("foo");
+    ASTArena arena;
+    ASTVariableExpr variableExprA(arena.intern("foo"));
     auto tipVarA = std::make_shared<TipVar>(&variableExprA);
 
-    ASTVariableExpr variableExprB("foo");
+    ASTVariableExpr variableExprB(arena.intern("foo"));
     auto tipVarB = std::make_shared<TipVar>(&variableExprB);
 
     TypeConstraint constraint(tipVarA, tipVarB);
@@ -377,17 +379,18 @@ TEST_CASE("Unifier: Test unifying two different type variables", "[Unifier]") {
 }
 
 TEST_CASE("Unifier: Test closing mu ", "[Unifier]") {
+    ASTArena arena;
     // Some building block types for setting up test
-    ASTVariableExpr variableExprG("g");
+    ASTVariableExpr variableExprG(arena.intern("g"));
     auto theAlphaG = std::make_shared<TipAlpha>(&variableExprG);
 
     auto theInt = std::make_shared<TipInt>();
 
-    ASTVariableExpr variableExprFoo("foo");
+    ASTVariableExpr variableExprFoo(arena.intern("foo"));
     auto theVarFoo = std::make_shared<TipVar>(&variableExprFoo);
 
     // mu alpha<f> . (alpha<f>, alpha<g>) -> alpha<g>
-    ASTVariableExpr variableExprF("f");
+    ASTVariableExpr variableExprF(arena.intern("f"));
     auto theAlphaF = std::make_shared<TipAlpha>(&variableExprF);
 
     std::vector<std::shared_ptr<TipType>> params {theAlphaF, theAlphaG};
@@ -1,4 +1,5 @@
 #include "catch.hpp"
+#include "ASTArena.h"
 #include "ASTNumberExpr.h"
 #include "TipVar.h"
 #include "UnionFind.h"
@@ -7,30 +8,24 @@
 #include <vector>
 #include <iostream>
 #include <sstream>
+#include <string>
 
-static std::vector<std::shared_ptr<TipType>> intsToTipVars(std::vector<int> &values) {
+static std::vector<std::shared_ptr<TipType>> intsToTipVars(ASTArena &arena, std::vector<int> &values) {
     std::vector<std::shared_ptr<TipType>> pointers;
     for(auto &value : values) {
-        ASTNumberExpr * n = new ASTNumberExpr(value);
+        ASTNumberExpr * n = arena.make<ASTNumberExpr>(value);
         pointers.emplace_back(std::make_shared<TipVar>(n));
     }
     return pointers;
 }
 
-static void cleanup(std::vector<std::shared_ptr<TipType>> &values) {
-    for(auto &value : values) {
-        auto tipVar = std::dynamic_pointer_cast<TipVar>(value);
-        delete tipVar->getNode();
-    }
-}
-
 TEST_CASE("UnionFind: Test Constructor", "[UnionFind]") {
     std::vector<int> ints {3, 4, 5, 6, 7, 8, 9};
-    auto tipVars = std::move(intsToTipVars(ints));
+    ASTArena arena;
+    auto tipVars = std::move(intsToTipVars(arena, ints));
     UnionFind unionFind(tipVars);
     REQUIRE(true);
 
-    cleanup(tipVars);
 }
 
 TEST_CASE("UnionFind: Test inserting nullptrs", "[UnionFind]") {
@@ -40,7 +35,8 @@ TEST_CASE("UnionFind: Test inserting nullptrs", "[UnionFind]") {
 
 TEST_CASE("UnionFind: Test find", "[UnionFind]") {
     std::vector<int> ints {3, 4, 5, 6, 7, 8, 9};
-    auto tipVars = std::move(intsToTipVars(ints));
+    ASTArena arena;
+    auto tipVars = std::move(intsToTipVars(arena, ints));
 
     auto three = tipVars.at(0);
     auto four = tipVars.at(1);
@@ -62,12 +58,12 @@ TEST_CASE("UnionFind: Test find", "[UnionFind]") {
 
     REQUIRE(8 == actualIntOfRootOfFour);
     REQUIRE(8 == actualIntOfRootOfNine);
-    cleanup(tipVars);
 }
 
 TEST_CASE("UnionFind: Test connected", "[UnionFind]") {
     std::vector<int> ints {3, 4, 5, 6, 7, 8, 9};
-    auto tipVars = std::move(intsToTipVars(ints));
+    ASTArena arena;
+    auto tipVars = std::move(intsToTipVars(arena, ints));
 
     auto three = tipVars.at(0);
     auto four = tipVars.at(1);
@@ -84,5 +80,127 @@ TEST_CASE("UnionFind: Test connected", "[UnionFind]") {
 
     REQUIRE(unionFind.connected(three, nine));
     REQUIRE_FALSE(unionFind.connected(five, six));
-    cleanup(tipVars);
+}
+
+TEST_CASE("UnionFind: Test structurally equal terms share a class", "[UnionFind]") {
+    std::vector<int> ints {3, 4};
+    ASTArena arena;
+    auto tipVars = std::move(intsToTipVars(arena, ints));
+    auto three = tipVars.at(0);
+    auto four = tipVars.at(1);
+
+    UnionFind unionFind(tipVars);
+    unionFind.quick_union(three, four);
+
+    // A distinct object for the same node is the same term
+    auto threeAgain = std::make_shared<TipVar>(std::dynamic_pointer_cast<TipVar>(three)->getNode());
+    REQUIRE(unionFind.connected(threeAgain, four));
+    REQUIRE(unionFind.size() == 2);
+
+    // A representative is returned as is, others map to the representative
+    REQUIRE(unionFind.find(four) == four);
+    REQUIRE(unionFind.find(threeAgain) == four);
+}
+
+TEST_CASE("UnionFind: Test representative is independent of rank", "[UnionFind]") {
+    std::vector<int> ints {1, 2, 3, 4, 5};
+    ASTArena arena;
+    auto tipVars = std::move(intsToTipVars(arena, ints));
+
+    UnionFind unionFind(tipVars);
+    // Build a class of rank one and then union it into a singleton
+    unionFind.quick_union(tipVars.at(0), tipVars.at(1));
+    unionFind.quick_union(tipVars.at(2), tipVars.at(3));
+    unionFind.quick_union(tipVars.at(1), tipVars.at(3));
+    unionFind.quick_union(tipVars.at(0), tipVars.at(4));
+
+    for(auto &v : tipVars) {
+        REQUIRE(unionFind.find(v) == tipVars.at(4));
+    }
+}
+
+TEST_CASE("UnionFind: Test long chains", "[UnionFind]") {
+    std::vector<int> ints;
+    for(int i = 0; i < 10000; i++) {
+        ints.push_back(i);
+    }
+    ASTArena arena;
+    auto tipVars = std::move(intsToTipVars(arena, ints));
+
+    UnionFind unionFind(tipVars);
+    for(int i = 0; i + 1 < tipVars.size(); i++) {
+        unionFind.quick_union(tipVars.at(i), tipVars.at(i + 1));
+    }
+
+    REQUIRE(unionFind.find(tipVars.front()) == tipVars.back());
+    REQUIRE(unionFind.connected(tipVars.front(), tipVars.at(5000)));
+}
+
+TEST_CASE("UnionFind: Test rollback", "[UnionFind]") {
+    std::vector<int> ints {3, 4, 5, 6, 7};
+    ASTArena arena;
+    auto tipVars = std::move(intsToTipVars(arena, ints));
+    auto three = tipVars.at(0);
+    auto four = tipVars.at(1);
+    auto five = tipVars.at(2);
+    auto six = tipVars.at(3);
+    auto seven = tipVars.at(4);
+
+    UnionFind unionFind({three, four, five, six});
+    unionFind.quick_union(three, four);
+
+    unionFind.mark();
+    unionFind.quick_union(four, five);
+    unionFind.quick_union(six, three);
+    unionFind.find(seven);
+    REQUIRE(unionFind.connected(three, six));
+    REQUIRE(unionFind.size() == 5);
+
+    SECTION("Rollback restores the classes and terms") {
+        unionFind.rollback();
+        REQUIRE(unionFind.size() == 4);
+        REQUIRE(unionFind.connected(three, four));
+        REQUIRE_FALSE(unionFind.connected(three, five));
+        REQUIRE_FALSE(unionFind.connected(three, six));
+        REQUIRE(unionFind.find(three) == four);
+        REQUIRE(unionFind.find(six) == six);
+    }
+
+    SECTION("Marks nest") {
+        unionFind.mark();
+        unionFind.quick_union(seven, three);
+        REQUIRE(unionFind.connected(seven, five));
+        unionFind.rollback();
+        REQUIRE_FALSE(unionFind.connected(seven, five));
+        REQUIRE(unionFind.connected(three, six));
+        unionFind.rollback();
+        REQUIRE_FALSE(unionFind.connected(three, six));
+    }
+}
+
+/*
+ * Scaling benchmark for unions and finds over n type variables.  Hidden by
+ * default, run it with: typeinference_unit_tests "[benchmark]"
+ */
+TEST_CASE("UnionFind: Benchmark scaling", "[.][UnionFind][benchmark]") {
+    for(int n : {1000, 10000, 100000}) {
+        std::vector<int> ints;
+        for(int i = 0; i < n; i++) {
+            ints.push_back(i);
+        }
+        ASTArena arena;
+        auto tipVars = std::move(intsToTipVars(arena, ints));
+
+        BENCHMARK("union and find n=" + std::to_string(n)) {
+            UnionFind unionFind(tipVars);
+            for(int i = 0; i + 1 < n; i++) {
+                unionFind.quick_union(tipVars.at(i), tipVars.at((i * 7 + 1) % n));
+            }
+            int connected = 0;
+            for(int i = 0; i < n; i++) {
+                connected += unionFind.connected(tipVars.at(i), tipVars.at(0));
+            }
+            return connected;
+        };
+    }
 }
@@ -0,0 +1,68 @@
+#include "catch.hpp"
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <stdexcept>
+
+TEST_CASE("WorkStealingPool: Test all tasks run", "[WorkStealingPool]") {
+    std::atomic<int> count{0};
+    WorkStealingPool pool(4);
+    for (int i = 0; i < 1000; i++) {
+        pool.submit([&count] { count++; });
+    }
+    pool.wait();
+    REQUIRE(count == 1000);
+}
+
+TEST_CASE("WorkStealingPool: Test tasks submitted by tasks run", "[WorkStealingPool]") {
+    std::atomic<int> count{0};
+    WorkStealingPool pool(4);
+
+    // A binary tree of tasks with 2^10 leaves
+    std::function<void(int)> spawn = [&](int depth) {
+        if (depth == 0) {
+            count++;
+            return;
+        }
+        pool.submit([&spawn, depth] { spawn(depth - 1); });
+        pool.submit([&spawn, depth] { spawn(depth - 1); });
+    };
+    pool.submit([&spawn] { spawn(10); });
+    pool.wait();
+    REQUIRE(count == 1024);
+}
+
+TEST_CASE("WorkStealingPool: Test wait covers tasks still submitting", "[WorkStealingPool]") {
+    // Each task submits its children and keeps running, so idle workers
+    // steal and finish children while their parents are still submitting
+    for (int round = 0; round < 500; round++) {
+        std::atomic<int> count{0};
+        WorkStealingPool pool(8);
+        std::function<void(int)> chain = [&](int depth) {
+            for (int i = 0; i < depth; i++) {
+                pool.submit([&chain, depth] { chain(depth - 1); });
+            }
+            count++;
+        };
+        for (int i = 0; i < 4; i++) {
+            pool.submit([&chain] { chain(4); });
+        }
+        pool.wait();
+        REQUIRE(count == 4 * 65);
+    }
+}
+
+TEST_CASE("WorkStealingPool: Test exceptions are rethrown by wait", "[WorkStealingPool]") {
+    std::atomic<int> count{0};
+    WorkStealingPool pool(2);
+    pool.submit([] { throw std::runtime_error("task failed"); });
+    for (int i = 0; i < 10; i++) {
+        pool.submit([&count] { count++; });
+    }
+    REQUIRE_THROWS_AS(pool.wait(), std::runtime_error);
+    REQUIRE(count == 10);
+
+    // The pool is still usable afterwards
+    pool.submit([&count] { count++; });
+    REQUIRE_NOTHROW(pool.wait());
+    REQUIRE(count == 11);
+}